@@ -246,6 +246,8 @@ namespace hdt
 		// @brief Min percent of screen height a non-player skeleton must occupy to stay active; 0 = disabled. [0,100]
 		float m_minScreenSizePercent = 0.f;
 
+		const RE::NiPoint3& getCameraPosition() const { return m_cameraPositionDuringFrame; }
+
 	private:
 		RE::NiPoint3 m_cameraPositionDuringFrame;
 		float m_screenSizeThresholdScale = 0.f;  // precomputed per frame: (minScreenSizePercent/100)^2 * tan(fov/2)^2
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "hdtFileUtils.h"  // readAllFile2
+
 namespace hdt
 {
 
@@ -96,22 +98,6 @@ namespace hdt
 		return file;
 	}
 
-	static inline std::string readAllFile2(const char* path)
-	{
-		std::ifstream stream(path, std::ios::binary);
-		if (!stream.is_open()) {
-			return "";
-		}
-
-		stream.seekg(0, std::ios::end);
-		auto size = stream.tellg();
-		stream.seekg(0, std::ios::beg);
-		std::string ret;
-		ret.resize(size);
-		stream.read(&ret[0], size);
-		return ret;
-	}
-
 	static inline void updateTransformUpDown(RE::NiAVObject* obj, bool dirty)
 	{
 		if (!obj) {
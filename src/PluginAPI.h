@@ -39,8 +39,152 @@ namespace hdt
 		float timeStep{ 0.0f };
 	};
 
+	//Since 2.2.0. Sent right after PostStepEvent with the bone-to-bone contacts of the step.
+	//Contacts are merged over the substeps of the step, impulse being the sum of the normal impulses applied by the solver.
+	//A contact is reported as Begin on the first step its bones touch, Persist while they keep touching,
+	//and End once on the first step they don't touch anymore.
+	//The array, the names and the objects are only valid during the event; a contact is identified after it by the
+	//reference, the system handle and the bone names. Objects must be treated as read-only.
+	struct ContactEvent
+	{
+		enum class Phase : unsigned char
+		{
+			Begin,
+			Persist,
+			End,
+		};
+
+		struct Contact
+		{
+			unsigned int actorA;  //form IDs of the references the physics systems belong to, 0 for external colliders
+			unsigned int actorB;
+			unsigned int systemA;  //handles of the physics systems, unique while they are loaded, 0 for external colliders
+			unsigned int systemB;
+			const char* physicsFileA;  //physics XML paths of the systems, nullptr for external colliders
+			const char* physicsFileB;
+			const btCollisionObject* bodyA;  //the colliding skinned meshes
+			const btCollisionObject* bodyB;
+			const btCollisionObject* boneA;  //the rigid bodies of the colliding bones
+			const btCollisionObject* boneB;
+			const char* boneNameA;
+			const char* boneNameB;
+			float position[3];  //world position of the contact on B
+			float normal[3];    //contact normal on B
+			float impulse;
+			Phase phase;
+		};
+
+		const Contact* contacts{ nullptr };
+		unsigned int count{ 0 };
+		float timeStep{ 0.0f };
+	};
+
+	//A local wind source, added on top of the weather wind for as long as it is registered.
+	//Positions and directions are in Skyrim world coordinates.
+	//A sphere blows radially from its position, or along its direction when that is not zero.
+	//A cone blows from its position along its direction, within coneAngle (half angle, radians).
+	struct WindEmitterDesc
+	{
+		enum class Shape : unsigned char
+		{
+			Sphere,
+			Cone,
+		};
+
+		Shape shape{ Shape::Sphere };
+		float position[3]{ 0.0f, 0.0f, 0.0f };
+		float direction[3]{ 0.0f, 0.0f, 0.0f };
+		float radius{ 512.0f };
+		float coneAngle{ 0.5f };
+		float strength{ 0.0f };    //wind speed at the emitter, in the same unit as the weather wind
+		float falloff{ 1.0f };     //exponent applied to (1 - distance / radius)
+		float turbulence{ 0.0f };  //[0, 1]
+		float lifetime{ -1.0f };   //seconds before the emitter removes itself; negative to keep it until removed
+	};
+
+	//Since 2.3.0. A kinematic primitive that collides with SMP bodies without being part of an armor, e.g. a weapon or a chair.
+	//Positions are in Skyrim world coordinates, the local shape is centered on the transform.
+	//Tags are comma separated, and follow the same rules as the tag, can-collide-with-tag and no-collide-with-tag of SMP XML.
+	struct ExternalColliderDesc
+	{
+		enum class Shape : unsigned char
+		{
+			Sphere,
+			Capsule,     //along the local z axis
+			Box,
+			ConvexHull,  //at most 64 points
+		};
+
+		const char* name{ nullptr };  //reported as the bone name in contact events
+		Shape shape{ Shape::Sphere };
+		float radius{ 10.0f };                           //sphere and capsule
+		float halfHeight{ 0.0f };                        //capsule, from the center to the center of a cap
+		float halfExtents[3]{ 10.0f, 10.0f, 10.0f };     //box
+		const float* points{ nullptr };                  //convex hull, pointCount xyz triplets in local space
+		unsigned int pointCount{ 0 };
+		float margin{ 1.0f };                            //thickness added to the faces of boxes and hulls
+		float position[3]{ 0.0f, 0.0f, 0.0f };
+		float rotation[4]{ 0.0f, 0.0f, 0.0f, 1.0f };     //quaternion, xyzw
+		const char* tags{ nullptr };
+		const char* canCollideWithTags{ nullptr };
+		const char* noCollideWithTags{ nullptr };
+	};
+
+	//Since 2.4.0. Bulk access to the simulated bones, in structure-of-arrays buffers provided by the caller.
+	//A system handle stays the same for as long as the system stays in the world, 0 is never a valid handle.
+	//Queries read the simulation as is, so they are only meaningful from a PostStep or Contact listener.
+	//Stale handles are skipped and reported as invalid.
+	struct BoneHandle
+	{
+		unsigned int system;
+		unsigned int bone;  //index in the bones of the system
+	};
+
+	struct SystemInfo
+	{
+		unsigned int handle;
+		RE::NiNode* skeleton;
+		unsigned int boneCount;
+	};
+
+	//Any pointer may be null to skip that value. Transforms are the bone node world transforms, in Skyrim coordinates.
+	struct BoneStateBuffers
+	{
+		enum Flags : unsigned char
+		{
+			kValid = 1 << 0,
+			kKinematic = 1 << 1,
+		};
+
+		float* position[3]{};
+		float* rotation[4]{};  //quaternion, xyzw
+		float* linearVelocity[3]{};
+		float* angularVelocity[3]{};
+		unsigned char* flags{ nullptr };
+	};
+
+	struct SystemStatsBuffers
+	{
+		unsigned int* boneCount{ nullptr };
+		unsigned int* dynamicBoneCount{ nullptr };
+		unsigned int* bodyCount{ nullptr };
+		unsigned int* colliderCount{ nullptr };
+		unsigned int* constraintCount{ nullptr };
+		float* maxLinearSpeed{ nullptr };
+		float* averageLinearSpeed{ nullptr };  //of the dynamic bones
+		unsigned char* valid{ nullptr };
+	};
+
+	//Either array may be null. Forces are applied at the center of mass of dynamic bones during the next step.
+	struct BoneForceBuffers
+	{
+		const float* force[3]{};
+		const float* torque[3]{};
+	};
+
 	using IPreStepListener = RE::BSTEventSink<PreStepEvent>;
 	using IPostStepListener = RE::BSTEventSink<PostStepEvent>;
+	using IContactListener = RE::BSTEventSink<ContactEvent>;
 
 	class PluginInterface
 	{
@@ -64,7 +208,7 @@ namespace hdt
 		};
 
 	public:
-		constexpr static Version INTERFACE_VERSION{ 2, 0, 0 };
+		constexpr static Version INTERFACE_VERSION{ 2, 4, 0 };
 		constexpr static Version BULLET_VERSION{ 3, 24, 0 };
 
 	public:
@@ -77,5 +221,31 @@ namespace hdt
 
 		virtual void addListener(IPostStepListener*) = 0;
 		virtual void removeListener(IPostStepListener*) = 0;
+
+		//Since 2.1.0. Returns an id to update or remove the emitter, or 0 on failure.
+		virtual unsigned int addWindEmitter(const WindEmitterDesc& emitter) = 0;
+		virtual bool updateWindEmitter(unsigned int id, const WindEmitterDesc& emitter) = 0;
+		virtual bool removeWindEmitter(unsigned int id) = 0;
+
+		//Since 2.2.0. Not overloads of addListener, so that the existing vtable layout is kept.
+		//Contacts are only gathered while at least one listener is registered.
+		virtual void addContactListener(IContactListener*) = 0;
+		virtual void removeContactListener(IContactListener*) = 0;
+
+		//Since 2.3.0. Returns an id to move or remove the collider, or 0 on failure.
+		//Adding and removing wait for the current step, they must not be called from a step event.
+		//The collider moves smoothly to each new transform during the next step, unless teleport is set.
+		virtual unsigned int addExternalCollider(const ExternalColliderDesc& collider) = 0;
+		virtual bool setExternalColliderTransform(unsigned int id, const float position[3], const float rotation[4], bool teleport) = 0;
+		virtual bool removeExternalCollider(unsigned int id) = 0;
+
+		//Since 2.4.0. The getters return the total count, and fill at most capacity entries.
+		virtual unsigned int getSystems(SystemInfo* systems, unsigned int capacity) = 0;
+		virtual unsigned int getSystemBones(unsigned int system, BoneHandle* bones, const char** names, unsigned int capacity) = 0;
+		//Return the number of valid handles.
+		virtual unsigned int queryBoneStates(const BoneHandle* bones, unsigned int count, const BoneStateBuffers& states) = 0;
+		virtual unsigned int querySystemStats(const unsigned int* systems, unsigned int count, const SystemStatsBuffers& stats) = 0;
+		//Can be called from any thread.
+		virtual void applyBoneForces(const BoneHandle* bones, unsigned int count, const BoneForceBuffers& forces) = 0;
 	};
 }
@@ -1,4 +1,9 @@
 #include "PluginInterfaceImpl.h"
+#include "hdtSkyrimPhysicsWorld.h"
+
+#include <cctype>
+#include <numbers>
+#include <string_view>
 
 hdt::PluginInterfaceImpl hdt::g_pluginInterface;
 
@@ -30,6 +35,265 @@ void hdt::PluginInterfaceImpl::removeListener(IPostStepListener* l)
 	}
 }
 
+void hdt::PluginInterfaceImpl::addContactListener(IContactListener* l)
+{
+	if (l) {
+		m_contactDispatcher.AddEventSink(l);
+		++m_contactListenerCount;
+	}
+}
+
+void hdt::PluginInterfaceImpl::removeContactListener(IContactListener* l)
+{
+	if (l) {
+		m_contactDispatcher.RemoveEventSink(l);
+		if (m_contactListenerCount > 0)
+			--m_contactListenerCount;
+	}
+}
+
+static hdt::WindEmitter toWindEmitter(const hdt::WindEmitterDesc& desc)
+{
+	hdt::WindEmitter ret;
+	ret.m_shape = desc.shape == hdt::WindEmitterDesc::Shape::Cone ? hdt::WindEmitter::Shape::Cone : hdt::WindEmitter::Shape::Sphere;
+	ret.m_position.setValue(desc.position[0], desc.position[1], desc.position[2]);
+	ret.m_direction.setValue(desc.direction[0], desc.direction[1], desc.direction[2]);
+	ret.m_radius = std::max(desc.radius, 0.0f);
+	ret.m_coneAngle = std::clamp(desc.coneAngle, 0.0f, std::numbers::pi_v<float>);
+	ret.m_strength = desc.strength;
+	ret.m_falloff = std::max(desc.falloff, 0.0f);
+	ret.m_turbulence = std::clamp(desc.turbulence, 0.0f, 1.0f);
+	ret.m_lifetime = desc.lifetime;
+	return ret;
+}
+
+unsigned int hdt::PluginInterfaceImpl::addWindEmitter(const WindEmitterDesc& emitter)
+{
+	return SkyrimPhysicsWorld::get()->getWindField().addEmitter(toWindEmitter(emitter));
+}
+
+bool hdt::PluginInterfaceImpl::updateWindEmitter(unsigned int id, const WindEmitterDesc& emitter)
+{
+	return SkyrimPhysicsWorld::get()->getWindField().updateEmitter(id, toWindEmitter(emitter));
+}
+
+bool hdt::PluginInterfaceImpl::removeWindEmitter(unsigned int id)
+{
+	return SkyrimPhysicsWorld::get()->getWindField().removeEmitter(id);
+}
+
+static btTransform toTransform(const float position[3], const float rotation[4])
+{
+	btQuaternion q(rotation[0], rotation[1], rotation[2], rotation[3]);
+	if (q.length2() < SIMD_EPSILON)
+		q = btQuaternion::getIdentity();
+	return btTransform(q.normalized(), btVector3(position[0], position[1], position[2]));
+}
+
+template <class Inserter>
+static void splitTags(const char* tags, Inserter insert)
+{
+	if (!tags)
+		return;
+
+	std::string_view rest(tags);
+	while (!rest.empty()) {
+		auto comma = rest.find(',');
+		auto tag = rest.substr(0, comma);
+		while (!tag.empty() && std::isspace(static_cast<unsigned char>(tag.front())))
+			tag.remove_prefix(1);
+		while (!tag.empty() && std::isspace(static_cast<unsigned char>(tag.back())))
+			tag.remove_suffix(1);
+		if (!tag.empty())
+			insert(RE::BSFixedString(std::string(tag)));
+		if (comma == std::string_view::npos)
+			break;
+		rest.remove_prefix(comma + 1);
+	}
+}
+
+static hdt::ExternalColliderInfo toExternalColliderInfo(const hdt::ExternalColliderDesc& desc)
+{
+	using Shape = hdt::ExternalColliderInfo::Shape;
+
+	hdt::ExternalColliderInfo ret;
+	ret.m_name = desc.name ? desc.name : "ExternalCollider";
+	switch (desc.shape) {
+	case hdt::ExternalColliderDesc::Shape::Capsule:
+		ret.m_shape = Shape::Capsule;
+		break;
+	case hdt::ExternalColliderDesc::Shape::Box:
+		ret.m_shape = Shape::Box;
+		break;
+	case hdt::ExternalColliderDesc::Shape::ConvexHull:
+		ret.m_shape = Shape::ConvexHull;
+		break;
+	default:
+		ret.m_shape = Shape::Sphere;
+		break;
+	}
+	ret.m_radius = desc.radius;
+	ret.m_halfHeight = desc.halfHeight;
+	ret.m_halfExtents.setValue(std::abs(desc.halfExtents[0]), std::abs(desc.halfExtents[1]), std::abs(desc.halfExtents[2]));
+	if (desc.points)
+		for (unsigned int i = 0; i < desc.pointCount; ++i)
+			ret.m_points.emplace_back(desc.points[i * 3], desc.points[i * 3 + 1], desc.points[i * 3 + 2]);
+	ret.m_margin = std::max(desc.margin, 0.0f);
+	ret.m_transform = toTransform(desc.position, desc.rotation);
+	splitTags(desc.tags, [&](RE::BSFixedString&& tag) { ret.m_tags.push_back(std::move(tag)); });
+	splitTags(desc.canCollideWithTags, [&](RE::BSFixedString&& tag) { ret.m_canCollideWithTags.insert(std::move(tag)); });
+	splitTags(desc.noCollideWithTags, [&](RE::BSFixedString&& tag) { ret.m_noCollideWithTags.insert(std::move(tag)); });
+	return ret;
+}
+
+unsigned int hdt::PluginInterfaceImpl::addExternalCollider(const ExternalColliderDesc& collider)
+{
+	return SkyrimPhysicsWorld::get()->addExternalCollider(toExternalColliderInfo(collider));
+}
+
+bool hdt::PluginInterfaceImpl::setExternalColliderTransform(unsigned int id, const float position[3], const float rotation[4], bool teleport)
+{
+	if (!position || !rotation)
+		return false;
+	return SkyrimPhysicsWorld::get()->setExternalColliderTransform(id, toTransform(position, rotation), teleport);
+}
+
+bool hdt::PluginInterfaceImpl::removeExternalCollider(unsigned int id)
+{
+	return SkyrimPhysicsWorld::get()->removeExternalCollider(id);
+}
+
+unsigned int hdt::PluginInterfaceImpl::getSystems(SystemInfo* systems, unsigned int capacity)
+{
+	auto& list = SkyrimPhysicsWorld::get()->getSystems();
+	const auto n = std::min(static_cast<unsigned int>(list.size()), systems ? capacity : 0);
+	for (unsigned int i = 0; i < n; ++i) {
+		auto system = static_cast<SkyrimSystem*>(list[i].get());
+		systems[i].handle = system->m_handle;
+		systems[i].skeleton = system->m_skeleton.get();
+		systems[i].boneCount = static_cast<unsigned int>(system->getBones().size());
+	}
+	return static_cast<unsigned int>(list.size());
+}
+
+unsigned int hdt::PluginInterfaceImpl::getSystemBones(unsigned int system, BoneHandle* bones, const char** names, unsigned int capacity)
+{
+	auto found = SkyrimPhysicsWorld::get()->findSystem(system);
+	if (!found)
+		return 0;
+
+	auto& list = found->getBones();
+	const auto n = std::min(static_cast<unsigned int>(list.size()), capacity);
+	for (unsigned int i = 0; i < n; ++i) {
+		if (bones)
+			bones[i] = { system, i };
+		if (names)
+			names[i] = list[i]->m_name.c_str();
+	}
+	return static_cast<unsigned int>(list.size());
+}
+
+template <size_t N>
+static void storeSoA(float* const (&buffers)[N], unsigned int i, const float* values)
+{
+	for (size_t k = 0; k < N; ++k)
+		if (buffers[k])
+			buffers[k][i] = values[k];
+}
+
+unsigned int hdt::PluginInterfaceImpl::queryBoneStates(const BoneHandle* bones, unsigned int count, const BoneStateBuffers& states)
+{
+	if (!bones)
+		return 0;
+
+	auto world = SkyrimPhysicsWorld::get();
+	unsigned int valid = 0;
+
+	// Consecutive handles usually belong to the same system, don't look it up again.
+	SkinnedMeshSystem* system = nullptr;
+	unsigned int systemHandle = 0;
+
+	for (unsigned int i = 0; i < count; ++i) {
+		if (bones[i].system != systemHandle || !system) {
+			systemHandle = bones[i].system;
+			system = world->findSystem(systemHandle);
+		}
+
+		if (!system || bones[i].bone >= system->getBones().size()) {
+			if (states.flags)
+				states.flags[i] = 0;
+			continue;
+		}
+
+		auto& rig = system->getBones()[bones[i].bone]->m_rig;
+		const auto transform = rig.getWorldTransform() * system->getBones()[bones[i].bone]->m_rigToLocal;
+		const auto q = transform.getRotation();
+		const float rotation[4]{ q.x(), q.y(), q.z(), q.w() };
+
+		storeSoA(states.position, i, transform.getOrigin().m_floats);
+		storeSoA(states.rotation, i, rotation);
+		storeSoA(states.linearVelocity, i, rig.getLinearVelocity().m_floats);
+		storeSoA(states.angularVelocity, i, rig.getAngularVelocity().m_floats);
+		if (states.flags)
+			states.flags[i] = BoneStateBuffers::kValid | (rig.isStaticOrKinematicObject() ? BoneStateBuffers::kKinematic : 0);
+		++valid;
+	}
+	return valid;
+}
+
+unsigned int hdt::PluginInterfaceImpl::querySystemStats(const unsigned int* systems, unsigned int count, const SystemStatsBuffers& stats)
+{
+	if (!systems)
+		return 0;
+
+	auto world = SkyrimPhysicsWorld::get();
+	unsigned int valid = 0;
+	for (unsigned int i = 0; i < count; ++i) {
+		auto system = world->findSystem(systems[i]);
+		const auto s = system ? system->stats() : SkinnedMeshSystem::Stats();
+
+		if (stats.boneCount)
+			stats.boneCount[i] = s.bones;
+		if (stats.dynamicBoneCount)
+			stats.dynamicBoneCount[i] = s.dynamicBones;
+		if (stats.bodyCount)
+			stats.bodyCount[i] = s.bodies;
+		if (stats.colliderCount)
+			stats.colliderCount[i] = s.colliders;
+		if (stats.constraintCount)
+			stats.constraintCount[i] = s.constraints;
+		if (stats.maxLinearSpeed)
+			stats.maxLinearSpeed[i] = s.maxLinearSpeed;
+		if (stats.averageLinearSpeed)
+			stats.averageLinearSpeed[i] = s.averageLinearSpeed;
+		if (stats.valid)
+			stats.valid[i] = system != nullptr;
+
+		valid += system != nullptr;
+	}
+	return valid;
+}
+
+void hdt::PluginInterfaceImpl::applyBoneForces(const BoneHandle* bones, unsigned int count, const BoneForceBuffers& forces)
+{
+	if (!bones || !count)
+		return;
+
+	auto load = [](const float* const (&buffers)[3], unsigned int i) {
+		return btVector3(
+			buffers[0] ? buffers[0][i] : 0.0f,
+			buffers[1] ? buffers[1][i] : 0.0f,
+			buffers[2] ? buffers[2][i] : 0.0f);
+	};
+
+	std::vector<SkyrimPhysicsWorld::BoneForce> queued;
+	queued.reserve(count);
+	for (unsigned int i = 0; i < count; ++i)
+		queued.push_back({ bones[i].system, bones[i].bone, load(forces.force, i), load(forces.torque, i) });
+
+	SkyrimPhysicsWorld::get()->queueBoneForces(queued.data(), queued.size());
+}
+
 void hdt::PluginInterfaceImpl::onPostPostLoad()
 {
 	// Send ourselves to any plugin that registered during the PostLoad event
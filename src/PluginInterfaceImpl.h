@@ -21,10 +21,30 @@ namespace hdt
 		virtual void addListener(IPostStepListener* l) override;
 		virtual void removeListener(IPostStepListener* l) override;
 
+		virtual unsigned int addWindEmitter(const WindEmitterDesc& emitter) override;
+		virtual bool updateWindEmitter(unsigned int id, const WindEmitterDesc& emitter) override;
+		virtual bool removeWindEmitter(unsigned int id) override;
+
+		virtual void addContactListener(IContactListener* l) override;
+		virtual void removeContactListener(IContactListener* l) override;
+
+		virtual unsigned int addExternalCollider(const ExternalColliderDesc& collider) override;
+		virtual bool setExternalColliderTransform(unsigned int id, const float position[3], const float rotation[4], bool teleport) override;
+		virtual bool removeExternalCollider(unsigned int id) override;
+
+		virtual unsigned int getSystems(SystemInfo* systems, unsigned int capacity) override;
+		virtual unsigned int getSystemBones(unsigned int system, BoneHandle* bones, const char** names, unsigned int capacity) override;
+		virtual unsigned int queryBoneStates(const BoneHandle* bones, unsigned int count, const BoneStateBuffers& states) override;
+		virtual unsigned int querySystemStats(const unsigned int* systems, unsigned int count, const SystemStatsBuffers& stats) override;
+		virtual void applyBoneForces(const BoneHandle* bones, unsigned int count, const BoneForceBuffers& forces) override;
+
 		void onPostPostLoad();
 
 		void onPreStep(const PreStepEvent& e) { m_preStepDispatcher.SendEvent(std::addressof(e)); }
 		void onPostStep(const PostStepEvent& e) { m_postStepDispatcher.SendEvent(std::addressof(e)); }
+		void onContact(const ContactEvent& e) { m_contactDispatcher.SendEvent(std::addressof(e)); }
+
+		bool hasContactListeners() const { return m_contactListenerCount > 0; }
 
 		void init(const SKSE::LoadInterface* skse);
 
@@ -32,6 +52,8 @@ namespace hdt
 		VersionInfo m_versionInfo{ INTERFACE_VERSION, BULLET_VERSION };
 		RE::BSTEventSource<PreStepEvent> m_preStepDispatcher;
 		RE::BSTEventSource<PostStepEvent> m_postStepDispatcher;
+		RE::BSTEventSource<ContactEvent> m_contactDispatcher;
+		std::atomic<int> m_contactListenerCount{ 0 };
 
 		SKSE::PluginHandle m_sksePluginHandle;
 		SKSE::MessagingInterface* m_skseMessagingInterface;
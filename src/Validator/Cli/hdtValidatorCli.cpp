@@ -0,0 +1,195 @@
+// Standalone physics-asset validator: the checks of 'smp report' over a game directory
+// on disk, without the game, for mod authors and build servers. Same report as in game;
+// the equipped-gear pipeline needs a running game and is not available here.
+
+#include "Validator/Utils/hdtStringUtils.h"
+#include "Validator/Utils/hdtTimeUtils.h"
+#include "Validator/Utils/hdtValidatorLog.h"
+#include "Validator/hdtAssetValidatorCore.h"
+
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	// Exit codes, for scripts: warnings alone do not fail a build.
+	constexpr int kExitClean = 0;
+	constexpr int kExitErrors = 1;
+	constexpr int kExitUsage = 2;
+
+	void printUsage()
+	{
+		std::fputs(
+			"Usage: hdtsmp64-validator <game-or-data-dir> [options]\n"
+			"\n"
+			"Validates the physics assets of the data directory, loose or in its BSA archives\n"
+			"(defaultBBPs.xml, every NIF with a physics XML, their _0/_1 pairs, XMLs, skin\n"
+			"meshes and runtime cost) and writes the same report as 'smp report'.\n"
+			"\n"
+			"Options:\n"
+			"  --report <file>              report path (default: hdtSMP64_validation_<time>.log)\n"
+			"  --errors-only                write the errors-only report\n"
+			"  --plugins <plugins.txt>      mount only the archives of these active plugins, in this\n"
+			"                               order, as the game does (default: every archive, by name)\n"
+			"  --reference-skeleton <nif>   check bone references against this skeleton NIF\n"
+			"                               (e.g. meshes/actors/character/character assets/skeleton_female.nif)\n"
+			"  --time-step <seconds>        physics step the stability checks assume (default 1/60)\n"
+			"  --parse-cache-mb <mb>        memory for the NIF parses kept between phases (default 512,\n"
+			"                               0 to parse every NIF again in each phase)\n"
+			"  --verbose                    log discovery progress and timings\n"
+			"\n"
+			"Exit code: 0 no errors, 1 errors found, 2 bad arguments or no data directory.\n",
+			stdout);
+	}
+
+	struct Options
+	{
+		std::filesystem::path root;
+		std::filesystem::path report;
+		std::filesystem::path plugins;
+		std::string referenceSkeleton;
+		float timeStep = 1 / 60.f;
+		int parseCacheMB = 512;
+		bool errorsOnly = false;
+		bool verbose = false;
+	};
+
+	bool parseArgs(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (arg == "--report" && hasValue) {
+				options.report = argv[++i];
+			} else if (arg == "--plugins" && hasValue) {
+				options.plugins = argv[++i];
+			} else if (arg == "--reference-skeleton" && hasValue) {
+				options.referenceSkeleton = argv[++i];
+			} else if (arg == "--time-step" && hasValue) {
+				const std::string_view value = argv[++i];
+				auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.timeStep);
+				if (ec != std::errc() || end != value.data() + value.size() || !(options.timeStep > 0)) {
+					std::fprintf(stderr, "Invalid --time-step: %s\n", argv[i]);
+					return false;
+				}
+			} else if (arg == "--parse-cache-mb" && hasValue) {
+				const std::string_view value = argv[++i];
+				auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.parseCacheMB);
+				if (ec != std::errc() || end != value.data() + value.size() || options.parseCacheMB < 0) {
+					std::fprintf(stderr, "Invalid --parse-cache-mb: %s\n", argv[i]);
+					return false;
+				}
+			} else if (arg == "--errors-only") {
+				options.errorsOnly = true;
+			} else if (arg == "--verbose") {
+				options.verbose = true;
+			} else if (!arg.starts_with("--") && options.root.empty()) {
+				options.root = argv[i];
+			} else {
+				std::fprintf(stderr, "Unexpected argument: %s\n", argv[i]);
+				return false;
+			}
+		}
+		return !options.root.empty();
+	}
+
+	// The load order of a plugins.txt: the base game's masters and Creation Club plugins
+	// (Skyrim.ccc), which the game loads without listing them, then the active ("*")
+	// entries. False when the file does not read.
+	bool readPluginLoadOrder(const std::filesystem::path& pluginsTxt, const std::filesystem::path& gameDir,
+		std::vector<std::string>& out)
+	{
+		std::ifstream in(pluginsTxt);
+		if (!in.is_open())
+			return false;
+
+		out = { "Skyrim.esm", "Update.esm", "Dawnguard.esm", "HearthFires.esm", "Dragonborn.esm" };
+		std::ifstream ccc(hdt::ResolvePathCase(gameDir / "Skyrim.ccc"));
+		for (std::string line; std::getline(ccc, line);) {
+			line = hdt::TrimAsciiWhitespace(line);
+			if (!line.empty())
+				out.push_back(line);
+		}
+		for (std::string line; std::getline(in, line);) {
+			line = hdt::TrimAsciiWhitespace(line);
+			if (line.size() > 1 && line.front() == '*')
+				out.push_back(line.substr(1));
+		}
+		return true;
+	}
+
+	// The pipeline's paths are relative to the directory holding data/; accept that
+	// directory or the data directory itself.
+	std::filesystem::path findGameDirectory(const std::filesystem::path& given)
+	{
+		namespace fs = std::filesystem;
+		std::error_code ec;
+		const fs::path absolute = fs::absolute(given, ec).lexically_normal();
+		if (ec)
+			return {};
+		if (hdt::NormalizePathForComparison(hdt::PathToUtf8(absolute.filename())) == "data" && fs::is_directory(absolute, ec))
+			return absolute.parent_path();
+		if (fs::is_directory(hdt::ResolvePathCase(absolute / "data"), ec))
+			return absolute;
+		return {};
+	}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	namespace fs = std::filesystem;
+
+	Options options;
+	if (!parseArgs(argc, argv, options)) {
+		printUsage();
+		return kExitUsage;
+	}
+	logger::set_level(options.verbose ? spdlog::level::info : spdlog::level::warn);
+
+	const fs::path gameDir = findGameDirectory(options.root);
+	if (gameDir.empty()) {
+		std::fprintf(stderr, "No data directory in %s\n", hdt::PathToUtf8(options.root).c_str());
+		return kExitUsage;
+	}
+
+	const std::string timestamp = hdt::BuildTimestampStringForFilenames();
+	std::error_code ec;
+	const fs::path reportPath = fs::absolute(
+		options.report.empty() ? fs::path("hdtSMP64_validation_" + timestamp + ".log") : options.report, ec);
+	const fs::path pluginsPath = options.plugins.empty() ? fs::path() : fs::absolute(options.plugins, ec);
+	fs::current_path(gameDir, ec);
+	if (ec) {
+		std::fprintf(stderr, "Cannot enter %s: %s\n", hdt::PathToUtf8(gameDir).c_str(), ec.message().c_str());
+		return kExitUsage;
+	}
+
+	hdt::g_validationConfig.referenceSkeleton = options.referenceSkeleton;
+	hdt::g_validationConfig.parseCacheMB = options.parseCacheMB;
+	hdt::ValidationHost host;
+	host.timeStep = options.timeStep;
+	if (!options.plugins.empty() && !readPluginLoadOrder(pluginsPath, gameDir, host.pluginLoadOrder)) {
+		std::fprintf(stderr, "Cannot read %s\n", hdt::PathToUtf8(pluginsPath).c_str());
+		return kExitUsage;
+	}
+
+	hdt::AssetValidationResult report;
+	std::string content = hdt::RunValidationCore(report, timestamp, host);
+	if (options.errorsOnly)
+		content = hdt::BuildErrorsOnlyReport(report, timestamp, false);
+
+	std::ofstream out(reportPath, std::ios::out | std::ios::trunc);
+	if (!out.is_open() || !(out << content)) {
+		std::fprintf(stderr, "Cannot write the report to %s\n", hdt::PathToUtf8(reportPath).c_str());
+		return kExitUsage;
+	}
+
+	std::printf("Validated %d NIF(s) and %d XML(s) in %.2fs: %zu error(s), %zu warning(s).\nReport: %s\n",
+		report.totalNIFsScanned, report.totalXMLsFound, report.elapsedSeconds, report.errors.size(),
+		report.warnings.size(), hdt::PathToUtf8(reportPath).c_str());
+	return report.hasErrors ? kExitErrors : kExitClean;
+}
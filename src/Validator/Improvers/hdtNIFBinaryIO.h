@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <optional>
 #include <string>
@@ -79,6 +80,20 @@ namespace hdt
 		return parsed.blockTypes[masked];
 	}
 
+	// Name of a NiObjectNET-derived block (nodes, shapes, extra data): its first field is
+	// the string index. Empty for an unnamed block or an index out of range.
+	inline std::string blockNameOf(const ParsedNif& parsed, int32_t idx)
+	{
+		if (idx < 0 || idx >= static_cast<int32_t>(parsed.blocks.size()))
+			return {};
+		const auto& block = parsed.blocks[static_cast<size_t>(idx)];
+		if (block.size() < 4)
+			return {};
+		uint32_t stringIdx = 0;
+		std::memcpy(&stringIdx, block.data(), 4);
+		return stringIdx < parsed.strings.size() ? parsed.strings[stringIdx] : std::string();
+	}
+
 	// BSStreamHeader version stamped on Skyrim Special Edition / AE / VR NIFs.
 	// Skyrim LE (Oldrim) uses lower values (typically 83) and a different geometry
 	// layout (NiTriShape/NiTriShapeData rather than BSTriShape), which the FSMP
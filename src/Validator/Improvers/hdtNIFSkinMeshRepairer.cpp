@@ -0,0 +1,103 @@
+#include "hdtNIFSkinMeshRepairer.h"
+
+#include "../Utils/hdtStringUtils.h"
+#include "hdtNIFBinaryIO.h"
+#include "hdtNIFOrphanedSkinImprover.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace hdt
+{
+	namespace
+	{
+		/// The issues as (block, reason) pairs, sorted, for comparing two detections of
+		/// the same block layout.
+		std::vector<std::pair<int, std::string>> issueKeys(const std::vector<NifSkinMeshIssue>& issues)
+		{
+			std::vector<std::pair<int, std::string>> keys;
+			keys.reserve(issues.size());
+			for (const auto& issue : issues)
+				keys.emplace_back(issue.triShapeBlockIndex, issue.reasonCode);
+			std::sort(keys.begin(), keys.end());
+			return keys;
+		}
+
+		/// Likewise, by (shape type, reason) for after the orphan removal has renumbered
+		/// the blocks.
+		std::vector<std::pair<std::string, std::string>> issueKinds(const std::vector<NifSkinMeshIssue>& issues)
+		{
+			std::vector<std::pair<std::string, std::string>> kinds;
+			kinds.reserve(issues.size());
+			for (const auto& issue : issues)
+				kinds.emplace_back(issue.shapeType, issue.reasonCode);
+			std::sort(kinds.begin(), kinds.end());
+			return kinds;
+		}
+	}
+
+	NifRepairOutcome RepairNifSkinMeshes(const ParsedNif& parsed, const std::string& nifPath,
+		const std::filesystem::path& outPath, bool dryRun)
+	{
+		NifRepairOutcome outcome;
+		outcome.plan = planNIFSkinMeshRepairs(parsed, detectNIFSkinMeshIssues(parsed, nifPath));
+		outcome.orphanedSkinInstances = countOrphanedSkinInstances(parsed);
+		if (dryRun || !outcome.needed())
+			return outcome;
+
+		ParsedNif repaired = parsed;
+		if (!applyNIFSkinMeshRepairs(repaired, outcome.plan)) {
+			outcome.failure = "a repair does not fit its block";
+			return outcome;
+		}
+		// Checked before the orphan removal renumbers the blocks, so that the nifly verdicts
+		// on the original still apply and every issue left is on the shape it was on.
+		const auto patched = detectNIFSkinMeshIssues(repaired, nifPath);
+		if (issueKeys(patched) != issueKeys(outcome.plan.unrepairable)) {
+			outcome.failure = "re-validation of the repaired shapes found " + std::to_string(patched.size()) +
+			                  " issue(s) where " + std::to_string(outcome.plan.unrepairable.size()) + " were expected";
+			return outcome;
+		}
+		if (outcome.orphanedSkinInstances > 0)
+			removeOrphanedSkinInstances(repaired);
+
+		std::vector<uint8_t> bytes;
+		try {
+			bytes = serializeNif(repaired);
+		} catch (const std::exception& e) {
+			outcome.failure = std::string("serialisation failed: ") + e.what();
+			return outcome;
+		}
+		if (auto error = validateNifRoundTripFromBytes(bytes, repaired)) {
+			outcome.failure = "round trip failed: " + *error;
+			return outcome;
+		}
+		std::string parseError;
+		auto reparsed = parseNif(bytes, &parseError);
+		if (!reparsed) {
+			outcome.failure = "the repaired file does not parse: " + parseError;
+			return outcome;
+		}
+
+		// Written before the last check so that its nifly second opinion reads this file.
+		const std::string outPathUtf8 = PathToUtf8(outPath);
+		std::error_code ec;
+		std::filesystem::create_directories(outPath.parent_path(), ec);
+		if (!writeNifBytes(bytes, outPathUtf8)) {
+			outcome.failure = "could not write " + outPathUtf8;
+			return outcome;
+		}
+		const int orphansLeft = countOrphanedSkinInstances(*reparsed);
+		const auto remaining = detectNIFSkinMeshIssues(*reparsed, outPathUtf8);
+		if (orphansLeft != 0 || issueKinds(remaining) != issueKinds(outcome.plan.unrepairable)) {
+			std::filesystem::remove(outPath, ec);
+			outcome.failure = "re-validation of the written file found " + std::to_string(remaining.size()) +
+			                  " issue(s) and " + std::to_string(orphansLeft) + " orphaned skin instance(s)";
+			return outcome;
+		}
+
+		outcome.written = true;
+		return outcome;
+	}
+}
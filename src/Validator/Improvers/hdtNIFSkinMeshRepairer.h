@@ -0,0 +1,32 @@
+#pragma once
+
+#include "hdtNIFSkinMeshValidator.h"
+
+#include <filesystem>
+#include <string>
+
+namespace hdt
+{
+	struct ParsedNif;
+
+	struct NifRepairOutcome
+	{
+		NifSkinMeshRepairPlan plan;
+		int orphanedSkinInstances = 0;  // NiSkinInstance blocks with no NiSkinPartition, removed with the rest
+		bool written = false;           // the repaired copy passed re-validation and is on disk
+		std::string failure;            // why it was not written; empty on success and for dry runs
+
+		bool needed() const { return !plan.empty() || orphanedSkinInstances > 0; }
+	};
+
+	/// Repair the skin meshes of one NIF into `outPath`, in four steps: plan the repairs of
+	/// the issues detectNIFSkinMeshIssues finds (planNIFSkinMeshRepairs) and the orphaned
+	/// skin instances (countOrphanedSkinInstances); apply them to a copy of `parsed`;
+	/// serialise and re-parse the copy; re-validate it, which must find exactly the issues
+	/// the plan left and no orphaned skin instance. A copy failing any step is not written
+	/// (or removed again) and `failure` says why. With `dryRun` only the plan is made.
+	/// `nifPath` is the original, for the nifly second opinion on layouts our parser
+	/// does not read.
+	NifRepairOutcome RepairNifSkinMeshes(const ParsedNif& parsed, const std::string& nifPath,
+		const std::filesystem::path& outPath, bool dryRun);
+}
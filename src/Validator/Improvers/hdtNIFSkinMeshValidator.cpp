@@ -11,6 +11,8 @@
 #include <limits>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -34,6 +36,8 @@ namespace hdt
 			uint16_t numTriangles = 0;
 			std::vector<uint8_t> vertexData;
 			std::vector<std::array<uint16_t, 3>> triangles;
+			size_t trianglesOffset = 0;
+			size_t particleTrianglesOffset = 0;
 		};
 
 		struct PartitionView
@@ -45,6 +49,7 @@ namespace hdt
 			std::vector<uint16_t> vertexMap;
 			std::vector<std::array<uint16_t, 3>> triangles;
 			std::vector<std::array<uint16_t, 3>> trianglesCopy;
+			size_t vertexMapOffset = 0;
 			size_t trianglesOffset = 0;
 			size_t trianglesCopyOffset = 0;
 			bool trianglesMismatch = false;
@@ -175,6 +180,7 @@ namespace hdt
 					return std::nullopt;
 
 				out.vertexData = r.readBytes(static_cast<size_t>(out.numVertices) * out.layout.vertexSize);
+				out.trianglesOffset = r.pos();
 				out.triangles.clear();
 				out.triangles.reserve(out.numTriangles);
 				for (uint16_t i = 0; i < out.numTriangles; ++i)
@@ -188,6 +194,7 @@ namespace hdt
 					return std::nullopt;
 				r.skip(static_cast<size_t>(out.numVertices) * 6);  // particle positions
 				r.skip(static_cast<size_t>(out.numVertices) * 6);  // particle normals
+				out.particleTrianglesOffset = r.pos();
 				std::vector<std::array<uint16_t, 3>> particleTris;
 				particleTris.reserve(out.numTriangles);
 				for (uint16_t i = 0; i < out.numTriangles; ++i)
@@ -252,6 +259,7 @@ namespace hdt
 				bool hasVertexMap = false;
 				if (!readBoolStrict(r, hasVertexMap) || !hasVertexMap)
 					return std::nullopt;
+				out.vertexMapOffset = r.pos();
 				out.vertexMap.reserve(out.numVertices);
 				for (uint16_t i = 0; i < out.numVertices; ++i)
 					out.vertexMap.push_back(r.readU16());
@@ -433,6 +441,151 @@ namespace hdt
 			return out;
 		}
 
+		// ── Repair planning ───────────────────────────────────────────────────────
+
+		std::vector<uint16_t> flattenTriangles(const std::vector<std::array<uint16_t, 3>>& tris)
+		{
+			std::vector<uint16_t> out;
+			out.reserve(tris.size() * 3);
+			for (const auto& tri : tris)
+				out.insert(out.end(), tri.begin(), tri.end());
+			return out;
+		}
+
+		size_t countDifferences(const std::vector<std::array<uint16_t, 3>>& a,
+			const std::vector<std::array<uint16_t, 3>>& b)
+		{
+			size_t n = 0;
+			for (size_t i = 0; i < a.size() && i < b.size(); ++i)
+				n += a[i] != b[i] ? 1 : 0;
+			return n;
+		}
+
+		/// Pair every partition vertex with a byte-identical shape vertex, each shape vertex
+		/// used once. Entries that already pair identical vertices are kept, so that among
+		/// identical vertices (seams) the map only changes where it has to. nullopt when a
+		/// partition vertex has no identical shape vertex left.
+		std::optional<std::vector<uint16_t>> rebuildVertexMap(const TriShapeView& ts, const PartitionView& part)
+		{
+			const size_t stride = ts.layout.vertexSize;
+			const size_t n = part.vertexMap.size();
+			if (stride == 0 || ts.vertexData.size() != n * stride || part.vertexData.size() != n * stride)
+				return std::nullopt;
+
+			auto vertexBytes = [stride](const std::vector<uint8_t>& data, size_t i) {
+				return std::string_view(reinterpret_cast<const char*>(data.data()) + i * stride, stride);
+			};
+
+			std::vector<uint16_t> map(n, 0);
+			std::vector<uint8_t> assigned(n, 0);
+			std::vector<uint8_t> taken(n, 0);
+			for (size_t p = 0; p < n; ++p) {
+				const uint16_t s = part.vertexMap[p];
+				if (s < n && taken[s] == 0 && vertexBytes(ts.vertexData, s) == vertexBytes(part.vertexData, p)) {
+					map[p] = s;
+					assigned[p] = 1;
+					taken[s] = 1;
+				}
+			}
+
+			std::unordered_map<std::string_view, std::vector<uint16_t>> shapeVertices;
+			for (size_t s = 0; s < n; ++s)
+				if (taken[s] == 0)
+					shapeVertices[vertexBytes(ts.vertexData, s)].push_back(static_cast<uint16_t>(s));
+			for (size_t p = 0; p < n; ++p) {
+				if (assigned[p] != 0)
+					continue;
+				auto it = shapeVertices.find(vertexBytes(part.vertexData, p));
+				if (it == shapeVertices.end() || it->second.empty())
+					return std::nullopt;
+				map[p] = it->second.back();
+				it->second.pop_back();
+			}
+			return map;
+		}
+
+		/// Plan the repairs of one candidate, adding the reason codes they clear to
+		/// `resolved`. Stops at the first issue it cannot settle from the data: the later
+		/// repairs would build on a guess.
+		void planCandidateRepairs(const ParsedNif& parsed, const SkinMeshCandidate& c,
+			std::vector<NifSkinMeshRepair>& repairs, std::unordered_set<std::string>& resolved)
+		{
+			auto tsOpt = parseTriShape(parsed.blocks[static_cast<size_t>(c.triShapeBlockIndex)], c.shapeType, parsed.bsVersion);
+			auto partOpt = parsePartitionTolerant(parsed.blocks[static_cast<size_t>(c.partitionBlockIndex)], parsed.bsVersion);
+			if (!tsOpt || !partOpt)
+				return;
+			const auto& ts = *tsOpt;
+			const auto& part = *partOpt;
+			// Two meshes of different sizes: which one is right is not in the file.
+			if (ts.layout.desc != part.layout.desc || ts.numVertices != part.numVertices ||
+				ts.numTriangles != part.numTriangles)
+				return;
+
+			auto addRepair = [&](NifSkinMeshRepairAction action, std::string detail, std::vector<NifBlockPatch> patches,
+								 std::initializer_list<const char*> codes) {
+				repairs.push_back({ c.triShapeBlockIndex, c.shapeType, action, std::move(detail), std::move(patches) });
+				resolved.insert(codes.begin(), codes.end());
+			};
+
+			// Steps 7 and 8: the triangles can only be judged through a map that pairs
+			// identical vertices.
+			std::vector<uint16_t> vertexMap = part.vertexMap;
+			if (!isPermutationVertexMap(vertexMap) ||
+				!vertexDataMatchesMappedOrder(ts.vertexData, part.vertexData, vertexMap, ts.layout.vertexSize)) {
+				auto rebuilt = rebuildVertexMap(ts, part);
+				if (!rebuilt)
+					return;
+				size_t changed = 0;
+				for (size_t i = 0; i < rebuilt->size(); ++i)
+					changed += (*rebuilt)[i] != vertexMap[i] ? 1 : 0;
+				vertexMap = std::move(*rebuilt);
+				addRepair(NifSkinMeshRepairAction::RebuildVertexMap,
+					std::to_string(changed) + " of " + std::to_string(vertexMap.size()) + " vertex map entries",
+					{ { c.partitionBlockIndex, part.vertexMapOffset, vertexMap } },
+					{ "unsupported-non-permutation-vertex-map", "shape-partition-vertexdata-mismatch" });
+			}
+
+			auto inRange = [&](const std::vector<std::array<uint16_t, 3>>& tris) {
+				return std::all_of(tris.begin(), tris.end(), [&](const auto& tri) {
+					return tri[0] < part.numVertices && tri[1] < part.numVertices && tri[2] < part.numVertices;
+				});
+			};
+			auto matchesShape = [&](const std::vector<std::array<uint16_t, 3>>& tris) {
+				auto mapped = mapTriangles(tris, vertexMap);
+				return inRange(tris) && mapped && *mapped == ts.triangles;
+			};
+			const std::string ofTriangles = " of " + std::to_string(part.numTriangles) + " triangles";
+
+			// Step 9: of two different partition arrays, keep the one the shape confirms.
+			if (part.trianglesMismatch) {
+				const std::string detail = std::to_string(countDifferences(part.triangles, part.trianglesCopy)) + ofTriangles;
+				if (matchesShape(part.triangles))
+					addRepair(NifSkinMeshRepairAction::RewriteTrianglesCopy, detail,
+						{ { c.partitionBlockIndex, part.trianglesCopyOffset, flattenTriangles(part.triangles) } },
+						{ "partition-triangle-copy-mismatch" });
+				else if (matchesShape(part.trianglesCopy))
+					addRepair(NifSkinMeshRepairAction::RewritePartitionTriangles, detail,
+						{ { c.partitionBlockIndex, part.trianglesOffset, flattenTriangles(part.trianglesCopy) } },
+						{ "partition-triangle-copy-mismatch", "shape-partition-triangle-mismatch",
+							"triangle-index-out-of-range" });
+				return;
+			}
+
+			// Steps 10 and 11: the partition agrees with itself but not with the shape. The
+			// game skins and draws the partition, so the shape follows it.
+			if (matchesShape(part.triangles) || !inRange(part.triangles))
+				return;
+			auto mapped = mapTriangles(part.triangles, vertexMap);
+			if (!mapped)
+				return;
+			const std::string detail = std::to_string(countDifferences(*mapped, ts.triangles)) + ofTriangles;
+			std::vector<uint16_t> shapeTriangles = flattenTriangles(*mapped);
+			addRepair(NifSkinMeshRepairAction::RewriteShapeTriangles, detail,
+				{ { c.triShapeBlockIndex, ts.trianglesOffset, shapeTriangles },
+					{ c.triShapeBlockIndex, ts.particleTrianglesOffset, shapeTriangles } },
+				{ "shape-partition-triangle-mismatch" });
+		}
+
 	}  // namespace
 
 	// ── Public API ────────────────────────────────────────────────────────────────
@@ -539,4 +692,59 @@ namespace hdt
 			partOpt->numTriangles
 		};
 	}
+
+	const char* NifSkinMeshRepairActionName(NifSkinMeshRepairAction action)
+	{
+		switch (action) {
+		case NifSkinMeshRepairAction::RebuildVertexMap:
+			return "rebuild-vertex-map";
+		case NifSkinMeshRepairAction::RewriteTrianglesCopy:
+			return "rewrite-triangles-copy";
+		case NifSkinMeshRepairAction::RewritePartitionTriangles:
+			return "rewrite-partition-triangles";
+		case NifSkinMeshRepairAction::RewriteShapeTriangles:
+			return "rewrite-shape-triangles";
+		}
+		return "unknown";
+	}
+
+	NifSkinMeshRepairPlan planNIFSkinMeshRepairs(const ParsedNif& parsed, const std::vector<NifSkinMeshIssue>& issues)
+	{
+		NifSkinMeshRepairPlan plan;
+		if (issues.empty())
+			return plan;
+
+		std::unordered_map<int, std::unordered_set<std::string>> resolvedByShape;
+		for (const auto& c : discoverSkinMeshCandidates(parsed)) {
+			const bool flagged = std::any_of(issues.begin(), issues.end(),
+				[&](const NifSkinMeshIssue& issue) { return issue.triShapeBlockIndex == c.triShapeBlockIndex; });
+			if (flagged)
+				planCandidateRepairs(parsed, c, plan.repairs, resolvedByShape[c.triShapeBlockIndex]);
+		}
+
+		for (const auto& issue : issues) {
+			auto it = resolvedByShape.find(issue.triShapeBlockIndex);
+			if (it == resolvedByShape.end() || !it->second.contains(issue.reasonCode))
+				plan.unrepairable.push_back(issue);
+		}
+		return plan;
+	}
+
+	bool applyNIFSkinMeshRepairs(ParsedNif& parsed, const NifSkinMeshRepairPlan& plan)
+	{
+		for (const auto& repair : plan.repairs) {
+			for (const auto& patch : repair.patches) {
+				if (patch.blockIndex < 0 || static_cast<size_t>(patch.blockIndex) >= parsed.blocks.size())
+					return false;
+				auto& block = parsed.blocks[static_cast<size_t>(patch.blockIndex)];
+				if (patch.offset > block.size() || patch.values.size() * 2 > block.size() - patch.offset)
+					return false;
+				for (size_t i = 0; i < patch.values.size(); ++i) {
+					block[patch.offset + i * 2] = static_cast<uint8_t>(patch.values[i] & 0xFFu);
+					block[patch.offset + i * 2 + 1] = static_cast<uint8_t>(patch.values[i] >> 8);
+				}
+			}
+		}
+		return true;
+	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
@@ -37,4 +39,53 @@ namespace hdt
 	};
 	std::optional<PartitionMismatchInfo> checkPartitionTriangleMismatch(
 		const std::vector<uint8_t>& block, uint32_t bsVersion);
+
+	/// An in-place rewrite of a run of uint16 values (indices) in one block.
+	struct NifBlockPatch
+	{
+		int blockIndex = -1;
+		size_t offset = 0;  // byte offset in the block
+		std::vector<uint16_t> values;
+	};
+
+	enum class NifSkinMeshRepairAction
+	{
+		RebuildVertexMap,           // pair every partition vertex with the identical shape vertex
+		RewriteTrianglesCopy,       // trianglesCopy := triangles, the array that matches the shape
+		RewritePartitionTriangles,  // triangles := trianglesCopy, the array that matches the shape
+		RewriteShapeTriangles       // shape and particle triangles := the partition's, through the map
+	};
+
+	const char* NifSkinMeshRepairActionName(NifSkinMeshRepairAction action);
+
+	struct NifSkinMeshRepair
+	{
+		int triShapeBlockIndex = -1;
+		std::string shapeType;
+		NifSkinMeshRepairAction action = NifSkinMeshRepairAction::RewriteTrianglesCopy;
+		std::string detail;  // for the summary: "1 of 2048 vertex map entries"
+		std::vector<NifBlockPatch> patches;
+	};
+
+	struct NifSkinMeshRepairPlan
+	{
+		std::vector<NifSkinMeshRepair> repairs;       // in the order they must be applied
+		std::vector<NifSkinMeshIssue> unrepairable;  // the issues no repair addresses
+		bool empty() const { return repairs.empty(); }
+	};
+
+	/// Dry run of the repair pass over the issues detectNIFSkinMeshIssues found in
+	/// `parsed`. Every repair rewrites indices in place and is decided by the data:
+	/// the vertex map is rebuilt only when every partition vertex has a byte-identical
+	/// shape vertex of its own; of two different partition triangle arrays the one that
+	/// maps onto the shape's triangles wins; and when the partition agrees with itself
+	/// but not with the shape, the shape's triangles are rewritten from the partition,
+	/// which is what the game skins and draws. Count mismatches, vertex data that no map
+	/// reconciles and layouts this parser does not read have no safe repair and are
+	/// returned in `unrepairable`.
+	NifSkinMeshRepairPlan planNIFSkinMeshRepairs(const ParsedNif& parsed, const std::vector<NifSkinMeshIssue>& issues);
+
+	/// Apply the patches of `plan` to `parsed`. False, with `parsed` partly patched, when
+	/// a patch does not fit its block (the plan was made for another parse).
+	bool applyNIFSkinMeshRepairs(ParsedNif& parsed, const NifSkinMeshRepairPlan& plan);
 }
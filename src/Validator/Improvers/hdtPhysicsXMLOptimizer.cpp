@@ -0,0 +1,255 @@
+#include "hdtPhysicsXMLOptimizer.h"
+
+#include "../Utils/hdtStringUtils.h"
+#include "../Utils/hdtTemplateDefaults.h"
+#include "../Utils/hdtXMLUtils.h"
+
+#include <pugixml.hpp>
+
+#include <functional>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace hdt
+{
+	namespace
+	{
+		// Comments and indentation are the author's; keep them through the rewrite.
+		constexpr unsigned kParseOptions =
+			pugi::parse_default | pugi::parse_declaration | pugi::parse_comments | pugi::parse_ws_pcdata;
+
+		using EditList = std::vector<XmlOptimizerEdit>;
+
+		bool sameNode(const ResolvedPhysicsNode& a, const ResolvedPhysicsNode& b)
+		{
+			// Locations are left out: removing a default node renumbers nothing the runtime sees.
+			return a.family == b.family && a.name == b.name && a.bodyA == b.bodyA && a.bodyB == b.bodyB &&
+			       a.fields == b.fields;
+		}
+
+		bool sameDefinitions(const ResolvedPhysicsDefinitions& a, const ResolvedPhysicsDefinitions& b)
+		{
+			if (a.nodes.size() != b.nodes.size() || a.defaultBone.fields != b.defaultBone.fields)
+				return false;
+			for (size_t i = 0; i < a.nodes.size(); ++i)
+				if (!sameNode(a.nodes[i], b.nodes[i]))
+					return false;
+			return true;
+		}
+
+		pugi::xml_node systemNode(const pugi::xml_document& doc)
+		{
+			for (auto child = doc.first_child(); child; child = child.next_sibling())
+				if (child.type() == pugi::node_element && XmlLocalName(child.name()) == "system")
+					return child;
+			return {};
+		}
+
+		// Every bone, shape, constraint and *-default, constraint-group members included.
+		void forEachPhysicsNode(const pugi::xml_node& parent, const std::function<void(pugi::xml_node, Family, const std::string&)>& fn)
+		{
+			for (auto node = parent.first_child(); node; node = node.next_sibling()) {
+				if (node.type() != pugi::node_element)
+					continue;
+				const std::string localName = std::string(XmlLocalName(node.name()));
+				if (localName == "constraint-group") {
+					forEachPhysicsNode(node, fn);
+					continue;
+				}
+				const Family family = familyForNode(localName);
+				if (family != Family::None)
+					fn(node, family, localName);
+			}
+		}
+
+		std::string describeElement(const pugi::xml_node& node)
+		{
+			std::string out = "<" + std::string(node.name());
+			const std::string name = TrimAsciiWhitespace(node.attribute("name").as_string());
+			if (!name.empty())
+				out += " name=\"" + name + "\"";
+			return out + ">";
+		}
+
+		struct ElementInfo
+		{
+			ptrdiff_t parentOffset = -1;
+			int line = 0;
+			std::string description;
+		};
+
+		// Elements keyed by their offset in the original source, which survives removals of
+		// other nodes, so that two snapshots tell what a rewrite removed.
+		void snapshotElements(const pugi::xml_node& parent, const std::string& bytes, std::map<ptrdiff_t, ElementInfo>& out)
+		{
+			for (auto child = parent.first_child(); child; child = child.next_sibling()) {
+				if (child.type() != pugi::node_element)
+					continue;
+				ElementInfo info;
+				info.parentOffset = parent.type() == pugi::node_element ? parent.offset_debug() : -1;
+				info.line = OffsetToLineNumber(bytes, child.offset_debug());
+				info.description = describeElement(child) + " at " + BuildNodeLocationPath(child);
+				out.emplace(child.offset_debug(), std::move(info));
+				snapshotElements(child, bytes, out);
+			}
+		}
+
+		// Point every reference to an alias template at its earlier equivalent. The aliases
+		// are keyed by name alone, so names that several families define are left as they are.
+		size_t mergeEquivalentTemplates(pugi::xml_document& doc, const std::string& bytes, EditList* edits)
+		{
+			const auto aliases = CollectEquivalentDefaultTemplateAliases(doc);
+			if (aliases.empty())
+				return 0;
+
+			auto sysNode = systemNode(doc);
+			std::unordered_map<std::string, std::unordered_set<Family>> definingFamilies;
+			forEachPhysicsNode(sysNode, [&](pugi::xml_node node, Family family, const std::string& localName) {
+				if (isDefaultNodeName(localName))
+					definingFamilies[TrimAsciiWhitespace(node.attribute("name").as_string())].insert(family);
+			});
+
+			std::unordered_set<std::string> merged;
+			forEachPhysicsNode(sysNode, [&](pugi::xml_node node, Family family, const std::string& localName) {
+				auto attribute = node.attribute(isDefaultNodeName(localName) ? "extends" : "template");
+				const std::string reference = TrimAsciiWhitespace(attribute.as_string());
+				auto alias = aliases.find(reference);
+				if (alias == aliases.end())
+					return;
+				const auto& families = definingFamilies[reference];
+				if (families.size() != 1 || !families.contains(family))
+					return;
+
+				attribute.set_value(alias->second.c_str());
+				merged.insert(reference);
+				if (edits)
+					edits->push_back({ OffsetToLineNumber(bytes, node.offset_debug()),
+						std::string(attribute.name()) + "=\"" + reference + "\" -> \"" + alias->second + "\" on " + describeElement(node) +
+							": both templates resolve to the same settings" });
+			});
+			return merged.size();
+		}
+
+		// A removal leaves the indentation before the removed tag behind it; drop it.
+		void tidyWhitespace(pugi::xml_node parent)
+		{
+			auto isBlank = [](const pugi::xml_node& node) {
+				return node.type() == pugi::node_pcdata && TrimAsciiWhitespace(node.value()).empty();
+			};
+			for (auto child = parent.first_child(); child;) {
+				auto next = child.next_sibling();
+				if (isBlank(child) && next && isBlank(next))
+					parent.remove_child(child);
+				else if (child.type() == pugi::node_element)
+					tidyWhitespace(child);
+				child = next;
+			}
+		}
+
+		class Optimizer
+		{
+		public:
+			Optimizer(const std::string& bytes, XmlOptimizerResult& result) :
+				m_bytes(bytes),
+				m_result(result)
+			{}
+
+			bool load()
+			{
+				if (!m_doc.load_buffer(m_bytes.data(), m_bytes.size(), kParseOptions) || !systemNode(m_doc))
+					return false;
+				m_original = ResolvePhysicsDefinitions(m_doc);
+				return true;
+			}
+
+			// Try `rewrite` on a copy, keep it when the resolved definitions don't move, and
+			// record what it removed. Returns the number of top-level nodes it removed.
+			size_t apply(const char* stepName, const std::function<void(pugi::xml_document&, EditList*)>& rewrite, const char* removalReason)
+			{
+				pugi::xml_document trial;
+				trial.reset(m_doc);
+				rewrite(trial, nullptr);
+				if (!sameDefinitions(ResolvePhysicsDefinitions(trial), m_original)) {
+					m_result.rejectedSteps.push_back(stepName);
+					return 0;
+				}
+
+				std::map<ptrdiff_t, ElementInfo> before, after;
+				snapshotElements(m_doc, m_bytes, before);
+				rewrite(m_doc, &m_result.edits);
+				snapshotElements(m_doc, m_bytes, after);
+
+				size_t removed = 0;
+				for (const auto& [offset, info] : before) {
+					if (after.contains(offset) || (before.contains(info.parentOffset) && !after.contains(info.parentOffset)))
+						continue;
+					m_result.edits.push_back({ info.line, "removed " + info.description + ": " + removalReason });
+					++removed;
+				}
+				return removed;
+			}
+
+			// Serialise, and check once more that what gets written resolves as the original.
+			void finish()
+			{
+				if (m_result.edits.empty())
+					return;
+
+				tidyWhitespace(m_doc);
+				std::ostringstream out;
+				m_doc.save(out, "\t", pugi::format_raw | pugi::format_no_declaration, pugi::encoding_utf8);
+				std::string text = out.str();
+
+				pugi::xml_document check;
+				if (!check.load_buffer(text.data(), text.size(), kParseOptions) ||
+					!sameDefinitions(ResolvePhysicsDefinitions(check), m_original)) {
+					m_result.rejectedSteps.push_back("serialisation");
+					m_result.edits.clear();
+					return;
+				}
+				m_result.optimized = std::move(text);
+			}
+
+		private:
+			const std::string& m_bytes;
+			XmlOptimizerResult& m_result;
+			pugi::xml_document m_doc;
+			ResolvedPhysicsDefinitions m_original;
+		};
+	}  // namespace
+
+	XmlOptimizerResult OptimizePhysicsXml(const std::string& bytes)
+	{
+		XmlOptimizerResult result;
+		Optimizer optimizer(bytes, result);
+		if (bytes.empty() || !optimizer.load())
+			return result;
+		result.parsed = true;
+
+		optimizer.apply(
+			"merge equivalent templates",
+			[&](pugi::xml_document& doc, EditList* edits) {
+				const size_t merged = mergeEquivalentTemplates(doc, bytes, edits);
+				if (edits)
+					result.mergedTemplates = merged;
+			},
+			"");
+		result.removedDefaults = optimizer.apply(
+			"remove unused templates",
+			[](pugi::xml_document& doc, EditList*) { RemoveUnusedDefaultNodes(doc); },
+			"no later node uses this template");
+		result.removedChildren = optimizer.apply(
+			"remove redundant tags",
+			[](pugi::xml_document& doc, EditList*) { RemoveTemplateRedundantChildren(doc); },
+			"restates the value its template gives");
+		optimizer.finish();
+		if (!result.changed()) {
+			result.mergedTemplates = 0;
+			result.removedDefaults = 0;
+			result.removedChildren = 0;
+		}
+		return result;
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace hdt
+{
+	/// One change the optimizer made, for the diff summary. `line` is in the original XML.
+	struct XmlOptimizerEdit
+	{
+		int line = 0;
+		std::string description;
+	};
+
+	struct XmlOptimizerResult
+	{
+		bool parsed = false;    // false when the XML doesn't load; nothing is rewritten then
+		std::string optimized;  // the rewritten document; empty when nothing changed
+		std::vector<XmlOptimizerEdit> edits;
+		std::vector<std::string> rejectedSteps;  // rewrites dropped because they changed the resolved definitions
+		size_t mergedTemplates = 0;
+		size_t removedDefaults = 0;
+		size_t removedChildren = 0;
+
+		bool changed() const { return !optimized.empty(); }
+	};
+
+	/// Rewrite one physics XML with the template redundancy rewrites, in order: references
+	/// to a named *-default equivalent to an earlier one are pointed at the earlier one
+	/// (CollectEquivalentDefaultTemplateAliases), *-default nodes nothing uses any more are
+	/// removed (RemoveUnusedDefaultNodes), then child tags restating their template
+	/// (RemoveTemplateRedundantChildren).
+	/// Each rewrite is tried on a copy first and only kept when ResolvePhysicsDefinitions
+	/// gives the same bones, shapes and constraints as the original; the final document is
+	/// checked again once serialised. Comments and formatting are kept.
+	XmlOptimizerResult OptimizePhysicsXml(const std::string& bytes);
+}
@@ -0,0 +1,334 @@
+#include "hdtBSAArchiveReader.h"
+
+#include "../Utils/hdtStringUtils.h"
+
+#include <lz4frame.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace hdt
+{
+	namespace
+	{
+		// ── Format constants (UESP "Skyrim Mod:Archive File Format") ─────────────
+
+		constexpr char kMagic[4] = { 'B', 'S', 'A', '\0' };
+		constexpr uint32_t kVersionSkyrimLE = 104;  // zlib
+		constexpr uint32_t kVersionSkyrimSE = 105;  // LZ4 frames, 64-bit folder offsets
+		constexpr size_t kHeaderSize = 36;
+
+		constexpr uint32_t kIncludeDirectoryNames = 0x1;
+		constexpr uint32_t kIncludeFileNames = 0x2;
+		constexpr uint32_t kCompressedByDefault = 0x4;
+		constexpr uint32_t kEmbedFileNames = 0x100;
+
+		constexpr uint32_t kToggleCompression = 0x40000000;
+		constexpr uint32_t kSizeMask = 0x3FFFFFFF;
+
+		constexpr size_t kFileRecordSize = 16;  // hash, size, offset
+
+		// Compressed input is fed to the decoders in chunks this large, so that a probe of
+		// the start of a file reads little more than that.
+		constexpr size_t kInputChunk = 64 * 1024;
+
+		// Bounds-checked little-endian reads over the directory tables.
+		class TableCursor
+		{
+		public:
+			explicit TableCursor(const std::vector<uint8_t>& data) :
+				m_data(data)
+			{}
+
+			template <class T>
+			bool read(T& value)
+			{
+				if (m_pos + sizeof(T) > m_data.size())
+					return false;
+				std::memcpy(&value, m_data.data() + m_pos, sizeof(T));
+				m_pos += sizeof(T);
+				return true;
+			}
+
+			bool skip(size_t bytes)
+			{
+				if (m_pos + bytes > m_data.size())
+					return false;
+				m_pos += bytes;
+				return true;
+			}
+
+			// Folder names: length byte (terminator included), then the NUL-terminated name.
+			bool readPrefixedName(std::string& out)
+			{
+				uint8_t length = 0;
+				if (!read(length) || m_pos + length > m_data.size())
+					return false;
+				const char* begin = reinterpret_cast<const char*>(m_data.data() + m_pos);
+				out.assign(begin, strnlen(begin, length));
+				m_pos += length;
+				return true;
+			}
+
+			// File names: NUL-terminated, one after the other.
+			bool readTerminatedName(std::string& out)
+			{
+				const auto* begin = m_data.data() + m_pos;
+				const auto* end = m_data.data() + m_data.size();
+				const auto* nul = std::find(begin, end, uint8_t(0));
+				if (nul == end)
+					return false;
+				const auto length = static_cast<size_t>(nul - begin);
+				out.assign(reinterpret_cast<const char*>(begin), length);
+				m_pos += length + 1;
+				return true;
+			}
+
+		private:
+			const std::vector<uint8_t>& m_data;
+			size_t m_pos = 0;
+		};
+
+		// Feed `compressedSize` bytes of `in` to `decode` in chunks until it has produced
+		// `out.size()` bytes or the input runs out. `decode(src, srcSize, consumed)` writes
+		// into `out` itself and returns false on corrupt data or once the stream has ended.
+		template <class Decode>
+		bool decodeChunked(std::ifstream& in, size_t compressedSize, Decode&& decode, bool& finished)
+		{
+			std::vector<char> chunk(std::min(compressedSize, kInputChunk));
+			size_t remaining = compressedSize;
+			while (remaining > 0 && !finished) {
+				const size_t n = std::min(remaining, chunk.size());
+				if (!in.read(chunk.data(), static_cast<std::streamsize>(n)))
+					return false;
+				remaining -= n;
+
+				size_t offset = 0;
+				while (offset < n && !finished) {
+					size_t consumed = 0;
+					if (!decode(chunk.data() + offset, n - offset, consumed))
+						return false;
+					if (consumed == 0 && !finished)
+						break;  // needs the next chunk
+					offset += consumed;
+				}
+			}
+			return true;
+		}
+
+		bool inflateZlib(std::ifstream& in, size_t compressedSize, std::string& out)
+		{
+			z_stream stream{};
+			if (inflateInit(&stream) != Z_OK)
+				return false;
+			std::unique_ptr<z_stream, int (*)(z_streamp)> guard(&stream, inflateEnd);
+
+			stream.next_out = reinterpret_cast<Bytef*>(out.data());
+			stream.avail_out = static_cast<uInt>(out.size());
+			bool finished = out.empty();
+			const bool ok = decodeChunked(
+				in, compressedSize, [&](const char* src, size_t srcSize, size_t& consumed) {
+					stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src));
+					stream.avail_in = static_cast<uInt>(srcSize);
+					const int ret = inflate(&stream, Z_NO_FLUSH);
+					consumed = srcSize - stream.avail_in;
+					if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+						return false;
+					finished = ret == Z_STREAM_END || stream.avail_out == 0;
+					return true;
+				},
+				finished);
+			return ok && stream.avail_out == 0;
+		}
+
+		bool decompressLz4Frame(std::ifstream& in, size_t compressedSize, std::string& out)
+		{
+			LZ4F_dctx* context = nullptr;
+			if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)))
+				return false;
+			std::unique_ptr<LZ4F_dctx, LZ4F_errorCode_t (*)(LZ4F_dctx*)> guard(context, LZ4F_freeDecompressionContext);
+
+			size_t produced = 0;
+			bool finished = out.empty();
+			const bool ok = decodeChunked(
+				in, compressedSize, [&](const char* src, size_t srcSize, size_t& consumed) {
+					size_t dstSize = out.size() - produced;
+					consumed = srcSize;
+					const size_t ret = LZ4F_decompress(context, out.data() + produced, &dstSize, src, &consumed, nullptr);
+					if (LZ4F_isError(ret))
+						return false;
+					produced += dstSize;
+					finished = ret == 0 || produced == out.size();
+					return true;
+				},
+				finished);
+			return ok && produced == out.size();
+		}
+	}  // namespace
+
+	bool BSAArchive::open(const std::filesystem::path& path, std::string& error)
+	{
+		m_path = path;
+		m_entries.clear();
+
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in.is_open()) {
+			error = "cannot open";
+			return false;
+		}
+		const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+		in.seekg(0);
+
+		std::vector<uint8_t> header(kHeaderSize);
+		if (!in.read(reinterpret_cast<char*>(header.data()), kHeaderSize)) {
+			error = "shorter than a BSA header";
+			return false;
+		}
+		TableCursor h(header);
+		char magic[4];
+		uint32_t folderRecordOffset = 0, archiveFlags = 0, folderCount = 0, fileCount = 0;
+		uint32_t totalFolderNameLength = 0, totalFileNameLength = 0;
+		h.read(magic);
+		h.read(m_version);
+		h.read(folderRecordOffset);
+		h.read(archiveFlags);
+		h.read(folderCount);
+		h.read(fileCount);
+		h.read(totalFolderNameLength);
+		h.read(totalFileNameLength);
+
+		if (std::memcmp(magic, kMagic, sizeof(magic)) != 0) {
+			error = "not a BSA archive (BA2 archives are Fallout 4's, and not read)";
+			return false;
+		}
+		if (m_version != kVersionSkyrimLE && m_version != kVersionSkyrimSE) {
+			error = "unsupported BSA version " + std::to_string(m_version) + " (expected 104 or 105)";
+			return false;
+		}
+		if ((archiveFlags & (kIncludeDirectoryNames | kIncludeFileNames)) != (kIncludeDirectoryNames | kIncludeFileNames)) {
+			error = "archive without folder or file names";
+			return false;
+		}
+		m_embeddedNames = (archiveFlags & kEmbedFileNames) != 0;
+		const bool compressedByDefault = (archiveFlags & kCompressedByDefault) != 0;
+
+		// Folder records, then per folder its name and file records, then the file names:
+		// read the whole directory in one go, after checking it fits in the file.
+		const size_t folderRecordSize = m_version == kVersionSkyrimSE ? 24 : 16;
+		const uint64_t directorySize = uint64_t(folderCount) * folderRecordSize + folderCount + totalFolderNameLength +
+		                               uint64_t(fileCount) * kFileRecordSize + totalFileNameLength;
+		if (folderRecordOffset != kHeaderSize || folderRecordOffset + directorySize > fileSize) {
+			error = "directory tables run past the end of the file";
+			return false;
+		}
+		std::vector<uint8_t> directory(static_cast<size_t>(directorySize));
+		if (!in.read(reinterpret_cast<char*>(directory.data()), static_cast<std::streamsize>(directory.size()))) {
+			error = "cannot read the directory tables";
+			return false;
+		}
+
+		TableCursor cursor(directory);
+		std::vector<uint32_t> folderFileCounts(folderCount);
+		for (auto& count : folderFileCounts) {
+			cursor.skip(8);  // name hash
+			cursor.read(count);
+			cursor.skip(folderRecordSize - 12);  // offset (and padding in 105)
+		}
+
+		struct PendingFile
+		{
+			std::string folder;
+			Entry entry;
+		};
+		std::vector<PendingFile> files;
+		files.reserve(fileCount);
+		for (uint32_t folderFiles : folderFileCounts) {
+			std::string folder;
+			if (!cursor.readPrefixedName(folder)) {
+				error = "folder name table cut short";
+				return false;
+			}
+			for (uint32_t i = 0; i < folderFiles; ++i) {
+				uint32_t size = 0, offset = 0;
+				if (!cursor.skip(8) || !cursor.read(size) || !cursor.read(offset)) {
+					error = "file record table cut short";
+					return false;
+				}
+				PendingFile file;
+				file.folder = folder;
+				file.entry.offset = offset;
+				file.entry.size = size & kSizeMask;
+				file.entry.compressed = compressedByDefault != ((size & kToggleCompression) != 0);
+				if (file.entry.offset + file.entry.size > fileSize) {
+					error = "file data runs past the end of the archive";
+					return false;
+				}
+				files.push_back(std::move(file));
+			}
+		}
+		if (files.size() != fileCount) {
+			error = "file count does not match the folder records";
+			return false;
+		}
+
+		m_entries.reserve(files.size());
+		std::string name;
+		for (auto& file : files) {
+			if (!cursor.readTerminatedName(name)) {
+				error = "file name table cut short";
+				m_entries.clear();
+				return false;
+			}
+			m_entries[NormalizePathForComparison(file.folder + "/" + name)] = file.entry;
+		}
+		return true;
+	}
+
+	const BSAArchive::Entry* BSAArchive::find(const std::string& normalizedPath) const
+	{
+		auto it = m_entries.find(normalizedPath);
+		return it == m_entries.end() ? nullptr : &it->second;
+	}
+
+	bool BSAArchive::read(const Entry& entry, std::string& out, size_t maxBytes) const
+	{
+		out.clear();
+		std::ifstream in(m_path, std::ios::binary);
+		if (!in.is_open())
+			return false;
+		in.seekg(static_cast<std::streamoff>(entry.offset));
+
+		size_t remaining = entry.size;
+		if (m_embeddedNames) {
+			uint8_t nameLength = 0;
+			if (remaining < 1 || !in.read(reinterpret_cast<char*>(&nameLength), 1) || remaining < 1u + nameLength)
+				return false;
+			in.seekg(nameLength, std::ios::cur);
+			remaining -= 1u + nameLength;
+		}
+
+		if (!entry.compressed) {
+			if (remaining > kMaxFileSize)
+				return false;
+			out.resize(std::min(remaining, maxBytes));
+			return static_cast<bool>(in.read(out.data(), static_cast<std::streamsize>(out.size())));
+		}
+
+		uint32_t originalSize = 0;
+		if (remaining < sizeof(originalSize) || !in.read(reinterpret_cast<char*>(&originalSize), sizeof(originalSize)))
+			return false;
+		remaining -= sizeof(originalSize);
+		if (originalSize > kMaxFileSize)
+			return false;
+
+		out.resize(std::min<size_t>(originalSize, maxBytes));
+		const bool ok = m_version == kVersionSkyrimSE ? decompressLz4Frame(in, remaining, out) : inflateZlib(in, remaining, out);
+		if (!ok)
+			out.clear();
+		return ok;
+	}
+}  // namespace hdt
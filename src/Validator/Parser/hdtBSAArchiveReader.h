@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace hdt
+{
+	/// Read-only Skyrim BSA archive: version 104 (Skyrim LE, zlib) and 105 (Skyrim SE, LZ4
+	/// frames). open() indexes the folder and file tables in one read; file data is read and
+	/// decompressed on demand, through a stream of its own per read, so reads from several
+	/// threads need no lock.
+	class BSAArchive
+	{
+	public:
+		struct Entry
+		{
+			uint64_t offset = 0;  // of the file data, from the start of the archive
+			uint32_t size = 0;    // stored size: embedded name, original size and data
+			bool compressed = false;
+		};
+
+		/// Index the archive at `path`. False, with the reason in `error`, when it is not a
+		/// BSA of a supported version, has no name tables, or its tables are cut short.
+		bool open(const std::filesystem::path& path, std::string& error);
+
+		const std::filesystem::path& path() const { return m_path; }
+		uint32_t version() const { return m_version; }
+
+		/// Files keyed by their path in the archive, as NormalizePathForComparison gives it
+		/// ("meshes/armor/foo.nif").
+		const std::unordered_map<std::string, Entry>& entries() const { return m_entries; }
+		const Entry* find(const std::string& normalizedPath) const;
+
+		/// Read `entry`, decompressed, into `out`: all of it, or its first `maxBytes` bytes
+		/// (compressed data is only inflated that far). False when the data is cut short,
+		/// does not decompress, or is larger than kMaxFileSize.
+		bool read(const Entry& entry, std::string& out, size_t maxBytes = SIZE_MAX) const;
+
+		static constexpr size_t kMaxFileSize = 256ull * 1024ull * 1024ull;
+
+	private:
+		std::filesystem::path m_path;
+		uint32_t m_version = 0;
+		bool m_embeddedNames = false;
+		std::unordered_map<std::string, Entry> m_entries;
+	};
+}  // namespace hdt
@@ -1,5 +1,6 @@
 #include "hdtXSDSchemaParser.h"
 
+#include <algorithm>
 #include <charconv>
 #include <string>
 #include <string_view>
@@ -439,7 +440,46 @@ namespace hdt
 		schema.knownElements.clear();
 		schema.allowedChildren = parseAllowedChildren(schemaNode, schema.knownElements);
 		parseAllTypeConstraints(schemaNode, schema.elementTextConstraints, schema.elementAttrConstraints);
+		AddRuntimeSchemaExtensions(schema);
 		return true;
 	}
 
+	/// Mirrors SkyrimSystemCreator: the parents, and the clamping of each value as a range.
+	void AddRuntimeSchemaExtensions(PhysicsSchema& schema)
+	{
+		TypeConstraint positive;
+		positive.base = TypeConstraint::Base::Float;
+		positive.hasMin = true;
+		positive.minInclusive = 0.0;
+		TypeConstraint fraction = positive;
+		fraction.hasMax = true;
+		fraction.maxInclusive = 1.0;
+
+		// An element the XSD already declares keeps its declaration.
+		auto add = [&](const std::string& parent, const std::string& tag, const TypeConstraint* text) {
+			const bool declared = schema.knownElements.count(tag) > 0;
+			schema.knownElements.insert(tag);
+			auto parentIt = schema.allowedChildren.find(parent);
+			if (parentIt != schema.allowedChildren.end())
+				parentIt->second.insert(tag);
+			if (text && !declared)
+				schema.elementTextConstraints.try_emplace(tag, *text);
+		};
+
+		for (const char* bone : { "bone", "bone-default" }) {
+			add(bone, "density", &positive);
+			add(bone, "air-drag", &positive);
+		}
+
+		add("system", "inertia-scale", nullptr);
+		schema.allowedChildren.try_emplace("inertia-scale", std::unordered_set<std::string>{ "linear", "angular" });
+		add("inertia-scale", "linear", &fraction);
+		add("inertia-scale", "angular", &fraction);
+
+		add("constraint-group", "shape-matching", nullptr);
+		schema.allowedChildren.try_emplace("shape-matching", std::unordered_set<std::string>{ "bone", "stiffness" });
+		add("shape-matching", "stiffness", &fraction);
+		schema.textChildren["shape-matching"].insert("bone");
+	}
+
 }  // namespace hdt
@@ -10,4 +10,8 @@ namespace hdt
 	// Returns true when parsing completes without throwing.
 	bool ParsePhysicsSchemaFromXSD(const pugi::xml_document& doc, PhysicsSchema& schema);
 
+	// Add the elements the runtime reads but an older hdtSMP64.xsd doesn't declare (<density>, <air-drag>,
+	// <inertia-scale>, <shape-matching>). What the loaded XSD declares is kept as it is.
+	void AddRuntimeSchemaExtensions(PhysicsSchema& schema);
+
 }  // namespace hdt
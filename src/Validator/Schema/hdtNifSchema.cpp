@@ -1,5 +1,7 @@
 #include "hdtNifSchema.h"
 
+#include "../Utils/hdtValidatorLog.h"
+
 #include <pugixml.hpp>
 
 #include <algorithm>
@@ -8,6 +10,7 @@
 #include <cstring>
 #include <fstream>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 
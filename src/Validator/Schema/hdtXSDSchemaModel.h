@@ -53,6 +53,9 @@ namespace hdt
 		std::unordered_map<std::string, TypeConstraint> elementTextConstraints;
 		// Per element: per-attribute type constraint on attribute values.
 		std::unordered_map<std::string, std::unordered_map<std::string, TypeConstraint>> elementAttrConstraints;
+		// Per parent: children holding a plain text value although their tag is declared elsewhere with another
+		// content (e.g. <bone> naming a bone inside <shape-matching>); their text is read and nothing else is checked.
+		std::unordered_map<std::string, std::unordered_set<std::string>> textChildren;
 		bool loaded = false;  // true only when the XSD was successfully parsed
 	};
 
@@ -0,0 +1,245 @@
+#include "hdtDataFileSystem.h"
+
+#include "../Parser/hdtBSAArchiveReader.h"
+#include "hdtConcurrencyUtils.h"
+#include "hdtStringUtils.h"
+#include "hdtValidatorLog.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace hdt
+{
+	namespace
+	{
+		namespace fs = std::filesystem;
+
+		struct MountedArchives
+		{
+			struct Packed
+			{
+				uint32_t archive = 0;  // index in archives
+				BSAArchive::Entry entry;
+			};
+
+			std::vector<BSAArchive> archives;
+			std::vector<std::string> names;
+			std::unordered_map<std::string, Packed> index;  // winning entry per normalized path below data/
+		};
+
+		// Swapped whole by Mount/Unmount; readers hold their own reference for the length
+		// of a read, so an unmount never pulls an archive from under a running read.
+		std::mutex g_mountMutex;
+		std::shared_ptr<const MountedArchives> g_mounted;
+
+		std::shared_ptr<const MountedArchives> mountedArchives()
+		{
+			std::lock_guard lock(g_mountMutex);
+			return g_mounted;
+		}
+
+		// The base game's archives first (Skyrim.ini's sResourceArchiveList; they belong to
+		// no plugin), then those of each plugin in load order, or every other one by name.
+		std::vector<fs::path> orderArchives(const fs::path& dataDir, const std::vector<std::string>& pluginLoadOrder)
+		{
+			std::map<std::string, fs::path> byName;
+			std::error_code ec;
+			for (const auto& entry : fs::directory_iterator(dataDir, ec)) {
+				if (!entry.is_regular_file(ec) || ec) {
+					ec.clear();
+					continue;
+				}
+				const std::string name = NormalizePathForComparison(PathToUtf8(entry.path().filename()));
+				if (name.ends_with(".bsa"))
+					byName.emplace(name, entry.path());
+			}
+
+			std::vector<fs::path> ordered;
+			auto take = [&](const std::string& name) {
+				auto it = byName.find(name);
+				if (it != byName.end()) {
+					ordered.push_back(it->second);
+					byName.erase(it);
+				}
+			};
+
+			for (auto it = byName.begin(); it != byName.end();) {
+				if (it->first.starts_with("skyrim - ")) {
+					ordered.push_back(it->second);
+					it = byName.erase(it);
+				} else {
+					++it;
+				}
+			}
+
+			if (pluginLoadOrder.empty()) {
+				for (const auto& [name, path] : byName)
+					ordered.push_back(path);
+				return ordered;
+			}
+			for (const auto& plugin : pluginLoadOrder) {
+				std::string stem = NormalizePathForComparison(plugin);
+				stem = stem.substr(0, stem.rfind('.'));
+				take(stem + ".bsa");
+				take(stem + " - textures.bsa");
+			}
+			return ordered;
+		}
+
+		// Key of `path` in the archives: below data/, normalized. Empty for a path that
+		// cannot be packed.
+		std::string packedKey(const std::string& path)
+		{
+			std::string key = NormalizePathForComparison(stripDataPrefix(path));
+			if (key.empty() || key.front() == '/' || key.find(':') != std::string::npos)
+				return {};
+			return key;
+		}
+
+		const MountedArchives::Packed* findPacked(const MountedArchives* mounted, const std::string& path)
+		{
+			if (!mounted)
+				return nullptr;
+			const std::string key = packedKey(path);
+			auto it = key.empty() ? mounted->index.end() : mounted->index.find(key);
+			return it == mounted->index.end() ? nullptr : &it->second;
+		}
+
+		bool looseFile(const std::string& path, std::string& resolved)
+		{
+			std::error_code ec;
+			const fs::path candidate = ResolvePathCase(path);
+			if (!fs::is_regular_file(candidate, ec) || ec)
+				return false;
+			resolved = PathToUtf8(candidate);
+			return true;
+		}
+	}  // namespace
+
+	DataArchiveMountResult MountDataArchives(const fs::path& dataDir, const std::vector<std::string>& pluginLoadOrder)
+	{
+		DataArchiveMountResult result;
+		const auto paths = orderArchives(dataDir, pluginLoadOrder);
+
+		std::vector<BSAArchive> archives(paths.size());
+		std::vector<std::string> errors(paths.size());
+		ParallelForChunks(paths.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				if (!archives[i].open(paths[i], errors[i]) && errors[i].empty())
+					errors[i] = "cannot be read";
+		});
+
+		auto mounted = std::make_shared<MountedArchives>();
+		for (size_t i = 0; i < paths.size(); ++i) {
+			const std::string name = PathToUtf8(paths[i].filename());
+			if (!errors[i].empty()) {
+				result.errors.push_back(name + ": " + errors[i]);
+				continue;
+			}
+			const auto archiveIndex = static_cast<uint32_t>(mounted->archives.size());
+			for (const auto& [key, entry] : archives[i].entries())
+				mounted->index.insert_or_assign(key, MountedArchives::Packed{ archiveIndex, entry });
+			mounted->archives.push_back(std::move(archives[i]));
+			mounted->names.push_back(name);
+		}
+
+		result.archives = mounted->names;
+		result.files = mounted->index.size();
+		logger::info("[Validator] Mounted {} archive(s) with {} packed file(s) from {}", result.archives.size(),
+			result.files, PathToUtf8(dataDir));
+
+		std::lock_guard lock(g_mountMutex);
+		g_mounted = std::move(mounted);
+		return result;
+	}
+
+	void UnmountDataArchives()
+	{
+		std::lock_guard lock(g_mountMutex);
+		g_mounted.reset();
+	}
+
+	DataFileLocation LocateDataFile(const std::string& path)
+	{
+		DataFileLocation location;
+		if (looseFile(path, location.path)) {
+			location.exists = true;
+			return location;
+		}
+
+		location.path = path;
+		const auto mounted = mountedArchives();
+		if (const auto* packed = findPacked(mounted.get(), path)) {
+			location.archive = mounted->names[packed->archive];
+			location.exists = true;
+		}
+		return location;
+	}
+
+	DataFileLocation ResolveDataFile(const std::string& rawPath)
+	{
+		if (rawPath.empty())
+			return {};
+
+		std::string path = rawPath;
+		std::replace(path.begin(), path.end(), '\\', '/');
+
+		DataFileLocation location;
+		if (looseFile(path, location.path) || looseFile("data/" + path, location.path)) {
+			location.exists = true;
+			return location;
+		}
+
+		location.path = PathToUtf8(ResolvePathCase("data/" + stripDataPrefix(path)));
+		const auto mounted = mountedArchives();
+		if (const auto* packed = findPacked(mounted.get(), path)) {
+			location.archive = mounted->names[packed->archive];
+			location.exists = true;
+		}
+		return location;
+	}
+
+	std::string ReadDataFile(const std::string& path, size_t maxBytes)
+	{
+		std::ifstream stream(ResolvePathCase(path), std::ios::binary | std::ios::ate);
+		if (stream.is_open()) {
+			const auto size = stream.tellg();
+			if (size < 0)
+				return {};
+			std::string bytes(std::min(static_cast<size_t>(size), maxBytes), '\0');
+			stream.seekg(0);
+			stream.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			bytes.resize(static_cast<size_t>(stream.gcount()));
+			return bytes;
+		}
+
+		return ReadPackedDataFile(path, maxBytes);
+	}
+
+	std::string ReadPackedDataFile(const std::string& path, size_t maxBytes)
+	{
+		const auto mounted = mountedArchives();
+		const auto* packed = findPacked(mounted.get(), path);
+		std::string bytes;
+		if (packed)
+			mounted->archives[packed->archive].read(packed->entry, bytes, maxBytes);
+		return bytes;
+	}
+
+	std::vector<std::string> ListPackedDataFiles(std::string_view extension)
+	{
+		std::vector<std::string> paths;
+		const auto mounted = mountedArchives();
+		if (!mounted)
+			return paths;
+		for (const auto& [key, packed] : mounted->index)
+			if (key.ends_with(extension))
+				paths.push_back("data/" + key);
+		std::sort(paths.begin(), paths.end());
+		return paths;
+	}
+}  // namespace hdt
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The data directory as the game sees it: loose files over the contents of the BSA
+// archives, the archives in the order the game loads them. Every validator reads its
+// NIFs and XMLs through here, so packed assets are validated like loose ones. The
+// archives are mounted for the length of one validation run (DataArchiveMount); with
+// none mounted, this is plain file access. Paths are the pipeline's, relative to the
+// game directory ("data/meshes/foo.nif").
+namespace hdt
+{
+	struct DataFileLocation
+	{
+		std::string path;     // the file's path, "data/..." for a packed one
+		std::string archive;  // file name of the archive it is read from; empty when loose
+		bool exists = false;
+	};
+
+	struct DataArchiveMountResult
+	{
+		std::vector<std::string> archives;  // mounted, in load order
+		std::vector<std::string> errors;    // one line per archive that could not be read
+		size_t files = 0;                   // distinct packed files after precedence
+	};
+
+	/// Mount the BSA archives of `dataDir`, replacing any mounted before. With a plugin
+	/// load order, the archives of those plugins ("<plugin>.bsa", "<plugin> - Textures.bsa")
+	/// load after the base game's ("Skyrim - *.bsa") in that order, and others not at all,
+	/// as in game; without one (offline, unless given a plugins.txt), every archive loads,
+	/// the base game's first and the rest by name. A file in a later archive wins.
+	DataArchiveMountResult MountDataArchives(const std::filesystem::path& dataDir,
+		const std::vector<std::string>& pluginLoadOrder);
+	void UnmountDataArchives();
+
+	/// Mounts in the constructor and unmounts in the destructor, for one run.
+	class DataArchiveMount
+	{
+	public:
+		DataArchiveMount(const std::filesystem::path& dataDir, const std::vector<std::string>& pluginLoadOrder) :
+			m_result(MountDataArchives(dataDir, pluginLoadOrder))
+		{}
+		~DataArchiveMount() { UnmountDataArchives(); }
+		DataArchiveMount(const DataArchiveMount&) = delete;
+		DataArchiveMount& operator=(const DataArchiveMount&) = delete;
+
+		const DataArchiveMountResult& result() const { return m_result; }
+
+	private:
+		DataArchiveMountResult m_result;
+	};
+
+	/// Find `path`: loose on disk (case-insensitively off Windows), else in the archives.
+	DataFileLocation LocateDataFile(const std::string& path);
+
+	/// Resolve a path as written in a NIF or defaultBBPs.xml (relative to data/, or to the
+	/// game directory): loose as is, loose below data/, then packed.
+	DataFileLocation ResolveDataFile(const std::string& rawPath);
+
+	/// Contents of `path`, loose or packed; its first `maxBytes` bytes only when given.
+	/// Empty when it is found nowhere or does not read.
+	std::string ReadDataFile(const std::string& path, size_t maxBytes = SIZE_MAX);
+
+	/// ReadDataFile from the archives alone, for a path known not to be loose (the NIF
+	/// scan's packed paths), saving the loose lookup.
+	std::string ReadPackedDataFile(const std::string& path, size_t maxBytes = SIZE_MAX);
+
+	/// Every packed file with `extension` (".nif", lower case) that a later archive does not
+	/// override, as "data/..." paths. Loose files may still override them.
+	std::vector<std::string> ListPackedDataFiles(std::string_view extension);
+}  // namespace hdt
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstring>
 #include <string_view>
+#include <unordered_set>
 
 namespace hdt
 {
@@ -35,6 +36,7 @@ namespace hdt
 		constexpr uint16_t kVertexAttrTangent = 1u << 4;
 		constexpr uint16_t kVertexAttrColor = 1u << 5;
 		constexpr uint16_t kVertexAttrSkinned = 1u << 6;
+		constexpr uint16_t kVertexAttrFullPrecision = 1u << 10;
 
 		// ── Block type name constants ──────────────────────────────────────────────
 
@@ -58,6 +60,18 @@ namespace hdt
 			return type == kTypeBSTriShape || type == kTypeBSDynamicTriShape;
 		}
 
+		// NiNode and the block types derived from it that show up in Skyrim meshes and
+		// skeletons; all of them start with the NiNode children list.
+		inline bool isNodeType(std::string_view type)
+		{
+			static const std::unordered_set<std::string_view> types = {
+				"NiNode", "BSFadeNode", "BSLeafAnimNode", "BSTreeNode", "BSMultiBoundNode", "BSOrderedNode",
+				"BSValueNode", "BSRangeNode", "BSBlastNode", "BSDamageStage", "BSDebrisNode", "BSMasterParticleSystem",
+				"NiBillboardNode", "NiSwitchNode", "NiLODNode", "BSFaceGenNiNode", "NiBone"
+			};
+			return types.contains(type);
+		}
+
 		// Returns true if `needle` appears anywhere in the byte buffer.
 		inline bool ContainsAsciiSequence(const uint8_t* data, size_t size, const char* needle)
 		{
@@ -0,0 +1,289 @@
+#include "hdtNIFSkinReader.h"
+
+#include "../Improvers/hdtNIFBinaryIO.h"
+#include "hdtNIFBinaryUtils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <unordered_set>
+
+namespace hdt
+{
+	namespace
+	{
+		float halfToFloat(uint16_t h)
+		{
+			const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+			uint32_t exponent = (h >> 10) & 0x1Fu;
+			uint32_t mantissa = h & 0x3FFu;
+
+			uint32_t bits;
+			if (exponent == 0) {
+				if (mantissa == 0)
+					bits = sign;
+				else {
+					// Subnormal: normalise it into a float exponent.
+					exponent = 113;
+					while (!(mantissa & 0x400u)) {
+						mantissa <<= 1;
+						--exponent;
+					}
+					bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+				}
+			} else if (exponent == 31)
+				bits = sign | 0x7F800000u | (mantissa << 13);
+			else
+				bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+			float out;
+			std::memcpy(&out, &bits, 4);
+			return out;
+		}
+
+		// BSTriShape up to its skin reference: NiAVObject (name, extra data, controller,
+		// flags, transform, collision object), then the bounding sphere.
+		std::optional<int32_t> readSkinInstanceRef(const std::vector<uint8_t>& block)
+		{
+			try {
+				NifReader r(block);
+				r.readU32();
+				const uint32_t numExtra = r.readU32();
+				r.skip(static_cast<size_t>(numExtra) * 4);
+				r.readU32();
+				r.readU32();
+				r.skip(12 + 36 + 4);
+				r.readU32();
+				r.skip(16);
+				return static_cast<int32_t>(r.readU32());
+			} catch (...) {
+				return std::nullopt;
+			}
+		}
+
+		// NiNode: NiAVObject as for the shapes above, then the children refs.
+		std::vector<int32_t> readNodeChildren(const std::vector<uint8_t>& block)
+		{
+			std::vector<int32_t> children;
+			try {
+				NifReader r(block);
+				r.readU32();
+				const uint32_t numExtra = r.readU32();
+				r.skip(static_cast<size_t>(numExtra) * 4);
+				r.readU32();
+				r.readU32();
+				r.skip(12 + 36 + 4);
+				r.readU32();
+				const uint32_t numChildren = r.readU32();
+				if (!r.canRead(static_cast<size_t>(numChildren) * 4))
+					return {};
+				children.reserve(numChildren);
+				for (uint32_t i = 0; i < numChildren; ++i)
+					children.push_back(static_cast<int32_t>(r.readU32()));
+			} catch (...) {
+				return {};
+			}
+			return children;
+		}
+
+		struct SkinInstanceView
+		{
+			int32_t partition = -1;
+			std::vector<int32_t> bones;
+		};
+
+		std::optional<SkinInstanceView> readSkinInstance(const std::vector<uint8_t>& block)
+		{
+			try {
+				NifReader r(block);
+				SkinInstanceView out;
+				r.readU32();  // data
+				out.partition = static_cast<int32_t>(r.readU32());
+				r.readU32();  // skeleton root
+				const uint32_t numBones = r.readU32();
+				if (!r.canRead(static_cast<size_t>(numBones) * 4))
+					return std::nullopt;
+				out.bones.reserve(numBones);
+				for (uint32_t i = 0; i < numBones; ++i)
+					out.bones.push_back(static_cast<int32_t>(r.readU32()));
+				return out;
+			} catch (...) {
+				return std::nullopt;
+			}
+		}
+
+		// SSE NiSkinPartition: the shared vertex buffer, then every partition with its
+		// triangles (strips are not used by SSE meshes and are refused).
+		bool readSkinPartition(const std::vector<uint8_t>& block, size_t numBones, NifSkinnedShape& shape)
+		{
+			try {
+				NifReader r(block);
+				const uint32_t numPartitions = r.readU32();
+				const uint32_t dataSize = r.readU32();
+				const uint32_t vertexSize = r.readU32();
+				const uint64_t vertexDesc = r.readU64();
+				const uint16_t attributes = static_cast<uint16_t>((vertexDesc >> 44) & 0x0FFFu);
+				const uint32_t skinOffset = static_cast<uint32_t>((vertexDesc >> 28) & 0x0Fu) * 4u;
+				const bool fullPrecision = (attributes & nif::kVertexAttrFullPrecision) != 0;
+				const uint32_t positionSize = fullPrecision ? 12u : 6u;
+				if (!(attributes & nif::kVertexAttrSkinned) || vertexSize == 0 || dataSize % vertexSize != 0 ||
+					skinOffset + 12 > vertexSize || positionSize > vertexSize || !r.canRead(dataSize))
+					return false;
+
+				const size_t numVertices = dataSize / vertexSize;
+				const size_t dataStart = r.pos();
+				shape.vertices.resize(numVertices);
+				for (size_t v = 0; v < numVertices; ++v) {
+					const uint8_t* data = block.data() + dataStart + v * vertexSize;
+					const uint8_t* skin = data + skinOffset;
+					auto& vertex = shape.vertices[v];
+					for (size_t k = 0; k < 3; ++k) {
+						if (fullPrecision)
+							std::memcpy(&vertex.position[k], data + k * 4, 4);
+						else {
+							uint16_t half = 0;
+							std::memcpy(&half, data + k * 2, 2);
+							vertex.position[k] = halfToFloat(half);
+						}
+					}
+					for (size_t k = 0; k < 4; ++k) {
+						uint16_t half = 0;
+						std::memcpy(&half, skin + k * 2, 2);
+						vertex.weights[k] = halfToFloat(half);
+						vertex.bones[k] = skin[8 + k];
+						vertex.storedWeightSum += vertex.weights[k];
+						if (vertex.bones[k] >= numBones) {
+							vertex.unlistedBone = vertex.unlistedBone || vertex.weights[k] > 0;
+							vertex.weights[k] = 0;
+						}
+					}
+					// SkinnedMeshBody sorts the weights of its vertices, the keys of the colliders follow that order.
+					for (size_t i = 0; i < 4; ++i)
+						for (size_t j = 0; j < 3; ++j)
+							if (vertex.weights[j] < vertex.weights[j + 1]) {
+								std::swap(vertex.weights[j], vertex.weights[j + 1]);
+								std::swap(vertex.bones[j], vertex.bones[j + 1]);
+							}
+				}
+				r.skip(dataSize);
+
+				for (uint32_t p = 0; p < numPartitions; ++p) {
+					const uint16_t partVertices = r.readU16();
+					const uint16_t partTriangles = r.readU16();
+					const uint16_t partBones = r.readU16();
+					const uint16_t numStrips = r.readU16();
+					const uint16_t bonesPerVertex = r.readU16();
+					if (numStrips != 0)
+						return false;
+					shape.partitions.push_back({ partVertices, partTriangles, partBones, bonesPerVertex });
+					r.skip(static_cast<size_t>(partBones) * 2);
+
+					std::vector<uint16_t> vertexMap;
+					if (r.readU8()) {
+						vertexMap.reserve(partVertices);
+						for (uint16_t i = 0; i < partVertices; ++i)
+							vertexMap.push_back(r.readU16());
+					}
+					if (r.readU8())
+						r.skip(static_cast<size_t>(partVertices) * bonesPerVertex * 4);
+					if (r.readU8()) {
+						for (uint16_t i = 0; i < partTriangles; ++i) {
+							std::array<uint16_t, 3> tri{ r.readU16(), r.readU16(), r.readU16() };
+							bool valid = true;
+							for (auto& index : tri) {
+								if (!vertexMap.empty())
+									index = index < vertexMap.size() ? vertexMap[index] : static_cast<uint16_t>(0xFFFF);
+								valid = valid && index < numVertices;
+							}
+							if (valid)
+								shape.triangles.push_back(tri);
+						}
+					}
+					if (r.readU8())
+						r.skip(static_cast<size_t>(partVertices) * bonesPerVertex);
+					r.readU8();  // LOD level
+					r.readU8();  // global vertex buffer
+					r.readU64();
+					r.skip(static_cast<size_t>(partTriangles) * nif::kTriangleByteSize);
+				}
+				return true;
+			} catch (...) {
+				return false;
+			}
+		}
+	}  // namespace
+
+	std::vector<NifSkinnedShape> ReadNifSkinnedShapes(const ParsedNif& parsed)
+	{
+		std::vector<NifSkinnedShape> out;
+		if (parsed.bsVersion != nif::kSSEBsVersion)
+			return out;
+
+		const int32_t numBlocks = static_cast<int32_t>(parsed.blocks.size());
+		for (int32_t i = 0; i < numBlocks; ++i) {
+			auto type = blockTypeOf(parsed, i);
+			if (!type || !nif::isSupportedSSETriShapeType(*type))
+				continue;
+
+			auto skinRef = readSkinInstanceRef(parsed.blocks[static_cast<size_t>(i)]);
+			auto skinType = skinRef ? blockTypeOf(parsed, *skinRef) : std::nullopt;
+			if (!skinType || (*skinType != nif::kTypeNiSkinInstance && *skinType != nif::kTypeBSDismemberSkinInstance))
+				continue;
+
+			auto skin = readSkinInstance(parsed.blocks[static_cast<size_t>(*skinRef)]);
+			auto partitionType = skin ? blockTypeOf(parsed, skin->partition) : std::nullopt;
+			if (!partitionType || *partitionType != nif::kTypeNiSkinPartition)
+				continue;
+
+			NifSkinnedShape shape;
+			shape.blockIndex = i;
+			shape.name = blockNameOf(parsed, i);
+			shape.shapeType = *type;
+			shape.boneNames.reserve(skin->bones.size());
+			for (int32_t bone : skin->bones)
+				shape.boneNames.push_back(blockNameOf(parsed, bone));
+
+			if (!readSkinPartition(parsed.blocks[static_cast<size_t>(skin->partition)], shape.boneNames.size(), shape))
+				continue;
+
+			out.push_back(std::move(shape));
+		}
+		return out;
+	}
+
+	std::vector<std::string> CollectNifNodeNames(const ParsedNif& parsed, bool includeRoot)
+	{
+		std::vector<std::string> names;
+		if (parsed.bsVersion != nif::kSSEBsVersion || parsed.blocks.empty())
+			return names;
+
+		const int32_t root = parsed.footerRoots.empty() ? 0 : parsed.footerRoots.front();
+		auto rootType = blockTypeOf(parsed, root);
+		if (!rootType || !nif::isNodeType(*rootType))
+			return names;
+		if (includeRoot) {
+			auto rootName = blockNameOf(parsed, root);
+			if (!rootName.empty())
+				names.push_back(std::move(rootName));
+		}
+
+		std::unordered_set<int32_t> visited{ root };
+		std::vector<int32_t> stack{ root };
+		while (!stack.empty()) {
+			const int32_t node = stack.back();
+			stack.pop_back();
+			for (int32_t child : readNodeChildren(parsed.blocks[static_cast<size_t>(node)])) {
+				auto type = blockTypeOf(parsed, child);
+				if (!type || !nif::isNodeType(*type) || !visited.insert(child).second)
+					continue;
+				auto name = blockNameOf(parsed, child);
+				if (name == "BSFaceGenNiNodeSkinned")
+					continue;
+				if (!name.empty())
+					names.push_back(std::move(name));
+				stack.push_back(child);
+			}
+		}
+		return names;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hdt
+{
+	struct ParsedNif;
+
+	struct NifSkinVertex
+	{
+		std::array<float, 4> weights{};   // sorted by decreasing weight, as SkinnedMeshBody's vertices are
+		std::array<uint8_t, 4> bones{};   // indices into NifSkinnedShape::boneNames
+		std::array<float, 3> position{};
+		float storedWeightSum = 0;        // the four weights as stored, before any is dropped
+		bool unlistedBone = false;        // a stored weight went to a bone past boneNames; it reads as 0 above
+	};
+
+	// One partition of a NiSkinPartition, as counted in its header.
+	struct NifSkinPartitionLayout
+	{
+		uint16_t vertices = 0;
+		uint16_t triangles = 0;
+		uint16_t bones = 0;
+		uint16_t bonesPerVertex = 0;
+	};
+
+	// One skinned shape the way SkyrimSystemCreator::generateMeshBody sees it: the bones
+	// of its NiSkinInstance, and the weights of the shared vertex buffer of its
+	// NiSkinPartition. Triangles index the vertices, through the vertex maps of the
+	// partitions.
+	struct NifSkinnedShape
+	{
+		int blockIndex = -1;
+		std::string name;
+		std::string shapeType;
+		std::vector<std::string> boneNames;
+		std::vector<NifSkinVertex> vertices;
+		std::vector<std::array<uint16_t, 3>> triangles;
+		std::vector<NifSkinPartitionLayout> partitions;
+	};
+
+	// Reads every skinned BSTriShape / BSDynamicTriShape of an SSE NIF. Shapes whose skin
+	// blocks don't parse are left out: reporting them is the structure validator's job.
+	std::vector<NifSkinnedShape> ReadNifSkinnedShapes(const ParsedNif& parsed);
+
+	// Names of the NiNodes reachable from the root of an SSE NIF, the way
+	// ActorManager::Skeleton::doSkeletonMerge walks them: through unnamed nodes, and not
+	// into BSFaceGenNiNodeSkinned. The root's own name is included on request; the merge
+	// only takes its children.
+	std::vector<std::string> CollectNifNodeNames(const ParsedNif& parsed, bool includeRoot);
+}
@@ -0,0 +1,64 @@
+#include "hdtParsedNifStore.h"
+
+#include "../Improvers/hdtNIFBinaryIO.h"
+#include "hdtStringUtils.h"
+
+namespace hdt
+{
+	bool ParsedNifStore::offer(const std::string& nifPath, std::shared_ptr<const ParsedNif> parsed)
+	{
+		if (!parsed)
+			return false;
+		const size_t bytes = EstimateBytes(*parsed);
+		std::string key = NormalizePathForComparison(nifPath);
+
+		std::lock_guard lock(m_mutex);
+		if (m_bytes + bytes > m_budget || m_parsed.contains(key)) {
+			++m_refused;
+			return false;
+		}
+		m_parsed.emplace(std::move(key), std::move(parsed));
+		m_bytes += bytes;
+		return true;
+	}
+
+	std::shared_ptr<const ParsedNif> ParsedNifStore::find(const std::string& nifPath) const
+	{
+		const std::string key = NormalizePathForComparison(nifPath);
+		std::lock_guard lock(m_mutex);
+		auto it = m_parsed.find(key);
+		return it == m_parsed.end() ? nullptr : it->second;
+	}
+
+	size_t ParsedNifStore::size() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_parsed.size();
+	}
+
+	size_t ParsedNifStore::bytes() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_bytes;
+	}
+
+	size_t ParsedNifStore::refused() const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_refused;
+	}
+
+	size_t ParsedNifStore::EstimateBytes(const ParsedNif& parsed)
+	{
+		size_t bytes = sizeof(ParsedNif) + parsed.headerPrefix.capacity() + parsed.bsUnknownData.capacity() +
+		               parsed.blockTypeIndex.capacity() * sizeof(uint16_t) + parsed.groups.capacity() * sizeof(uint32_t) +
+		               parsed.footerRoots.capacity() * sizeof(int32_t);
+		for (const auto& block : parsed.blocks)
+			bytes += sizeof(block) + block.capacity();
+		for (const auto& type : parsed.blockTypes)
+			bytes += sizeof(type) + type.capacity();
+		for (const auto& string : parsed.strings)
+			bytes += sizeof(string) + string.capacity();
+		return bytes;
+	}
+}
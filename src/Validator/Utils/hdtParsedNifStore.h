@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace hdt
+{
+	struct ParsedNif;
+
+	// The parses of the NIF scan (Phase 2), kept for the phases after it so that they don't
+	// read and parse the same physics NIFs again. Bounded by a memory budget: a parse that
+	// would take the store past it is not kept, and its phases load it again as before.
+	// offer() and find() may be called from several threads.
+	class ParsedNifStore
+	{
+	public:
+		explicit ParsedNifStore(size_t budgetBytes) :
+			m_budget(budgetBytes)
+		{}
+
+		/// Keep `parsed` under `nifPath`; false, and nothing kept, when over the budget.
+		bool offer(const std::string& nifPath, std::shared_ptr<const ParsedNif> parsed);
+
+		/// The parse kept for `nifPath`, or null.
+		std::shared_ptr<const ParsedNif> find(const std::string& nifPath) const;
+
+		size_t size() const;
+		size_t bytes() const;
+		size_t refused() const;
+
+		/// Rough heap footprint of a parse: its blocks, strings and tables.
+		static size_t EstimateBytes(const ParsedNif& parsed);
+
+	private:
+		mutable std::mutex m_mutex;
+		std::unordered_map<std::string, std::shared_ptr<const ParsedNif>> m_parsed;  // by normalized path
+		size_t m_budget = 0;
+		size_t m_bytes = 0;
+		size_t m_refused = 0;
+	};
+}
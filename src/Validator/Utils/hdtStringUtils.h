@@ -63,6 +63,43 @@ namespace hdt
 		return path;
 	}
 
+	// Game paths are case-insensitive and written in any case ("Data/SKSE/Plugins" and
+	// "data/skse/plugins" alike). On a case-sensitive filesystem (the standalone validator
+	// on Linux) match each component that does not exist as written against its directory
+	// regardless of case. Returns `path` unchanged when it exists or nothing matches; a
+	// no-op on Windows.
+	inline std::filesystem::path ResolvePathCase(const std::filesystem::path& path)
+	{
+#ifdef _WIN32
+		return path;
+#else
+		namespace fs = std::filesystem;
+		std::error_code ec;
+		if (path.empty() || fs::exists(path, ec))
+			return path;
+
+		fs::path resolved = path.root_path();
+		for (const auto& part : path.relative_path()) {
+			fs::path next = resolved / part;
+			if (!fs::exists(next, ec)) {
+				const std::string wanted = NormalizePathForComparison(PathToUtf8(part));
+				bool found = false;
+				for (const auto& entry : fs::directory_iterator(resolved.empty() ? fs::path(".") : resolved, ec)) {
+					if (NormalizePathForComparison(PathToUtf8(entry.path().filename())) == wanted) {
+						next = resolved / entry.path().filename();
+						found = true;
+						break;
+					}
+				}
+				if (!found)
+					return path;
+			}
+			resolved = std::move(next);
+		}
+		return resolved;
+#endif
+	}
+
 	// Resolve a raw XML path to a filesystem location, trying the path as-is first, then with a
 	// "data/" prefix. Returns the resolved path and whether it exists on disk.
 	inline std::pair<std::string, bool> ResolveXMLPath(const std::string& rawPath)
@@ -74,9 +111,9 @@ namespace hdt
 		std::replace(xmlPath.begin(), xmlPath.end(), '\\', '/');
 
 		std::error_code ec;
-		std::filesystem::path xmlFsPath = xmlPath;
+		std::filesystem::path xmlFsPath = ResolvePathCase(xmlPath);
 		if (!std::filesystem::exists(xmlFsPath, ec))
-			xmlFsPath = "data/" + xmlPath;
+			xmlFsPath = ResolvePathCase("data/" + xmlPath);
 
 		return { PathToUtf8(xmlFsPath), std::filesystem::exists(xmlFsPath, ec) };
 	}
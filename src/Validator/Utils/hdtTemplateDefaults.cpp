@@ -457,6 +457,9 @@ namespace hdt
 			}
 
 			defaults[Family::Bone].insert_or_assign("centerOfMassTransform", makeTransformDefaultKey());
+			// Read by the runtime, absent from an older .sch: 0 keeps the mass as written and no air drag.
+			defaults[Family::Bone].try_emplace("density", "0");
+			defaults[Family::Bone].try_emplace("air-drag", "0");
 			// Runtime default is FrameInB; frameInA is an explicit body-A-space choice and is only
 			// tracked for redundancy when it is repeated in template inheritance.
 			defaults[Family::Generic].insert_or_assign("__frameSpec", "B:" + makeTransformDefaultKey());
@@ -961,6 +964,63 @@ namespace hdt
 			return out;
 		}
 
+		// Walk the top-level nodes, and the members of each constraint-group, in document
+		// order the way SkyrimSystemCreator reads them: a default node updates its family's
+		// templates for everything after it (also from inside a group), an instance is
+		// resolved against the templates as they stand at that point.
+		static void resolveNodes(
+			const pugi::xml_node& parent,
+			std::unordered_map<Family, TemplateMap>& familyTemplates,
+			const std::string* sourceBytes,
+			ResolvedPhysicsDefinitions& out)
+		{
+			for (auto node = parent.first_child(); node; node = node.next_sibling()) {
+				if (node.type() != pugi::node_element)
+					continue;
+
+				const std::string localName = std::string(XmlLocalName(node.name()));
+				if (localName == "constraint-group") {
+					resolveNodes(node, familyTemplates, sourceBytes, out);
+					continue;
+				}
+
+				const Family family = familyForNode(localName);
+				if (family == Family::None)
+					continue;
+
+				const bool isDefault = isDefaultNodeName(localName);
+				FieldMap effective = computeNodeEffectiveFields(node, family, isDefault, familyTemplates[family]);
+
+				if (isDefault) {
+					const std::string templateName = TrimAsciiWhitespace(node.attribute("name").as_string());
+					familyTemplates[family][templateName] = std::move(effective);
+					continue;
+				}
+
+				ResolvedPhysicsNode resolved;
+				resolved.family = family;
+				resolved.location = BuildNodeLocationPath(node);
+				resolved.name = TrimAsciiWhitespace(node.attribute("name").as_string());
+				resolved.bodyA = TrimAsciiWhitespace(node.attribute("bodyA").as_string());
+				resolved.bodyB = TrimAsciiWhitespace(node.attribute("bodyB").as_string());
+				if (sourceBytes)
+					resolved.line = OffsetToLineNumber(*sourceBytes, node.offset_debug());
+				resolved.fields = std::move(effective);
+				out.nodes.push_back(std::move(resolved));
+			}
+		}
+
+		static bool parseCanonicalFloat(const std::string& text, float& out)
+		{
+			try {
+				size_t used = 0;
+				out = std::stof(text, &used);
+				return used > 0;
+			} catch (...) {
+				return false;
+			}
+		}
+
 	}  // anonymous namespace
 
 	// ── Public API ────────────────────────────────────────────────────────────
@@ -1020,4 +1080,65 @@ namespace hdt
 		return collectRedundantBoneDeclarations(doc, sourceBytes);
 	}
 
+	ResolvedPhysicsDefinitions ResolvePhysicsDefinitions(
+		const pugi::xml_document& doc,
+		const std::string* sourceBytes)
+	{
+		ResolvedPhysicsDefinitions out;
+		out.defaultBone.family = Family::Bone;
+
+		const auto baseDefaults = makeBaseDefaults();
+		std::unordered_map<Family, TemplateMap> familyTemplates;
+		for (const auto& [family, fields] : baseDefaults)
+			familyTemplates[family][""] = fields;
+
+		auto sysNode = findSystemNode(doc);
+		if (!sysNode)
+			return out;
+
+		resolveNodes(sysNode, familyTemplates, sourceBytes, out);
+		out.defaultBone.fields = getEffectiveTemplate(familyTemplates[Family::Bone], "");
+		return out;
+	}
+
+	float ResolvedPhysicsNode::number(const std::string& field, float fallback) const
+	{
+		auto it = fields.find(field);
+		float value = 0;
+		if (it == fields.end() || !parseCanonicalFloat(it->second, value))
+			return fallback;
+		return value;
+	}
+
+	bool ResolvedPhysicsNode::flag(const std::string& field, bool fallback) const
+	{
+		auto it = fields.find(field);
+		if (it == fields.end())
+			return fallback;
+		if (it->second == "true")
+			return true;
+		if (it->second == "false")
+			return false;
+		return fallback;
+	}
+
+	std::array<float, 3> ResolvedPhysicsNode::vector3(const std::string& field, const std::array<float, 3>& fallback) const
+	{
+		auto it = fields.find(field);
+		if (it == fields.end())
+			return fallback;
+
+		std::array<float, 3> value{};
+		size_t start = 0;
+		for (size_t i = 0; i < 3; ++i) {
+			const size_t comma = it->second.find(',', start);
+			if ((comma == std::string::npos) != (i == 2))
+				return fallback;
+			if (!parseCanonicalFloat(it->second.substr(start, comma - start), value[i]))
+				return fallback;
+			start = comma + 1;
+		}
+		return value;
+	}
+
 }  // namespace hdt
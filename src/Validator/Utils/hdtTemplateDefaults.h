@@ -1,7 +1,10 @@
 #pragma once
 
+#include "hdtValidatorFamily.h"
+
 #include <pugixml.hpp>
 
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -60,4 +63,38 @@ namespace hdt
 		const pugi::xml_document& doc,
 		const std::string* sourceBytes = nullptr);
 
+	// One bone, shape or constraint of a physics XML with its template applied: the
+	// same effective settings the runtime builds it with. Field values are in the
+	// canonical text form of the redundancy analysis ("0.5", "1,0,0", "true"); a
+	// weight-threshold is keyed "weight-threshold@<bone>". A field absent from the map
+	// was neither written nor known from the .sch defaults — the accessors then return
+	// the fallback, which callers set to the runtime default.
+	struct ResolvedPhysicsNode
+	{
+		Family family = Family::None;
+		std::string location;  // positional path, e.g. /system[1]/constraint-group[1]/generic-constraint[2]
+		std::string name;      // name attribute of a bone or shape
+		std::string bodyA;     // constraint endpoints, as written
+		std::string bodyB;
+		int line = 0;
+		std::unordered_map<std::string, std::string> fields;
+
+		float number(const std::string& field, float fallback) const;
+		bool flag(const std::string& field, bool fallback) const;
+		std::array<float, 3> vector3(const std::string& field, const std::array<float, 3>& fallback) const;
+	};
+
+	struct ResolvedPhysicsDefinitions
+	{
+		std::vector<ResolvedPhysicsNode> nodes;  // document order, constraint-group members included
+		ResolvedPhysicsNode defaultBone;         // the unnamed bone-default at the end of the file, for auto-created bones
+	};
+
+	// Resolve every bone, shape and constraint of one physics XML document through the
+	// template inheritance, with the same effective-default machinery as the redundancy
+	// analysis. When sourceBytes is provided, line numbers are computed from offsets.
+	ResolvedPhysicsDefinitions ResolvePhysicsDefinitions(
+		const pugi::xml_document& doc,
+		const std::string* sourceBytes = nullptr);
+
 }  // namespace hdt
@@ -0,0 +1,10 @@
+#pragma once
+
+// The Validator logs through `logger`: SKSE's log (PCH.h) in the plugin, and spdlog's
+// default logger in the standalone command-line build, which has no CommonLibSSE.
+// Only the level functions are portable; logger::log_directory() is the plugin's.
+#ifdef HDT_VALIDATOR_STANDALONE
+#	include <spdlog/spdlog.h>
+
+namespace logger = spdlog;
+#endif
@@ -0,0 +1,153 @@
+#include "hdtCollisionMeshAudit.h"
+
+#include "../Improvers/hdtNIFBinaryIO.h"
+#include "../Utils/hdtDataFileSystem.h"
+#include "../Utils/hdtNIFSkinReader.h"
+#include "../Utils/hdtTemplateDefaults.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace hdt
+{
+	namespace
+	{
+		constexpr float kWeightSumTolerance = 0.01f;  // half-float weights round to about 1e-3
+		constexpr float kMaxSliverRatio = 25.0f;       // longest edge over the height on it; 1.15 for an equilateral
+		constexpr float kDegenerateRatio = 1e6f;
+
+		using Vec3 = std::array<float, 3>;
+
+		Vec3 sub(const Vec3& a, const Vec3& b) { return { a[0] - b[0], a[1] - b[1], a[2] - b[2] }; }
+		float dot(const Vec3& a, const Vec3& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+		Vec3 cross(const Vec3& a, const Vec3& b)
+		{
+			return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+		}
+
+		struct PositionHash
+		{
+			size_t operator()(const Vec3& p) const
+			{
+				size_t h = 0;
+				for (float c : p) {
+					uint32_t bits = 0;
+					std::memcpy(&bits, &c, 4);
+					h = h * 31 + bits;
+				}
+				return h;
+			}
+		};
+
+		bool shareBone(const NifSkinVertex& a, const NifSkinVertex& b)
+		{
+			for (size_t i = 0; i < 4; ++i) {
+				if (a.weights[i] < FLT_EPSILON)
+					continue;
+				for (size_t j = 0; j < 4; ++j)
+					if (b.weights[j] >= FLT_EPSILON && a.bones[i] == b.bones[j])
+						return true;
+			}
+			return false;
+		}
+
+		bool weighted(const NifSkinVertex& v) { return v.weights[0] >= FLT_EPSILON; }
+
+		void auditVertices(const NifSkinnedShape& shape, CollisionMeshAudit& audit)
+		{
+			std::unordered_set<Vec3, PositionHash> seen;
+			seen.reserve(shape.vertices.size());
+			for (const auto& vertex : shape.vertices) {
+				if (!seen.insert(vertex.position).second)
+					++audit.duplicateVertices;
+				if (std::abs(vertex.storedWeightSum - 1) > kWeightSumTolerance)
+					++audit.unnormalizedVertices;
+				if (vertex.unlistedBone)
+					++audit.unlistedBoneVertices;
+			}
+		}
+
+		void auditTriangles(const NifSkinnedShape& shape, CollisionMeshAudit& audit)
+		{
+			for (const auto& tri : shape.triangles) {
+				if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+					++audit.degenerateTriangles;
+					continue;
+				}
+
+				const auto& a = shape.vertices[tri[0]];
+				const auto& b = shape.vertices[tri[1]];
+				const auto& c = shape.vertices[tri[2]];
+				const Vec3 ab = sub(b.position, a.position);
+				const Vec3 bc = sub(c.position, b.position);
+				const Vec3 ca = sub(a.position, c.position);
+				const Vec3 n = cross(ab, sub(c.position, a.position));
+				const float longest2 = std::max({ dot(ab, ab), dot(bc, bc), dot(ca, ca) });
+				const float doubleArea = std::sqrt(dot(n, n));
+
+				// The height on the longest edge is doubleArea / longest.
+				if (longest2 <= 0 || doubleArea * kDegenerateRatio <= longest2)
+					++audit.degenerateTriangles;
+				else if (doubleArea * kMaxSliverRatio < longest2)
+					++audit.sliverTriangles;
+
+				// Unweighted vertices are counted as unnormalized already.
+				if (weighted(a) && weighted(b) && weighted(c) &&
+					(!shareBone(a, b) || !shareBone(b, c) || !shareBone(c, a)))
+					++audit.disjointBoneTriangles;
+			}
+		}
+	}  // namespace
+
+	bool CollisionMeshAudit::clean() const
+	{
+		return degenerateTriangles == 0 && sliverTriangles == 0 && disjointBoneTriangles == 0 &&
+		       duplicateVertices == 0 && unnormalizedVertices == 0 && unlistedBoneVertices == 0;
+	}
+
+	std::vector<CollisionMeshAudit> AuditCollisionMeshes(const ParsedNif& parsed, const std::string& xmlPath)
+	{
+		std::vector<CollisionMeshAudit> out;
+
+		// A missing or malformed XML is the schema validator's to report.
+		std::string bytes = ReadDataFile(xmlPath);
+		pugi::xml_document doc;
+		if (bytes.empty() || !doc.load_buffer(bytes.data(), bytes.size()))
+			return out;
+
+		// A shape declared twice is built once per declaration, but audited once.
+		std::unordered_map<std::string, bool> collisionShapes;
+		for (const auto& node : ResolvePhysicsDefinitions(doc).nodes) {
+			if (node.family == Family::PerVertex || node.family == Family::PerTriangle)
+				collisionShapes[node.name] = collisionShapes[node.name] || node.family == Family::PerTriangle;
+		}
+		if (collisionShapes.empty())
+			return out;
+
+		for (const auto& shape : ReadNifSkinnedShapes(parsed)) {
+			auto it = collisionShapes.find(shape.name);
+			if (it == collisionShapes.end())
+				continue;
+
+			CollisionMeshAudit audit;
+			audit.blockIndex = shape.blockIndex;
+			audit.name = shape.name;
+			audit.shapeType = shape.shapeType;
+			audit.perTriangle = it->second;
+			audit.vertices = shape.vertices.size();
+			audit.triangles = shape.triangles.size();
+			auditVertices(shape, audit);
+			if (audit.perTriangle)
+				auditTriangles(shape, audit);
+			if (!audit.clean())
+				out.push_back(std::move(audit));
+		}
+		return out;
+	}
+}
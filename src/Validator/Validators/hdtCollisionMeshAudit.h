@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace hdt
+{
+	struct ParsedNif;
+
+	// Geometry defects of one skinned shape that the physics XML uses as a collision
+	// mesh. Counts are per vertex or per triangle; the triangle counts stay at zero for
+	// per-vertex shapes, whose colliders are the vertices alone.
+	struct CollisionMeshAudit
+	{
+		int blockIndex = -1;
+		std::string name;
+		std::string shapeType;
+		bool perTriangle = false;
+		size_t vertices = 0;
+		size_t triangles = 0;
+		size_t degenerateTriangles = 0;   // repeated index, or no area
+		size_t sliverTriangles = 0;       // longest edge many times the height on it
+		size_t disjointBoneTriangles = 0; // two of the vertices share no weighted bone
+		size_t duplicateVertices = 0;     // same position as an earlier vertex
+		size_t unnormalizedVertices = 0;  // the four weights don't sum to 1
+		size_t unlistedBoneVertices = 0;  // weighted to a bone index past the skin's bone list
+
+		bool clean() const;
+	};
+
+	// Audit the skinned shapes of `parsed` that the physics XML at `xmlPath` declares as
+	// <per-vertex-shape> or <per-triangle-shape>, over the vertices and triangles of
+	// their NiSkinPartition (see ReadNifSkinnedShapes). Degenerate and sliver triangles
+	// give the midphase colliders with no useful contact normal; triangles across
+	// unrelated bones get keyed on the union of those bones in the ColliderTree, and
+	// their AABB stretches whenever the bones move apart. Only shapes with a defect are
+	// returned; empty when the XML is missing or malformed.
+	std::vector<CollisionMeshAudit> AuditCollisionMeshes(const ParsedNif& parsed, const std::string& xmlPath);
+}
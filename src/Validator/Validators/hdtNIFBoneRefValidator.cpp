@@ -1,8 +1,10 @@
 #include "hdtNIFBoneRefValidator.h"
 
+#include "../Improvers/hdtNIFBinaryIO.h"   // ParsedNif
+#include "../Utils/hdtDataFileSystem.h"    // ReadDataFile
+#include "../Utils/hdtNIFSkinReader.h"     // CollectNifNodeNames, ReadNifSkinnedShapes
 #include "../Utils/hdtTemplateDefaults.h"  // isDefaultNodeName
 #include "../Utils/hdtValidatorFamily.h"   // familyForNode
-#include "NetImmerseUtils.h"               // readAllFile2
 #include "hdtNIFValidator.h"               // CollectNamedSkeletonNodes
 
 #include <pugixml.hpp>
@@ -15,6 +17,10 @@ namespace hdt
 {
 	namespace
 	{
+		// Stands in for the per-armor prefix of the merge; any prefix no node name starts
+		// with resolves the same way.
+		constexpr const char* kOfflineMergePrefix = "hdtSSEPhysics_AutoRename_Armor_Offline ";
+
 		// Mirror of SkyrimSystemCreator::getRenamedBone: a mapped name resolves to its
 		// merged-skeleton form, an unmapped name is looked up verbatim.
 		std::string applyRename(const std::string& name,
@@ -80,41 +86,75 @@ namespace hdt
 				collectReferences(child, nodeSet, renameMap, missingByResolved);
 			}
 		}
+		// Load the XML and keep the references that do not resolve in nodeSet. A
+		// missing/malformed XML yields no findings on purpose: reporting bad XML is the
+		// schema validator's job, and it runs over these same XMLs in the report.
+		std::vector<MissingBoneRef> findMissingRefs(const std::string& xmlPath,
+			const std::unordered_set<std::string>& nodeSet,
+			const std::unordered_map<std::string, std::string>& renameMap)
+		{
+			std::string bytes = ReadDataFile(xmlPath);
+			pugi::xml_document doc;
+			if (!doc.load_buffer(bytes.data(), bytes.size()))
+				return {};
+
+			std::unordered_map<std::string, MissingAcc> missingByResolved;
+			collectReferences(doc, nodeSet, renameMap, missingByResolved);
+
+			std::vector<MissingBoneRef> missing;
+			missing.reserve(missingByResolved.size());
+			for (auto& [resolved, acc] : missingByResolved) {
+				MissingBoneRef m;
+				m.referencedName = acc.referenced;
+				m.resolvedName = resolved;
+				m.usedAsBone = acc.usedAsBone;
+				m.constraintRefs = acc.constraintRefs;
+				missing.push_back(std::move(m));
+			}
+			// Deterministic report ordering.
+			std::sort(missing.begin(), missing.end(),
+				[](const MissingBoneRef& a, const MissingBoneRef& b) { return a.resolvedName < b.resolvedName; });
+
+			return missing;
+		}
 	}  // namespace
 
+#ifndef HDT_VALIDATOR_STANDALONE
 	std::vector<MissingBoneRef> FindMissingPhysicsXmlBoneRefs(
 		RE::NiNode* skeletonRoot,
 		const std::string& xmlPath,
 		const std::unordered_map<std::string, std::string>& renameMap)
 	{
-		// A missing/malformed XML yields no findings on purpose: reporting bad XML is the
-		// schema validator's job, and it runs over these same equipped XMLs in the report.
-		std::string bytes = readAllFile2(xmlPath.c_str());
-		pugi::xml_document doc;
-		if (!doc.load_buffer(bytes.data(), bytes.size()))
-			return {};
-
 		std::vector<std::string> nodeNames;
 		CollectNamedSkeletonNodes(skeletonRoot, nodeNames);
 		std::unordered_set<std::string> nodeSet(nodeNames.begin(), nodeNames.end());
 
-		std::unordered_map<std::string, MissingAcc> missingByResolved;
-		collectReferences(doc, nodeSet, renameMap, missingByResolved);
-
-		std::vector<MissingBoneRef> missing;
-		missing.reserve(missingByResolved.size());
-		for (auto& [resolved, acc] : missingByResolved) {
-			MissingBoneRef m;
-			m.referencedName = acc.referenced;
-			m.resolvedName = resolved;
-			m.usedAsBone = acc.usedAsBone;
-			m.constraintRefs = acc.constraintRefs;
-			missing.push_back(std::move(m));
+		return findMissingRefs(xmlPath, nodeSet, renameMap);
+	}
+#endif
+
+	std::vector<MissingBoneRef> FindMissingPhysicsXmlBoneRefsOffline(
+		const ParsedNif& nif,
+		const std::vector<std::string>& referenceSkeletonNodes,
+		const std::string& xmlPath)
+	{
+		std::unordered_set<std::string> nodeSet(referenceSkeletonNodes.begin(), referenceSkeletonNodes.end());
+
+		// doSkeletonMerge: a node of the mesh the skeleton already has is merged into it,
+		// any other one is cloned in under a prefixed name that the renameMap points to.
+		std::vector<std::string> meshNodes = CollectNifNodeNames(nif, false);
+		for (const auto& shape : ReadNifSkinnedShapes(nif))
+			meshNodes.insert(meshNodes.end(), shape.boneNames.begin(), shape.boneNames.end());
+
+		std::unordered_map<std::string, std::string> renameMap;
+		for (const auto& name : meshNodes) {
+			if (name.empty() || nodeSet.count(name) || renameMap.count(name))
+				continue;
+			renameMap.emplace(name, kOfflineMergePrefix + name);
 		}
-		// Deterministic report ordering.
-		std::sort(missing.begin(), missing.end(),
-			[](const MissingBoneRef& a, const MissingBoneRef& b) { return a.resolvedName < b.resolvedName; });
+		for (const auto& [name, renamed] : renameMap)
+			nodeSet.insert(renamed);
 
-		return missing;
+		return findMissingRefs(xmlPath, nodeSet, renameMap);
 	}
 }  // namespace hdt
@@ -11,6 +11,8 @@ namespace RE
 
 namespace hdt
 {
+	struct ParsedNif;
+
 	// A single physics-XML node reference that does not resolve to any node in the
 	// skeleton the XML is applied to. `usedAsBone`/`constraintRefs` record how the XML
 	// reaches the node so the report can state the concrete effect of its absence.
@@ -22,6 +24,7 @@ namespace hdt
 		int constraintRefs = 0;      // count of constraint endpoints (bodyA/bodyB) referencing it
 	};
 
+#ifndef HDT_VALIDATOR_STANDALONE
 	// Returns the physics-XML node references that do NOT resolve to any node in
 	// `skeletonRoot` — the NPC node SMP resolves bones against at load time, which already
 	// contains the equipped item's merged + renamed nodes.
@@ -42,4 +45,17 @@ namespace hdt
 		RE::NiNode* skeletonRoot,
 		const std::string& xmlPath,
 		const std::unordered_map<std::string, std::string>& renameMap);
-}
+#endif
+
+	// Offline variant for meshes on disk: the skeleton is `referenceSkeletonNodes` (the
+	// node names of a reference skeleton NIF, e.g. skeleton_female.nif, collected with
+	// CollectNifNodeNames) merged with the nodes and skin bones of `nif` the way
+	// doSkeletonMerge does at equip time — nodes the skeleton lacks are added under a
+	// prefixed name and reached through the resulting renameMap. Same findings and
+	// ordering as above; a custom skeleton may of course provide nodes the reference
+	// one does not.
+	std::vector<MissingBoneRef> FindMissingPhysicsXmlBoneRefsOffline(
+		const ParsedNif& nif,
+		const std::vector<std::string>& referenceSkeletonNodes,
+		const std::string& xmlPath);
+}  // namespace hdt
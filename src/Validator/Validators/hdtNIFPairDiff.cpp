@@ -0,0 +1,312 @@
+#include "hdtNIFPairDiff.h"
+
+#include "../Improvers/hdtNIFBinaryIO.h"
+#include "../Utils/hdtNIFBinaryUtils.h"
+#include "../Utils/hdtNIFSkinReader.h"
+#include "../Utils/hdtStringUtils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+
+namespace hdt
+{
+	namespace
+	{
+		constexpr size_t kListedNames = 8;
+
+		// A node or shape of one file, with what the diff compares on it.
+		struct PairBlock
+		{
+			int32_t index = -1;
+			std::string type;
+			std::string name;
+			size_t occurrence = 0;              // among the blocks of the same kind and name
+			std::vector<std::string> physics;   // physics XML strings in its extra data
+			int skin = -1;                      // index in PairSide::skinned
+		};
+
+		struct PairSide
+		{
+			std::vector<PairBlock> nodes;
+			std::vector<PairBlock> shapes;
+			std::vector<NifSkinnedShape> skinned;
+		};
+
+		bool isShapeType(const std::string& type)
+		{
+			return type.find("TriShape") != std::string::npos || type == "NiTriStrips";
+		}
+
+		// NiAVObject: the name, then the extra data refs.
+		std::vector<int32_t> readExtraDataRefs(const std::vector<uint8_t>& block)
+		{
+			std::vector<int32_t> refs;
+			try {
+				NifReader r(block);
+				r.readU32();
+				const uint32_t numExtra = r.readU32();
+				if (!r.canRead(static_cast<size_t>(numExtra) * 4))
+					return {};
+				refs.reserve(numExtra);
+				for (uint32_t i = 0; i < numExtra; ++i)
+					refs.push_back(static_cast<int32_t>(r.readU32()));
+			} catch (...) {
+				return {};
+			}
+			return refs;
+		}
+
+		// NiStringExtraData: name, then the string.
+		std::vector<std::string> readPhysicsStrings(const ParsedNif& parsed, int32_t owner)
+		{
+			std::vector<std::string> strings;
+			for (int32_t ref : readExtraDataRefs(parsed.blocks[static_cast<size_t>(owner)])) {
+				auto type = blockTypeOf(parsed, ref);
+				if (!type || *type != nif::kTypeNiStringExtraData || blockNameOf(parsed, ref) != nif::kPhysicsMarker)
+					continue;
+				const auto& block = parsed.blocks[static_cast<size_t>(ref)];
+				if (block.size() < nif::kNiStringExtraDataMinBlockSize)
+					continue;
+				uint32_t valueIdx = 0;
+				std::memcpy(&valueIdx, block.data() + 4, 4);
+				if (valueIdx < parsed.strings.size())
+					strings.push_back(parsed.strings[valueIdx]);
+			}
+			return strings;
+		}
+
+		PairSide collectSide(const ParsedNif& parsed)
+		{
+			PairSide side;
+			side.skinned = ReadNifSkinnedShapes(parsed);
+			std::unordered_map<int32_t, int> skinByBlock;
+			for (size_t s = 0; s < side.skinned.size(); ++s)
+				skinByBlock[side.skinned[s].blockIndex] = static_cast<int>(s);
+
+			std::map<std::string, size_t> nodeNames, shapeNames;
+			const int32_t numBlocks = static_cast<int32_t>(parsed.blocks.size());
+			for (int32_t i = 0; i < numBlocks; ++i) {
+				auto type = blockTypeOf(parsed, i);
+				if (!type)
+					continue;
+				const bool node = nif::isNodeType(*type);
+				if (!node && !isShapeType(*type))
+					continue;
+
+				PairBlock block;
+				block.index = i;
+				block.type = *type;
+				block.name = blockNameOf(parsed, i);
+				block.occurrence = (node ? nodeNames : shapeNames)[block.name]++;
+				block.physics = readPhysicsStrings(parsed, i);
+				if (auto it = skinByBlock.find(i); it != skinByBlock.end())
+					block.skin = it->second;
+				(node ? side.nodes : side.shapes).push_back(std::move(block));
+			}
+			return side;
+		}
+
+		std::string label(const PairBlock& block)
+		{
+			std::string out = block.type + " '" + block.name + "'";
+			if (block.occurrence > 0)
+				out += " #" + std::to_string(block.occurrence + 1);
+			return out;
+		}
+
+		std::string joinNames(const std::vector<std::string>& names)
+		{
+			std::string out;
+			for (size_t i = 0; i < names.size() && i < kListedNames; ++i)
+				out += (i ? ", '" : "'") + names[i] + "'";
+			if (names.size() > kListedNames)
+				out += " and " + std::to_string(names.size() - kListedNames) + " more";
+			return out;
+		}
+
+		std::string joinPhysics(const std::vector<std::string>& strings)
+		{
+			return strings.empty() ? std::string("(none)") : joinNames(strings);
+		}
+
+		bool samePhysics(const std::vector<std::string>& a, const std::vector<std::string>& b)
+		{
+			return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const std::string& x, const std::string& y) {
+				return NormalizePathForComparison(x) == NormalizePathForComparison(y);
+			});
+		}
+
+		// FNV-1a over the vertex indices, in triangle order: the creator builds per-triangle
+		// colliders in that order too.
+		uint64_t topologyHash(const NifSkinnedShape& shape)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			for (const auto& tri : shape.triangles)
+				for (uint16_t index : tri) {
+					hash = (hash ^ (index & 0xFFu)) * 1099511628211ull;
+					hash = (hash ^ (index >> 8)) * 1099511628211ull;
+				}
+			return hash;
+		}
+
+		void diffSkin(const std::string& where, const NifSkinnedShape& a, const NifSkinnedShape& b,
+			std::vector<NifPairDifference>& out)
+		{
+			if (a.boneNames != b.boneNames) {
+				std::vector<std::string> sortedA = a.boneNames, sortedB = b.boneNames;
+				std::sort(sortedA.begin(), sortedA.end());
+				std::sort(sortedB.begin(), sortedB.end());
+				std::string detail;
+				if (sortedA == sortedB) {
+					const auto mismatch = std::mismatch(a.boneNames.begin(), a.boneNames.end(), b.boneNames.begin());
+					const auto at = static_cast<size_t>(mismatch.first - a.boneNames.begin());
+					detail = "same " + std::to_string(a.boneNames.size()) + " bones in another order (from index " +
+					         std::to_string(at) + ": '" + *mismatch.first + "' vs '" + *mismatch.second +
+					         "'), so the vertex weights point at other bones";
+				} else {
+					std::vector<std::string> onlyA, onlyB;
+					std::set_difference(sortedA.begin(), sortedA.end(), sortedB.begin(), sortedB.end(), std::back_inserter(onlyA));
+					std::set_difference(sortedB.begin(), sortedB.end(), sortedA.begin(), sortedA.end(), std::back_inserter(onlyB));
+					detail = std::to_string(a.boneNames.size()) + " vs " + std::to_string(b.boneNames.size()) + " bones";
+					if (!onlyA.empty())
+						detail += "; only in _0: " + joinNames(onlyA);
+					if (!onlyB.empty())
+						detail += "; only in _1: " + joinNames(onlyB);
+					if (onlyA.empty() && onlyB.empty())
+						detail += "; a bone is listed twice on one side";
+				}
+				out.push_back({ NifPairDifferenceKind::SkinBones, where, detail });
+			}
+
+			if (a.vertices.size() != b.vertices.size()) {
+				out.push_back({ NifPairDifferenceKind::VertexCount, where,
+					std::to_string(a.vertices.size()) + " vs " + std::to_string(b.vertices.size()) + " vertices" });
+				return;
+			}
+
+			if (a.triangles.size() != b.triangles.size()) {
+				out.push_back({ NifPairDifferenceKind::Topology, where,
+					std::to_string(a.triangles.size()) + " vs " + std::to_string(b.triangles.size()) + " triangles" });
+				return;  // the partitions split the triangles, so they differ too
+			} else if (topologyHash(a) != topologyHash(b)) {
+				const auto mismatch = std::mismatch(a.triangles.begin(), a.triangles.end(), b.triangles.begin());
+				const auto count = std::count_if(a.triangles.begin(), a.triangles.end(), [&, i = size_t(0)](const auto& tri) mutable {
+					return tri != b.triangles[i++];
+				});
+				out.push_back({ NifPairDifferenceKind::Topology, where,
+					std::to_string(count) + " of " + std::to_string(a.triangles.size()) +
+						" triangles join other vertices, from triangle " +
+						std::to_string(mismatch.first - a.triangles.begin()) });
+			}
+
+			auto describe = [](const NifSkinPartitionLayout& p) {
+				return std::to_string(p.vertices) + " vertices, " + std::to_string(p.triangles) + " triangles, " +
+				       std::to_string(p.bones) + " bones, " + std::to_string(p.bonesPerVertex) + " per vertex";
+			};
+			if (a.partitions.size() != b.partitions.size()) {
+				out.push_back({ NifPairDifferenceKind::Partitions, where,
+					std::to_string(a.partitions.size()) + " vs " + std::to_string(b.partitions.size()) + " partitions" });
+			} else {
+				for (size_t p = 0; p < a.partitions.size(); ++p) {
+					const auto& pa = a.partitions[p];
+					const auto& pb = b.partitions[p];
+					if (pa.vertices != pb.vertices || pa.triangles != pb.triangles || pa.bones != pb.bones ||
+						pa.bonesPerVertex != pb.bonesPerVertex) {
+						out.push_back({ NifPairDifferenceKind::Partitions, where,
+							"partition " + std::to_string(p) + ": " + describe(pa) + " vs " + describe(pb) });
+						break;
+					}
+				}
+			}
+		}
+
+		// Align `a` and `b` by name and occurrence, in the block order of `a` then of `b`.
+		void diffBlocks(const PairSide& sideA, const PairSide& sideB, bool nodes, std::vector<NifPairDifference>& out)
+		{
+			const auto& a = nodes ? sideA.nodes : sideA.shapes;
+			const auto& b = nodes ? sideB.nodes : sideB.shapes;
+			const auto kind = nodes ? NifPairDifferenceKind::Node : NifPairDifferenceKind::Shape;
+
+			auto key = [](const PairBlock& block) { return block.name + '\0' + std::to_string(block.occurrence); };
+			std::unordered_map<std::string, const PairBlock*> byKey;
+			for (const auto& block : b)
+				byKey[key(block)] = &block;
+
+			auto onlyIn = [&](const PairBlock& block, const char* side) {
+				std::string detail = std::string("only in ") + side;
+				if (!block.physics.empty())
+					detail += ", with the physics XML " + joinPhysics(block.physics);
+				// A node alone changes nothing FSMP builds, unless it carries the physics.
+				out.push_back({ block.physics.empty() ? kind : NifPairDifferenceKind::PhysicsData, label(block), detail });
+			};
+
+			for (const auto& blockA : a) {
+				auto it = byKey.find(key(blockA));
+				if (it == byKey.end()) {
+					onlyIn(blockA, "_0");
+					continue;
+				}
+				const PairBlock& blockB = *it->second;
+				byKey.erase(it);
+
+				const std::string where = label(blockA);
+				if (blockA.type != blockB.type)
+					out.push_back({ kind, where, blockA.type + " vs " + blockB.type });
+				if (!samePhysics(blockA.physics, blockB.physics))
+					out.push_back({ NifPairDifferenceKind::PhysicsData, where,
+						joinPhysics(blockA.physics) + " vs " + joinPhysics(blockB.physics) });
+				if (blockA.skin >= 0 && blockB.skin >= 0)
+					diffSkin(where, sideA.skinned[static_cast<size_t>(blockA.skin)], sideB.skinned[static_cast<size_t>(blockB.skin)], out);
+				else if (blockA.skin >= 0 || blockB.skin >= 0)
+					out.push_back({ NifPairDifferenceKind::SkinBones, where,
+						std::string("skinned in ") + (blockA.skin >= 0 ? "_0" : "_1") + " only" });
+			}
+			for (const auto& blockB : b)
+				if (byKey.contains(key(blockB)))
+					onlyIn(blockB, "_1");
+		}
+	}  // namespace
+
+	const char* NifPairDifferenceKindName(NifPairDifferenceKind kind)
+	{
+		switch (kind) {
+		case NifPairDifferenceKind::Header:
+			return "header";
+		case NifPairDifferenceKind::Node:
+			return "node";
+		case NifPairDifferenceKind::Shape:
+			return "shape";
+		case NifPairDifferenceKind::VertexCount:
+			return "vertex count";
+		case NifPairDifferenceKind::Topology:
+			return "topology";
+		case NifPairDifferenceKind::SkinBones:
+			return "skin bones";
+		case NifPairDifferenceKind::Partitions:
+			return "partitions";
+		case NifPairDifferenceKind::PhysicsData:
+			return "physics data";
+		}
+		return "unknown";
+	}
+
+	std::vector<NifPairDifference> DiffWeightVariantNifs(const ParsedNif& nif0, const ParsedNif& nif1)
+	{
+		std::vector<NifPairDifference> out;
+		if (nif0.version != nif1.version || nif0.userVersion != nif1.userVersion || nif0.bsVersion != nif1.bsVersion) {
+			out.push_back({ NifPairDifferenceKind::Header, {},
+				"NIF version " + std::to_string(nif0.userVersion) + "/" + std::to_string(nif0.bsVersion) + " vs " +
+					std::to_string(nif1.userVersion) + "/" + std::to_string(nif1.bsVersion) + " (user/BSStream)" });
+			return out;  // the rest would differ in layout alone
+		}
+
+		const PairSide side0 = collectSide(nif0);
+		const PairSide side1 = collectSide(nif1);
+		diffBlocks(side0, side1, true, out);
+		diffBlocks(side0, side1, false, out);
+		return out;
+	}
+}
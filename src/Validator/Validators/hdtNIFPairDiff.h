@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace hdt
+{
+	struct ParsedNif;
+
+	enum class NifPairDifferenceKind
+	{
+		Header,       // different NIF or BSStream versions
+		Node,         // a node in one file only, or of another type
+		Shape,        // a shape in one file only, or of another type
+		VertexCount,
+		Topology,     // same vertex count, different triangles
+		SkinBones,    // different skin bone lists, or skinned on one side only
+		Partitions,   // different NiSkinPartition layout
+		PhysicsData   // different "HDT Skinned Mesh Physics Object" strings on a block
+	};
+
+	const char* NifPairDifferenceKindName(NifPairDifferenceKind kind);
+
+	struct NifPairDifference
+	{
+		NifPairDifferenceKind kind = NifPairDifferenceKind::Shape;
+		std::string block;   // the block it concerns ("BSTriShape 'Body'"); empty for the header
+		std::string detail;  // _0 side first: "1250 vs 1248 vertices"
+	};
+
+	// Structural diff of the two weight variants of a mesh, `nif0` (foo_0.nif) and `nif1`
+	// (foo_1.nif). The game morphs every vertex between the two as the weight slider moves,
+	// and FSMP builds the physics of whichever it loads, so the pair must agree on
+	// everything but vertex positions. Nodes and shapes are aligned by type and name (the
+	// n-th of a repeated name with the n-th); aligned skinned shapes are compared on
+	// vertex count, triangle topology, skin bone list and partition layout, and every
+	// aligned block on the physics XML strings it carries. The list is minimal: a block
+	// missing on one side is one difference, and a shape whose vertex or triangle count
+	// differs is not also reported for what follows from it. Node differences alone leave
+	// the physics intact; every other kind makes the two variants build different systems.
+	std::vector<NifPairDifference> DiffWeightVariantNifs(const ParsedNif& nif0, const ParsedNif& nif1);
+}
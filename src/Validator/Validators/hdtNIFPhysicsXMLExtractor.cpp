@@ -1,6 +1,8 @@
 #include "hdtNIFValidator.h"
 
+#include "../Improvers/hdtNIFBinaryIO.h"
 #include "../Parser/hdtNIFBinaryParser.h"
+#include "../Utils/hdtDataFileSystem.h"
 #include "../Utils/hdtNIFBinaryUtils.h"
 
 #include <algorithm>
@@ -8,6 +10,7 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -110,22 +113,6 @@ namespace hdt
 
 		// ── File I/O ──────────────────────────────────────────────────────────
 
-		std::ifstream file(std::filesystem::u8path(nifPath), std::ios::binary | std::ios::ate);
-		if (!file.is_open()) {
-			result.errors.push_back("Cannot open: " + nifPath);
-			return result;
-		}
-
-		auto fileSize = file.tellg();
-		if (fileSize <= 0 || static_cast<size_t>(fileSize) > nif::kMaxNifFileSize) {
-			result.errors.push_back(fileSize <= 0 ? "File is empty or unreadable: " + nifPath : "File exceeds max supported size: " + nifPath);
-			return result;
-		}
-
-		const size_t totalSize = static_cast<size_t>(fileSize);
-
-		// ── Physics marker probe ──────────────────────────────────────────────
-
 		// Read a prefix to check for the physics marker before reading the full file.
 		// The marker lives in the NIF string table, which starts at roughly
 		// 6 × numBlocks + ~2 KB into the file. For non-physics NIFs the pre-string-
@@ -136,24 +123,51 @@ namespace hdt
 		// simple skinned meshes with <500 blocks).
 		// ~93% of NIFs have no physics data; this avoids reading their full content.
 		static constexpr size_t kMarkerProbeSize = 32 * 1024;
-		const size_t probeSize = std::min(totalSize, kMarkerProbeSize);
 
-		std::vector<uint8_t> data(probeSize);
-		file.seekg(0);
-		file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(probeSize));
+		std::vector<uint8_t> data;
+		std::ifstream file(std::filesystem::u8path(nifPath), std::ios::binary | std::ios::ate);
+		if (file.is_open()) {
+			auto fileSize = file.tellg();
+			if (fileSize <= 0 || static_cast<size_t>(fileSize) > nif::kMaxNifFileSize) {
+				result.errors.push_back(fileSize <= 0 ? "File is empty or unreadable: " + nifPath : "File exceeds max supported size: " + nifPath);
+				return result;
+			}
+
+			const size_t totalSize = static_cast<size_t>(fileSize);
+			const size_t probeSize = std::min(totalSize, kMarkerProbeSize);
 
-		if (!nif::ContainsAsciiSequence(data.data(), data.size(), nif::kPhysicsMarker))
-			return result;  // not a physics NIF — skip reading the rest of the file
+			data.resize(probeSize);
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(probeSize));
 
-		// ── Full read ─────────────────────────────────────────────────────────
+			if (!nif::ContainsAsciiSequence(data.data(), data.size(), nif::kPhysicsMarker))
+				return result;  // not a physics NIF — skip reading the rest of the file
+
+			if (probeSize < totalSize) {
+				data.resize(totalSize);
+				file.seekg(static_cast<std::streamoff>(probeSize));
+				file.read(reinterpret_cast<char*>(data.data() + probeSize),
+					static_cast<std::streamsize>(totalSize - probeSize));
+			}
+			file.close();
+		} else {
+			// Not loose: packed in an archive, where the probe only inflates the prefix.
+			std::string bytes = ReadPackedDataFile(nifPath, kMarkerProbeSize);
+			if (bytes.empty()) {
+				result.errors.push_back("Cannot open: " + nifPath);
+				return result;
+			}
+			if (!nif::ContainsAsciiSequence(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), nif::kPhysicsMarker))
+				return result;
 
-		if (probeSize < totalSize) {
-			data.resize(totalSize);
-			file.seekg(static_cast<std::streamoff>(probeSize));
-			file.read(reinterpret_cast<char*>(data.data() + probeSize),
-				static_cast<std::streamsize>(totalSize - probeSize));
+			if (bytes.size() == kMarkerProbeSize)
+				bytes = ReadPackedDataFile(nifPath);
+			if (bytes.empty()) {
+				result.errors.push_back("File is unreadable or exceeds max supported size: " + nifPath);
+				return result;
+			}
+			data.assign(bytes.begin(), bytes.end());
 		}
-		file.close();
 
 		// ── Header validation ─────────────────────────────────────────────────
 
@@ -234,6 +248,7 @@ namespace hdt
 						// than treating its stale string-table paths as real references.
 						result.hasOrphanedPhysicsMarker = true;
 					}
+					result.parsed = std::make_shared<const ParsedNif>(std::move(*parsedOpt));
 				}
 				return result;
 			}
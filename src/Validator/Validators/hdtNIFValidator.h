@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -12,6 +13,8 @@ namespace RE
 
 namespace hdt
 {
+	struct ParsedNif;
+
 	struct NIFScanResult
 	{
 		bool hasPhysicsData = false;
@@ -20,10 +23,12 @@ namespace hdt
 		bool hasGeometry = false;
 		bool hasSkinning = false;
 		bool hasOrphanedPhysicsMarker = false;  // marker string present but no NiStringExtraData block references it
+		std::shared_ptr<const ParsedNif> parsed;  // the full parse of a NIF with physics data, for the caller to keep
 		std::vector<std::string> errors;
 	};
 
-	// Extract physics XML references from a NIF binary file on disk.
+	// Extract physics XML references from a NIF binary file, loose on disk or packed in
+	// a mounted archive (see hdtDataFileSystem.h).
 	// Parses NIF header structures to locate "HDT Skinned Mesh Physics Object"
 	// NiStringExtraData links and records scanner/parsing failures in NIFScanResult::errors.
 	NIFScanResult ExtractPhysicsXmlRefsFromNIFs(const std::string& nifPath);
@@ -38,6 +43,7 @@ namespace hdt
 		std::vector<std::string> warnings;
 	};
 
+#ifndef HDT_VALIDATOR_STANDALONE
 	// Validate NIF structural requirements for FSMP physics using a loaded NiNode*.
 	// Can be called at runtime when the NIF has been loaded by the game.
 	NIFStructuralResult ValidateNIFStructure(RE::NiNode* root, const std::string& nifPath);
@@ -46,5 +52,6 @@ namespace hdt
 	// to `outNames`. Used both as a diagnostic bone inventory and as the lookup set the
 	// bone-reference validator resolves physics-XML node references against.
 	void CollectNamedSkeletonNodes(RE::NiNode* root, std::vector<std::string>& outNames);
+#endif
 
 }  // namespace hdt
@@ -0,0 +1,401 @@
+#include "hdtPhysicsCostEstimator.h"
+
+#include "../Improvers/hdtNIFBinaryIO.h"
+#include "../Utils/hdtDataFileSystem.h"
+#include "../Utils/hdtNIFSkinReader.h"
+#include "../Utils/hdtTemplateDefaults.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace hdt
+{
+	namespace
+	{
+		// Cost constants, in microseconds per substep. Measured orders of magnitude on a
+		// desktop CPU, not a profile: only the ranking they produce matters.
+		constexpr double kSkinningPerVertex = 0.004;
+		constexpr double kAabbPerCollider = 0.003;
+		constexpr double kNarrowPhasePerDynamicCollider = 0.02;
+		constexpr double kIntegrationPerDynamicBone = 0.15;
+		constexpr double kSolverPerRowIteration = 0.01;
+		constexpr int kSolverIterations = 16;  // SkyrimPhysicsWorld default
+
+		constexpr size_t kMaxKeysPerCollider = 4;  // ColliderTree::insertCollider
+
+		// Key-only mirror of ColliderTree: the same insertion, clipping and optimize
+		// rules, with collider indices in place of colliders.
+		struct KeyTree
+		{
+			uint32_t key = 0;
+			std::vector<uint32_t> colliders;
+			std::vector<KeyTree> children;
+
+			bool empty() const { return colliders.empty() && children.empty(); }
+
+			void insert(const uint32_t* keys, size_t keyCount, uint32_t collider)
+			{
+				KeyTree* p = this;
+				for (size_t i = 0; i < keyCount && i < kMaxKeysPerCollider; ++i) {
+					auto f = std::find_if(p->children.begin(), p->children.end(), [&](const KeyTree& n) { return n.key == keys[i]; });
+					if (f == p->children.end()) {
+						p->children.push_back({ keys[i], {}, {} });
+						p = &p->children.back();
+					} else
+						p = &*f;
+				}
+				p->colliders.push_back(collider);
+			}
+
+			template <typename F>
+			void clip(const F& removed)
+			{
+				for (auto& i : children)
+					i.clip(removed);
+				colliders.erase(std::remove_if(colliders.begin(), colliders.end(), removed), colliders.end());
+				children.erase(std::remove_if(children.begin(), children.end(), [](const KeyTree& n) { return n.empty(); }), children.end());
+			}
+
+			void optimize()
+			{
+				for (auto& i : children)
+					i.optimize();
+				children.erase(std::remove_if(children.begin(), children.end(), [](const KeyTree& n) { return n.empty(); }), children.end());
+
+				while (children.size() == 1 && children[0].colliders.empty()) {
+					std::vector<KeyTree> temp;
+					temp.swap(children.front().children);
+					children.swap(temp);
+				}
+				if (children.size() == 1 && colliders.empty()) {
+					colliders = children[0].colliders;
+					std::vector<KeyTree> temp;
+					temp.swap(children[0].children);
+					children.swap(temp);
+				}
+			}
+
+			template <typename F>
+			void visit(const F& func, size_t depth = 1) const
+			{
+				func(*this, depth);
+				for (auto& i : children)
+					i.visit(func, depth + 1);
+			}
+		};
+
+		void measureTree(const KeyTree& tree, PhysicsShapeCost& cost)
+		{
+			size_t leaves = 0;
+			tree.visit([&](const KeyTree& node, size_t depth) {
+				++cost.treeNodes;
+				cost.treeDepth = std::max(cost.treeDepth, depth);
+				if (!node.colliders.empty()) {
+					++leaves;
+					cost.colliders += node.colliders.size();
+					cost.maxLeafColliders = std::max(cost.maxLeafColliders, node.colliders.size());
+				}
+			});
+			cost.meanLeafColliders = leaves ? static_cast<double>(cost.colliders) / static_cast<double>(leaves) : 0;
+		}
+
+		// Everything about the bones of one shape that the colliders depend on.
+		struct ShapeBones
+		{
+			std::vector<float> thresholds;
+			std::vector<bool> dynamic;
+		};
+
+		// PerVertexShape::autoGen followed by clipColliders; returns the surviving tree
+		// and flags the vertices it keeps.
+		KeyTree buildVertexTree(const NifSkinnedShape& shape, const ShapeBones& bones, std::vector<bool>& used)
+		{
+			KeyTree tree;
+			std::vector<uint32_t> keys;
+			for (uint32_t i = 0; i < shape.vertices.size(); ++i) {
+				keys.clear();
+				for (size_t j = 0; j < 4; ++j)
+					if (shape.vertices[i].weights[j] > FLT_EPSILON)
+						keys.push_back(shape.vertices[i].bones[j]);
+				tree.insert(keys.data(), keys.size(), i);
+			}
+
+			tree.clip([&](uint32_t v) {
+				const auto& vertex = shape.vertices[v];
+				for (size_t j = 0; j < 4; ++j)
+					if (vertex.weights[j] > FLT_EPSILON && vertex.weights[j] > bones.thresholds[vertex.bones[j]])
+						return false;
+				return true;
+			});
+			tree.optimize();
+			tree.visit([&](const KeyTree& node, size_t) {
+				for (auto v : node.colliders)
+					used[v] = true;
+			});
+			return tree;
+		}
+
+		// PerTriangleShape::addTriangle: the bones of the three vertices with their summed
+		// weights, heaviest first and ties by bone index.
+		KeyTree buildTriangleTree(const NifSkinnedShape& shape, const ShapeBones& bones, std::vector<bool>& used)
+		{
+			KeyTree tree;
+			for (uint32_t t = 0; t < shape.triangles.size(); ++t) {
+				std::vector<std::pair<uint32_t, float>> summed;
+				for (auto v : shape.triangles[t]) {
+					const auto& vertex = shape.vertices[v];
+					for (size_t j = 0; j < 4; ++j) {
+						if (vertex.weights[j] < FLT_EPSILON)
+							continue;
+						auto f = std::find_if(summed.begin(), summed.end(), [&](const auto& s) { return s.first == vertex.bones[j]; });
+						if (f == summed.end())
+							summed.emplace_back(vertex.bones[j], vertex.weights[j]);
+						else
+							f->second += vertex.weights[j];
+					}
+				}
+				std::sort(summed.begin(), summed.end(), [](const auto& a, const auto& b) {
+					return a.second > b.second || (a.second == b.second && a.first < b.first);
+				});
+				std::vector<uint32_t> keys;
+				for (const auto& s : summed)
+					keys.push_back(s.first);
+				tree.insert(keys.data(), keys.size(), t);
+			}
+
+			tree.clip([&](uint32_t t) {
+				for (auto v : shape.triangles[t]) {
+					const auto& vertex = shape.vertices[v];
+					for (size_t j = 0; j < 4; ++j)
+						if (vertex.weights[j] > FLT_EPSILON && vertex.weights[j] > bones.thresholds[vertex.bones[j]])
+							return false;
+				}
+				return true;
+			});
+			tree.optimize();
+			tree.visit([&](const KeyTree& node, size_t) {
+				for (auto t : node.colliders)
+					for (auto v : shape.triangles[t])
+						used[v] = true;
+			});
+			return tree;
+		}
+
+		// SkinnedMeshBody::flexible: the weight the vertex puts on dynamic bones.
+		float flexible(const NifSkinVertex& vertex, const ShapeBones& bones)
+		{
+			float ret = 0;
+			for (size_t i = 0; i < 4; ++i) {
+				if (vertex.weights[i] < FLT_EPSILON)
+					break;
+				if (bones.dynamic[vertex.bones[i]])
+					ret += vertex.weights[i];
+			}
+			return ret;
+		}
+
+		// Rows btGeneric6DofSpring2Constraint adds for one axis group: a locked or limited
+		// axis takes a limit row (lower > upper leaves the axis free), an enabled spring
+		// and a motor take one more each.
+		size_t genericAxisRows(const ResolvedPhysicsNode& node, const char* prefix)
+		{
+			const std::string p = prefix;
+			const auto lower = node.vector3(p + "LowerLimit", { 1, 1, 1 });
+			const auto upper = node.vector3(p + "UpperLimit", { -1, -1, -1 });
+			const auto stiffness = node.vector3(p + "Stiffness", { 0, 0, 0 });
+			const bool springs = node.flag(p == "linear" ? "enableLinearSprings" : "enableAngularSprings", true);
+			const bool motors = node.flag(p + "Motors", false) || node.flag(p + "ServoMotors", false);
+
+			size_t rows = 0;
+			for (size_t axis = 0; axis < 3; ++axis) {
+				if (lower[axis] <= upper[axis])
+					++rows;
+				if (springs && stiffness[axis] > 0)
+					++rows;
+				if (motors)
+					++rows;
+			}
+			return rows;
+		}
+	}  // namespace
+
+	const char* PhysicsCostClassName(PhysicsCostClass costClass)
+	{
+		switch (costClass) {
+		case PhysicsCostClass::Light:
+			return "light";
+		case PhysicsCostClass::Moderate:
+			return "moderate";
+		case PhysicsCostClass::Heavy:
+			return "heavy";
+		case PhysicsCostClass::Extreme:
+			return "extreme";
+		}
+		return "unknown";
+	}
+
+	size_t PhysicsCostEstimate::totalColliders() const
+	{
+		size_t total = 0;
+		for (const auto& shape : shapes)
+			total += shape.colliders + shape.vertexColliders;
+		return total;
+	}
+
+	size_t PhysicsCostEstimate::totalSolverRows() const
+	{
+		return generic.solverRows + stiffSpring.solverRows + coneTwist.solverRows;
+	}
+
+	PhysicsCostEstimate EstimatePhysicsCost(const ParsedNif& parsed, const std::string& xmlPath)
+	{
+		PhysicsCostEstimate estimate;
+
+		// A missing or malformed XML is the schema validator's to report.
+		std::string bytes = ReadDataFile(xmlPath);
+		pugi::xml_document doc;
+		if (!doc.load_buffer(bytes.data(), bytes.size()))
+			return estimate;
+		estimate.valid = true;
+
+		const auto definitions = ResolvePhysicsDefinitions(doc);
+
+		// The first declaration of a bone wins, like SkyrimSystemCreator's bone index.
+		std::unordered_map<std::string, bool> declaredDynamic;
+		for (const auto& node : definitions.nodes)
+			if (node.family == Family::Bone && !node.name.empty())
+				declaredDynamic.try_emplace(node.name, node.number("mass", 0) > 0);
+		const bool defaultDynamic = definitions.defaultBone.number("mass", 0) > 0;
+
+		std::unordered_set<std::string> usedBones;
+		auto isDynamic = [&](const std::string& bone) {
+			usedBones.insert(bone);
+			auto it = declaredDynamic.find(bone);
+			return it == declaredDynamic.end() ? defaultDynamic : it->second;
+		};
+
+		const auto nifShapes = ReadNifSkinnedShapes(parsed);
+		for (const auto& node : definitions.nodes) {
+			if (node.family != Family::PerVertex && node.family != Family::PerTriangle)
+				continue;
+
+			PhysicsShapeCost cost;
+			cost.name = node.name;
+			cost.perTriangle = node.family == Family::PerTriangle;
+
+			auto nifShape = std::find_if(nifShapes.begin(), nifShapes.end(), [&](const NifSkinnedShape& s) { return s.name == node.name; });
+			cost.foundInNif = nifShape != nifShapes.end();
+			if (!cost.foundInNif) {
+				estimate.shapes.push_back(std::move(cost));
+				continue;
+			}
+
+			ShapeBones bones;
+			for (const auto& boneName : nifShape->boneNames) {
+				bones.thresholds.push_back(node.number("weight-threshold@" + boneName, 0));
+				bones.dynamic.push_back(isDynamic(boneName));
+			}
+
+			std::vector<bool> used(nifShape->vertices.size(), false);
+			if (cost.perTriangle) {
+				auto tree = buildTriangleTree(*nifShape, bones, used);
+				measureTree(tree, cost);
+				tree.visit([&](const KeyTree& n, size_t) {
+					for (auto t : n.colliders) {
+						float k = 0;
+						for (auto v : nifShape->triangles[t])
+							k += flexible(nifShape->vertices[v], bones);
+						if (k / 3 >= FLT_EPSILON)
+							++cost.dynamicColliders;
+					}
+				});
+
+				PhysicsShapeCost vertexCost;
+				std::vector<bool> vertexUsed(nifShape->vertices.size(), false);
+				measureTree(buildVertexTree(*nifShape, bones, vertexUsed), vertexCost);
+				cost.vertexColliders = vertexCost.colliders;
+				for (size_t v = 0; v < used.size(); ++v)
+					used[v] = used[v] || vertexUsed[v];
+			} else {
+				auto tree = buildVertexTree(*nifShape, bones, used);
+				measureTree(tree, cost);
+				tree.visit([&](const KeyTree& n, size_t) {
+					for (auto v : n.colliders)
+						if (flexible(nifShape->vertices[v], bones) >= FLT_EPSILON)
+							++cost.dynamicColliders;
+				});
+			}
+
+			estimate.skinnedVertices += static_cast<size_t>(std::count(used.begin(), used.end(), true));
+			estimate.shapes.push_back(std::move(cost));
+		}
+
+		// Constraints between two kinematic bones are skipped by findBones.
+		for (const auto& node : definitions.nodes) {
+			PhysicsConstraintCost* group = nullptr;
+			size_t rows = 0;
+			switch (node.family) {
+			case Family::Generic:
+				group = &estimate.generic;
+				rows = genericAxisRows(node, "linear") + genericAxisRows(node, "angular");
+				break;
+			case Family::StiffSpring:
+				group = &estimate.stiffSpring;
+				rows = 1;
+				break;
+			case Family::ConeTwist:
+				group = &estimate.coneTwist;
+				rows = 5;  // point-to-point plus swing and twist limits
+				break;
+			default:
+				continue;
+			}
+
+			++group->constraints;
+			const bool dynamicA = isDynamic(node.bodyA);
+			const bool dynamicB = isDynamic(node.bodyB);
+			if (!dynamicA && !dynamicB)
+				++group->skipped;
+			else
+				group->solverRows += rows;
+		}
+
+		for (const auto& node : definitions.nodes)
+			if (node.family == Family::Bone && !node.name.empty())
+				usedBones.insert(node.name);
+		for (const auto& bone : usedBones) {
+			auto it = declaredDynamic.find(bone);
+			if (it == declaredDynamic.end() ? defaultDynamic : it->second)
+				++estimate.dynamicBones;
+			else
+				++estimate.kinematicBones;
+		}
+
+		size_t dynamicColliders = 0;
+		for (const auto& shape : estimate.shapes)
+			dynamicColliders += shape.dynamicColliders;
+
+		const double microseconds =
+			kSkinningPerVertex * static_cast<double>(estimate.skinnedVertices) +
+			kAabbPerCollider * static_cast<double>(estimate.totalColliders()) +
+			kNarrowPhasePerDynamicCollider * static_cast<double>(dynamicColliders) +
+			kIntegrationPerDynamicBone * static_cast<double>(estimate.dynamicBones) +
+			kSolverPerRowIteration * kSolverIterations * static_cast<double>(estimate.totalSolverRows());
+		estimate.msPerFrame = microseconds / 1000.0;
+
+		if (estimate.msPerFrame < 0.1)
+			estimate.costClass = PhysicsCostClass::Light;
+		else if (estimate.msPerFrame < 0.3)
+			estimate.costClass = PhysicsCostClass::Moderate;
+		else if (estimate.msPerFrame < 1.0)
+			estimate.costClass = PhysicsCostClass::Heavy;
+		else
+			estimate.costClass = PhysicsCostClass::Extreme;
+
+		return estimate;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace hdt
+{
+	struct ParsedNif;
+
+	// Rough cost classes of the per-frame estimate, so reports compare assets without
+	// pretending the model is precise.
+	enum class PhysicsCostClass
+	{
+		Light,     // under 0.1 ms per frame
+		Moderate,  // under 0.3 ms
+		Heavy,     // under 1 ms
+		Extreme    // 1 ms and above
+	};
+
+	const char* PhysicsCostClassName(PhysicsCostClass costClass);
+
+	// What SkyrimSystemCreator would build for one <per-vertex-shape> or
+	// <per-triangle-shape>: colliders left after weight-threshold clipping, and the
+	// shape of the ColliderTree once optimized.
+	struct PhysicsShapeCost
+	{
+		std::string name;
+		bool perTriangle = false;
+		bool foundInNif = false;
+		size_t colliders = 0;
+		size_t dynamicColliders = 0;    // colliders with at least one weight on a dynamic bone
+		size_t vertexColliders = 0;     // per-triangle shapes also build a per-vertex shape of their vertices
+		size_t treeNodes = 0;
+		size_t treeDepth = 0;
+		size_t maxLeafColliders = 0;
+		double meanLeafColliders = 0;  // over the nodes that hold colliders
+	};
+
+	struct PhysicsConstraintCost
+	{
+		size_t constraints = 0;
+		size_t skipped = 0;  // both ends kinematic: the runtime drops them
+		size_t solverRows = 0;
+	};
+
+	struct PhysicsCostEstimate
+	{
+		bool valid = false;  // false when the XML does not load
+		std::vector<PhysicsShapeCost> shapes;
+		size_t skinnedVertices = 0;
+		size_t dynamicBones = 0;
+		size_t kinematicBones = 0;
+		PhysicsConstraintCost generic;
+		PhysicsConstraintCost stiffSpring;
+		PhysicsConstraintCost coneTwist;
+		double msPerFrame = 0;  // one substep per frame, at the default 16 solver iterations
+		PhysicsCostClass costClass = PhysicsCostClass::Light;
+
+		size_t totalColliders() const;
+		size_t totalSolverRows() const;
+	};
+
+	// Static estimate of what the physics XML at `xmlPath` costs once applied to the
+	// NIF `parsed`. Mirrors the creator: shapes are matched to the NIF's skinned shapes
+	// by name, their colliders keyed by the bones of their vertices in weight order and
+	// clipped by the weight thresholds; bones are dynamic when their effective mass is
+	// positive, the skin bones the XML doesn't declare taking the unnamed bone-default.
+	// The per-frame figure weighs vertex skinning, AABB updates, narrow-phase work on
+	// dynamic colliders, rigid-body integration and solver rows with coarse constants:
+	// it ranks assets, it doesn't predict frame times.
+	PhysicsCostEstimate EstimatePhysicsCost(const ParsedNif& parsed, const std::string& xmlPath);
+}
@@ -0,0 +1,228 @@
+#include "hdtPhysicsStabilityLint.h"
+
+#include "../Utils/hdtDataFileSystem.h"
+#include "../Utils/hdtTemplateDefaults.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <sstream>
+#include <unordered_map>
+
+namespace hdt
+{
+	namespace
+	{
+		constexpr float kMaxMassRatio = 100.0f;
+		constexpr float kMinDistanceFactor = 0.01f;  // below it the spring pulls both bones onto each other
+
+		std::string formatNumber(float value)
+		{
+			std::ostringstream s;
+			s << value;
+			return s.str();
+		}
+
+		std::string subjectOf(const ResolvedPhysicsNode& node)
+		{
+			switch (node.family) {
+			case Family::Bone:
+				return "bone \"" + node.name + "\"";
+			case Family::Generic:
+				return "generic-constraint \"" + node.bodyA + "\" <-> \"" + node.bodyB + "\"";
+			case Family::StiffSpring:
+				return "stiffspring-constraint \"" + node.bodyA + "\" <-> \"" + node.bodyB + "\"";
+			case Family::ConeTwist:
+				return "conetwist-constraint \"" + node.bodyA + "\" <-> \"" + node.bodyB + "\"";
+			default:
+				return node.location;
+			}
+		}
+
+		// What the lint knows of the mass of a body: nothing when it comes from the shape.
+		struct BodyMass
+		{
+			std::optional<float> mass;
+			bool dynamic = false;
+		};
+
+		BodyMass bodyMassOf(const ResolvedPhysicsNode& bone)
+		{
+			const float mass = bone.number("mass", 0);
+			BodyMass out;
+			out.dynamic = mass > 0;
+			if (!(out.dynamic && bone.number("density", 0) > 0))
+				out.mass = mass;
+			return out;
+		}
+
+		class Linter
+		{
+		public:
+			Linter(const ResolvedPhysicsDefinitions& definitions, float timeStep) :
+				m_timeStep(timeStep),
+				m_defaultBone(bodyMassOf(definitions.defaultBone))
+			{
+				// The first declaration of a bone wins, like SkyrimSystemCreator's bone index.
+				for (const auto& node : definitions.nodes)
+					if (node.family == Family::Bone && !node.name.empty())
+						m_bones.try_emplace(node.name, bodyMassOf(node));
+			}
+
+			void lint(const ResolvedPhysicsNode& node)
+			{
+				switch (node.family) {
+				case Family::Bone:
+					lintBone(node);
+					break;
+				case Family::Generic:
+					lintMassRatio(node);
+					lintGeneric(node);
+					break;
+				case Family::StiffSpring:
+					lintMassRatio(node);
+					lintStiffSpring(node);
+					break;
+				case Family::ConeTwist:
+					lintMassRatio(node);
+					break;
+				default:
+					break;
+				}
+			}
+
+			std::vector<StabilityFinding> takeFindings() { return std::move(m_findings); }
+
+		private:
+			const BodyMass& massOf(const std::string& bone) const
+			{
+				auto it = m_bones.find(bone);
+				return it == m_bones.end() ? m_defaultBone : it->second;
+			}
+
+			void report(const ResolvedPhysicsNode& node, std::string message)
+			{
+				m_findings.push_back({ node.location, node.line, subjectOf(node), std::move(message) });
+			}
+
+			void lintBone(const ResolvedPhysicsNode& node)
+			{
+				for (const char* field : { "linearDamping", "angularDamping" }) {
+					const float damping = node.number(field, 0);
+					if (damping < 0 || damping > 1)
+						report(node, std::string(field) + " is " + formatNumber(damping) + ", outside [0, 1]; the rigid body clamps it to " +
+						                 formatNumber(std::clamp(damping, 0.0f, 1.0f)) + ".");
+				}
+			}
+
+			void lintMassRatio(const ResolvedPhysicsNode& node)
+			{
+				const auto& a = massOf(node.bodyA);
+				const auto& b = massOf(node.bodyB);
+				if (!a.dynamic || !b.dynamic || !a.mass || !b.mass)
+					return;
+
+				const float ratio = std::max(*a.mass, *b.mass) / std::min(*a.mass, *b.mass);
+				if (ratio > kMaxMassRatio)
+					report(node, "masses " + formatNumber(*a.mass) + " and " + formatNumber(*b.mass) + " differ by 1:" +
+					                 formatNumber(std::round(ratio)) + " (over 1:" + formatNumber(kMaxMassRatio) +
+					                 "); the iterative solver converges slowly on such pairs and the light body jitters.");
+			}
+
+			// The mass btGeneric6DofSpring2Constraint scales its linear springs by: the
+			// lighter of the dynamic bodies. nullopt when it can't be known offline.
+			std::optional<float> springMass(const ResolvedPhysicsNode& node) const
+			{
+				const auto& a = massOf(node.bodyA);
+				const auto& b = massOf(node.bodyB);
+				if ((a.dynamic && !a.mass) || (b.dynamic && !b.mass))
+					return std::nullopt;
+				if (a.dynamic && b.dynamic)
+					return std::min(*a.mass, *b.mass);
+				if (a.dynamic)
+					return a.mass;
+				if (b.dynamic)
+					return b.mass;
+				return std::nullopt;
+			}
+
+			void lintGeneric(const ResolvedPhysicsNode& node)
+			{
+				static const char* const axes[] = { "x", "y", "z" };
+				for (const char* prefix : { "linear", "angular" }) {
+					const std::string p = prefix;
+					const auto lower = node.vector3(p + "LowerLimit", { 1, 1, 1 });
+					const auto upper = node.vector3(p + "UpperLimit", { -1, -1, -1 });
+					for (size_t axis = 0; axis < 3; ++axis) {
+						if (lower[axis] > upper[axis] && !(lower[axis] == 1 && upper[axis] == -1))
+							report(node, p + "LowerLimit." + axes[axis] + " (" + formatNumber(lower[axis]) + ") is above " + p +
+							                 "UpperLimit." + axes[axis] + " (" + formatNumber(upper[axis]) +
+							                 "): Bullet leaves the axis free. Swap them if a range was meant.");
+					}
+				}
+
+				const auto mass = springMass(node);
+				if (!mass || !node.flag("enableLinearSprings", true) || m_timeStep <= 0)
+					return;
+
+				// btGeneric6DofSpring2Constraint keeps a spring stable while
+				// sqrt(k / m) * dt <= 0.25 and kd * dt <= m.
+				const float maxStiffness = *mass / (16 * m_timeStep * m_timeStep);
+				const float maxDamping = *mass / m_timeStep;
+				const bool stiffnessLimited = node.flag("linearStiffnessLimited", true);
+				const bool dampingLimited = node.flag("springDampingLimited", true);
+				const auto lower = node.vector3("linearLowerLimit", { 1, 1, 1 });
+				const auto upper = node.vector3("linearUpperLimit", { -1, -1, -1 });
+				const auto stiffness = node.vector3("linearStiffness", { 0, 0, 0 });
+				const auto damping = node.vector3("linearDamping", { 0, 0, 0 });
+				for (size_t axis = 0; axis < 3; ++axis) {
+					if (lower[axis] == upper[axis])
+						continue;  // locked: the spring never acts
+					const std::string at = std::string(".") + axes[axis];
+					if (stiffness[axis] > maxStiffness)
+						report(node, "linearStiffness" + at + " " + formatNumber(stiffness[axis]) + " exceeds " + formatNumber(maxStiffness) +
+						                 ", the stable stiffness for mass " + formatNumber(*mass) + " at the " + formatNumber(m_timeStep * 1000) + " ms step; " +
+						                 (stiffnessLimited ? "Bullet clamps it, so the excess has no effect." : "with linearStiffnessLimited off, the spring diverges."));
+					if (stiffness[axis] > 0 && damping[axis] > maxDamping)
+						report(node, "linearDamping" + at + " " + formatNumber(damping[axis]) + " exceeds " + formatNumber(maxDamping) +
+						                 ", the stable damping for mass " + formatNumber(*mass) + " at the " + formatNumber(m_timeStep * 1000) + " ms step; " +
+						                 (dampingLimited ? "Bullet clamps it, so the excess has no effect." : "with springDampingLimited off, the spring overshoots."));
+				}
+			}
+
+			void lintStiffSpring(const ResolvedPhysicsNode& node)
+			{
+				const float minFactor = std::max(node.number("minDistanceFactor", 1), 0.0f);
+				const float maxFactor = std::max(node.number("maxDistanceFactor", 1), 0.0f);
+				if (maxFactor < kMinDistanceFactor)
+					report(node, "maxDistanceFactor " + formatNumber(maxFactor) +
+					                 " pulls both bones onto each other; at zero distance the constraint has no direction and"
+					                 " drops its row, so the bones snap in and out of it.");
+				else if (minFactor > maxFactor)
+					report(node, "minDistanceFactor " + formatNumber(minFactor) + " is above maxDistanceFactor " + formatNumber(maxFactor) +
+					                 "; no distance satisfies both limits, so the constraint fights itself every step.");
+			}
+
+			float m_timeStep;
+			BodyMass m_defaultBone;
+			std::unordered_map<std::string, BodyMass> m_bones;
+			std::vector<StabilityFinding> m_findings;
+		};
+	}  // namespace
+
+	std::vector<StabilityFinding> LintPhysicsStability(const std::string& xmlPath, float timeStep)
+	{
+		std::string bytes = ReadDataFile(xmlPath);
+		pugi::xml_document doc;
+		if (bytes.empty() || !doc.load_buffer(bytes.data(), bytes.size()))
+			return {};
+
+		const auto definitions = ResolvePhysicsDefinitions(doc, &bytes);
+		Linter linter(definitions, timeStep);
+		for (const auto& node : definitions.nodes)
+			linter.lint(node);
+		return linter.takeFindings();
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace hdt
+{
+	// One schema-valid setting that the solver handles badly. `location` and `line` point
+	// at the bone or constraint instance; the value may come from its template.
+	struct StabilityFinding
+	{
+		std::string location;
+		int line = 0;
+		std::string subject;  // e.g. generic-constraint "Bone1" <-> "Bone2"
+		std::string message;
+	};
+
+	// Lint the template-resolved bones and constraints of one physics XML (see
+	// ResolvePhysicsDefinitions) for numerically unstable settings:
+	//   - constraints between dynamic bodies whose masses differ by more than 1:100;
+	//   - stiffspring constraints whose rest length collapses to (nearly) zero, where
+	//     StiffSpringConstraint::getInfo1 drops its row, or whose min/max factors cross;
+	//   - generic-constraint axes with lower > upper other than the default "free"
+	//     (1, -1) pair: Bullet frees the axis, which usually means swapped limits;
+	//   - linear springs stiffer or more damped than btGeneric6DofSpring2Constraint
+	//     handles at `timeStep` (it clamps them when the *Limited flags are set, and
+	//     goes unstable otherwise);
+	//   - bone damping outside [0, 1], which btRigidBody clamps.
+	// Bones whose mass comes from their shape (density) are left out of the mass-based
+	// checks, as are angular springs, whose inertia is not known offline. Returns empty
+	// when the XML is missing or malformed: that is the schema validator's to report.
+	std::vector<StabilityFinding> LintPhysicsStability(const std::string& xmlPath, float timeStep);
+}
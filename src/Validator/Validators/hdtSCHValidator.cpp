@@ -3,9 +3,11 @@
 #include "../Config/hdtValidatorPaths.h"
 #include "../Parser/hdtSCHSchemaParser.h"
 #include "../Schema/hdtSCHSchemaModel.h"
+#include "../Utils/hdtDataFileSystem.h"
 #include "../Utils/hdtStringUtils.h"
+#include "../Utils/hdtValidatorLog.h"
 #include "../Utils/hdtXMLUtils.h"
-#include "NetImmerseUtils.h"
+#include "hdtFileUtils.h"
 
 #include <pugixml.hpp>
 
@@ -35,7 +37,7 @@ namespace hdt
 	{
 		std::call_once(g_schemaOnce, []() {
 			// Schema files are always on disk; direct filesystem read is correct here.
-			std::string bytes = readAllFile2(kPhysicsSCHPath);
+			std::string bytes = readAllFile2(PathToUtf8(ResolvePathCase(kPhysicsSCHPath)).c_str());
 
 			if (bytes.empty()) {
 				logger::warn(
@@ -78,7 +80,7 @@ namespace hdt
 			return result;
 
 		// Physics XML configs are always loose files on disk, never BSA-packed.
-		std::string bytes = readAllFile2(xmlPath.c_str());
+		std::string bytes = ReadDataFile(xmlPath);
 		if (bytes.empty())
 			return result;  // File-not-found is reported by the XSD validator
 
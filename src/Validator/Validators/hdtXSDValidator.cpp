@@ -3,8 +3,9 @@
 #include "../Config/hdtValidatorPaths.h"
 #include "../Parser/hdtXSDSchemaParser.h"
 #include "../Schema/hdtXSDSchemaModel.h"
+#include "../Utils/hdtDataFileSystem.h"
 #include "../Utils/hdtStringUtils.h"
-#include "NetImmerseUtils.h"
+#include "../Utils/hdtValidatorLog.h"
 #include "XmlReader.h"
 
 #include <pugixml.hpp>
@@ -33,7 +34,7 @@ namespace hdt
 			// Use load_file (direct filesystem) only: schema files are always on disk
 			// and readAllFile (BSA VFS) is unsafe before BSAs are mounted during SKSEPlugin_Load.
 			pugi::xml_document doc;
-			auto res = doc.load_file(kPhysicsXSDPath);
+			auto res = doc.load_file(ResolvePathCase(kPhysicsXSDPath).c_str());
 
 			if (!res) {
 				logger::error(
@@ -185,6 +186,13 @@ namespace hdt
 				continue;
 			}
 
+			// A plain text value under this parent, whatever the tag is elsewhere.
+			const auto textIt = schema.textChildren.find(parentTag);
+			if (textIt != schema.textChildren.end() && textIt->second.count(tag)) {
+				reader.readText();
+				continue;
+			}
+
 			// Generic key/keyref tracking (XSD-driven referential integrity).
 			for (const auto& [kn, kd] : schema.keyDefs) {
 				if (kd.elems.count(tag) && reader.hasAttribute(kd.fieldAttr))
@@ -304,7 +312,7 @@ namespace hdt
 		}
 
 		// Physics XML configs are always loose files on disk, never BSA-packed.
-		auto bytes = readAllFile2(xmlPath.c_str());
+		auto bytes = ReadDataFile(xmlPath);
 
 		if (bytes.empty()) {
 			result.isValid = false;
@@ -1,59 +1,13 @@
 #pragma once
 
+#include "hdtAssetValidatorCore.h"
+
 #include <string>
-#include <vector>
 
+// In-game entry points of the validator: the console commands run the core pipeline
+// (hdtAssetValidatorCore.h) against the live game and write to the SKSE log directory.
 namespace hdt
 {
-	// ── Config ────────────────────────────────────────────────────────────────
-
-	struct ValidationConfig
-	{
-		std::string modsDir;  // mods folder (MO2 mods/ or Vortex staging) scanned natively, bypassing the VFS
-	};
-
-	extern ValidationConfig g_validationConfig;
-
-	// ── Shared asset type ─────────────────────────────────────────────────────
-
-	struct PhysicsAsset
-	{
-		std::string nifPath;
-		std::string xmlPath;
-		std::vector<std::string> relatedTRIPaths;
-		std::vector<std::string> allPhysicsXmlPaths;  // all "HDT Skinned Mesh Physics Object" blocks
-		bool nifExists = false;
-		bool xmlExists = false;
-		bool hasOrphanedPhysicsMarker = false;  // marker string present but no NiStringExtraData block
-	};
-
-	// ── Validation ────────────────────────────────────────────────────────────
-
-	enum class ValidationReportMode
-	{
-		Full,
-		ErrorsOnly
-	};
-
-	struct AssetValidationResult
-	{
-		bool hasErrors = false;
-		bool hasWarnings = false;
-		int skinMeshIssuesFound = 0;
-		int filesystemNifFilesDiscovered = 0;
-		int equippedNifsDiscovered = 0;
-		int nifScanViolationCount = 0;
-		int totalNIFsScanned = 0;
-		int totalXMLsFound = 0;
-		int xmlPassCount = 0;
-		int xmlErrorCount = 0;
-		int xmlWarningCount = 0;
-		double elapsedSeconds = 0.0;
-		std::vector<std::string> errors;
-		std::vector<std::string> warnings;
-		std::vector<PhysicsAsset> assets;
-	};
-
 	// Run validation from the console command path.
 	// When equippedOnly is true, validates only currently equipped items on tracked
 	// skeletons (PC and instantiated NPCs).
@@ -65,4 +19,18 @@ namespace hdt
 		bool equippedOnly = false,
 		ValidationReportMode reportMode = ValidationReportMode::Full);
 
+	// Run the template redundancy rewrites (see OptimizePhysicsXml) over every physics
+	// XML the full validation covers, from the console command path. The optimized copies
+	// go to a new timestamped directory in the SKSE log directory, mirroring their paths
+	// below data/, with an optimization_summary.log listing every edit; the originals are
+	// never modified. Populates outOutputDir with that directory (empty on failure).
+	XmlOptimizationResult OptimizePhysicsXmls(std::string& outOutputDir);
+
+	// Repair the skin meshes of every physics NIF (see RunNifRepairCore) from the console
+	// command path, into a new timestamped directory in the SKSE log directory mirroring
+	// their paths below data/, with a repair_summary.log; the originals are never
+	// modified. With dryRun only the summary is written. Populates outOutputDir with that
+	// directory (empty on failure).
+	NifRepairResult RepairSkinMeshNifs(std::string& outOutputDir, bool dryRun = false);
+
 }  // namespace hdt
@@ -0,0 +1,1933 @@
+#include "hdtAssetValidatorCore.h"
+
+#ifdef _WIN32
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#endif
+#include "Config/hdtValidatorPaths.h"
+#include "Improvers/hdtNIFBinaryIO.h"
+#include "Improvers/hdtNIFOrphanedSkinImprover.h"
+#include "Improvers/hdtNIFSkinMeshRepairer.h"
+#include "Improvers/hdtNIFSkinMeshValidator.h"
+#include "Improvers/hdtPhysicsXMLOptimizer.h"
+#include "Utils/hdtConcurrencyUtils.h"
+#include "Utils/hdtDataFileSystem.h"
+#include "Utils/hdtNIFBinaryUtils.h"
+#include "Utils/hdtNIFSkinReader.h"
+#include "Utils/hdtParsedNifStore.h"
+#include "Utils/hdtStringUtils.h"
+#include "Utils/hdtTemplateDefaults.h"
+#include "Utils/hdtTimeUtils.h"
+#include "Utils/hdtValidatorLog.h"
+#include "Utils/hdtXMLUtils.h"
+#include "Validators/hdtCollisionMeshAudit.h"
+#include "Validators/hdtNIFBoneRefValidator.h"
+#include "Validators/hdtNIFPairDiff.h"
+#include "Validators/hdtNIFValidator.h"
+#include "Validators/hdtPhysicsCostEstimator.h"
+#include "Validators/hdtPhysicsStabilityLint.h"
+#include "Validators/hdtSCHValidator.h"
+#include "Validators/hdtXSDValidator.h"
+
+#include <pugixml.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace hdt
+{
+
+	// ═══════════════════════════════════════════════════════════════════════════════
+	// §1  Global state
+	// ═══════════════════════════════════════════════════════════════════════════════
+
+	ValidationConfig g_validationConfig;
+
+	// ═══════════════════════════════════════════════════════════════════════════════
+	// §2  Violation classifiers
+	//     Pure predicates on XSD/SCH violation objects — no I/O, no side effects.
+	//     Order: XSD helpers, then SCH helpers, each group ending with the
+	//     aggregate hasBlocking* check that the pipeline uses as a gate.
+	// ═══════════════════════════════════════════════════════════════════════════════
+
+	// Lazy-loads (once) the set of XSD element names typed "factor".
+	// Used to decide whether an out-of-range SCH violation is a silent runtime
+	// clamp rather than a genuine error — only [0,1]-bounded factor elements qualify.
+	static const std::unordered_set<std::string>& getUnitFactorElementNamesFromXsd()
+	{
+		static std::once_flag once;
+		static std::unordered_set<std::string> names;
+
+		std::call_once(once, []() {
+			pugi::xml_document doc;
+			auto loadResult = doc.load_file(kPhysicsXSDPath);
+			if (!loadResult) {
+				logger::warn("[Validator] Could not load XSD from '{}': {}; [0,1] factor detection disabled.",
+					kPhysicsXSDPath, loadResult.description());
+				return;
+			}
+
+			auto schema = doc.child("xsd:schema");
+			if (!schema)
+				schema = doc.child("schema");
+			if (!schema) {
+				logger::warn("[Validator] Could not find schema root in '{}'; [0,1] factor detection disabled.",
+					kPhysicsXSDPath);
+				return;
+			}
+
+			for (auto element : schema.children()) {
+				if (StripXmlNamespacePrefix(element.name()) != "element")
+					continue;
+
+				auto typeName = StripXmlNamespacePrefix(element.attribute("type").as_string());
+				if (typeName != "factor")
+					continue;
+
+				std::string elementName = element.attribute("name").as_string();
+				if (!elementName.empty())
+					names.insert(std::move(elementName));
+			}
+
+			logger::info("[Validator] Loaded {} unit-factor element name(s) from XSD.", names.size());
+		});
+
+		return names;
+	}
+
+	static bool isIgnoredDisallowedChildTagViolation(const XSDViolation& v)
+	{
+		return v.message.find(" is not allowed inside <") != std::string::npos;
+	}
+
+	static bool isIgnoredInvalidSharedValueViolation(const XSDViolation& v)
+	{
+		return v.message.find("<shared> has invalid value '") != std::string::npos;
+	}
+
+	static bool isNonBlockingXsdViolation(const XSDViolation& v)
+	{
+		return isIgnoredDisallowedChildTagViolation(v) || isIgnoredInvalidSharedValueViolation(v);
+	}
+
+	static bool hasBlockingXsdErrors(const XSDValidationResult& xsd)
+	{
+		return std::any_of(xsd.violations.begin(), xsd.violations.end(), [](const XSDViolation& v) {
+			return !isNonBlockingXsdViolation(v);
+		});
+	}
+
+	static bool isOutOfRangeUnitFactorSchViolation(const SCHViolation& v)
+	{
+		// Check if message indicates [0,1] range violation
+		const bool isUnitRangeMessage =
+			v.message.find("value '") != std::string::npos &&
+			v.message.find("is out of range: must be in [0, 1].") != std::string::npos;
+		if (!isUnitRangeMessage)
+			return false;
+
+		auto elementName = ExtractElementNameFromSchLocation(v.location);
+		if (elementName.empty())
+			return false;
+
+		const auto& factorNames = getUnitFactorElementNamesFromXsd();
+		return factorNames.find(elementName) != factorNames.end();
+	}
+
+	static bool isRedundantDefaultValueSchWarning(const SCHViolation& v)
+	{
+		return v.role == SCHRole::Warning &&
+		       v.message.find("is set to its default value") != std::string::npos;
+	}
+
+	static bool hasBlockingSchErrors(const SCHValidationResult& sch)
+	{
+		return std::any_of(sch.violations.begin(), sch.violations.end(), [](const SCHViolation& v) {
+			return v.role == SCHRole::Error && !isOutOfRangeUnitFactorSchViolation(v);
+		});
+	}
+
+	// ═══════════════════════════════════════════════════════════════════════════════
+	// §3  Report helpers
+	//     Build report content.  Order: per-XML violation formatter → parallel
+	//     batch validator → errors-only formatter.  Writing it out is the host's.
+	// ═══════════════════════════════════════════════════════════════════════════════
+
+	using XMLValidationPair = std::pair<XSDValidationResult, SCHValidationResult>;
+
+	// The two flavours of template redundancy reported for one XML file: per-element
+	// tags that restate an inherited default, and whole <bone> declarations that only
+	// restate the auto-created default bone.
+	struct XmlRedundancyInfo
+	{
+		std::vector<TemplateRedundantChildInfo> redundantChildren;
+		std::vector<RedundantBoneInfo> redundantBones;
+	};
+
+	// Load xmlPath once and collect both redundancy flavours from the parsed
+	// document. The per-element info lets appendXmlViolationsToReport cross-reference SCH
+	// default-value warnings against actual runtime-effective template inheritance — a
+	// warning is suppressed when the tag is not redundant relative to the inherited
+	// template — while the bone info drives the redundant-<bone> warnings directly.
+	static XmlRedundancyInfo collectXmlRedundancyInfo(const std::string& xmlPath)
+	{
+		XmlRedundancyInfo result;
+
+		std::string bytes = ReadDataFile(xmlPath);
+		if (bytes.empty())
+			return result;
+
+		pugi::xml_document doc;
+		auto parseResult = doc.load_buffer(bytes.data(), bytes.size());
+		if (!parseResult)
+			return result;
+
+		result.redundantChildren = CollectTemplateRedundantChildrenInfo(doc, &bytes);
+		result.redundantBones = CollectRedundantBoneDeclarations(doc, &bytes);
+		return result;
+	}
+
+	/// Appends XSD violations, SCH violations, and template-redundant warnings for one XML
+	/// file to both the structured report and the text stream.
+	/// Callers must have already written a context line (e.g. "[OK]" or "-> xmlPath") to out.
+	static void appendXmlViolationsToReport(const XMLValidationPair& pair, const std::string& xmlPath,
+		AssetValidationResult& report, std::ostream& out, float timeStep)
+	{
+		const auto& [xsdResult, schResult] = pair;
+		const auto redundancyInfo = collectXmlRedundancyInfo(xmlPath);
+		std::unordered_map<std::string, TemplateRedundantChildInfo> templateRedundantByLocation;
+		for (const auto& info : redundancyInfo.redundantChildren)
+			templateRedundantByLocation[info.location] = info;
+		std::unordered_set<std::string> emittedTemplateRedundantLocations;
+
+		auto emitTemplateRedundantWarning = [&](const TemplateRedundantChildInfo& info) {
+			if (info.shadowedByLaterFrameTag) {
+				std::string msg = xmlPath + ":" + std::to_string(info.line) + ": " + info.location +
+				                  " - " + info.tagName + " is shadowed by later " + info.shadowingTagName +
+				                  " in the same constraint/default block and has no effect. This tag is unnecessary and can be removed.";
+				report.warnings.push_back(msg);
+				report.hasWarnings = true;
+				out << "    [WARNING] " << info.location << " (line " << info.line << "): "
+					<< info.tagName << " is shadowed by later " << info.shadowingTagName
+					<< " in the same constraint/default block and has no effect; this tag can be removed.\n";
+				return;
+			}
+
+			std::string msg = xmlPath + ":" + std::to_string(info.line) + ": " + info.location +
+			                  " - " + info.tagName +
+			                  " is set to the effective inherited default value. This tag is unnecessary and can be removed.";
+			report.warnings.push_back(msg);
+			report.hasWarnings = true;
+			out << "    [WARNING] " << info.location << " (line " << info.line << "): "
+				<< info.tagName
+				<< " is set to the effective inherited default value. This tag is unnecessary and can be removed.\n";
+		};
+
+		for (const auto& v : xsdResult.violations) {
+			if (isIgnoredDisallowedChildTagViolation(v)) {
+				std::string msg = xmlPath + ":" + std::to_string(v.line) + ": " +
+				                  v.elementPath + " - " + v.message + " This tag will be ignored.";
+				report.warnings.push_back(msg);
+				report.hasWarnings = true;
+				out << "    [WARNING] " << v.elementPath << " (line " << v.line << "): "
+					<< v.message << "; this tag will be ignored." << "\n";
+				continue;
+			}
+
+			if (isIgnoredInvalidSharedValueViolation(v)) {
+				std::string msg = xmlPath + ":" + std::to_string(v.line) + ": " +
+				                  v.elementPath + " - " + v.message +
+				                  " This value will be ignored and replaced by the default value ('public').";
+				report.warnings.push_back(msg);
+				report.hasWarnings = true;
+				out << "    [WARNING] " << v.elementPath << " (line " << v.line << "): "
+					<< v.message << "; this value will be ignored and replaced by the default value ('public')." << "\n";
+				continue;
+			}
+
+			std::string msg = xmlPath + ":" + std::to_string(v.line) + ": " +
+			                  v.elementPath + " - " + v.message;
+			report.errors.push_back(msg);
+			out << "    [ERROR] " << v.elementPath << " (line " << v.line << "): "
+				<< v.message << "\n";
+		}
+
+		for (const auto& v : schResult.violations) {
+			if (isOutOfRangeUnitFactorSchViolation(v)) {
+				auto clampTarget = ExtractOutOfRangeClampTarget(v.message);
+				std::string warningMsg = xmlPath + ":" + std::to_string(v.line) + ": " +
+				                         v.location + " - " + v.message +
+				                         " Runtime clamps this value to [0, 1]; effective value will be '" +
+				                         clampTarget + "'.";
+				report.warnings.push_back(warningMsg);
+				report.hasWarnings = true;
+				out << "    [WARNING] " << v.location << " (line " << v.line << "): "
+					<< v.message << "; runtime clamps this value to [0, 1], so the effective value will be '"
+					<< clampTarget << "'.\n";
+				continue;
+			}
+
+			if (isRedundantDefaultValueSchWarning(v) &&
+				templateRedundantByLocation.find(v.location) == templateRedundantByLocation.end()) {
+				// This warning was matched against theoretical XSD defaults, but the tag is
+				// not redundant relative to the effective inherited template at runtime.
+				continue;
+			}
+			if (isRedundantDefaultValueSchWarning(v))
+				emittedTemplateRedundantLocations.insert(v.location);
+
+			std::string msg = xmlPath + ":" + std::to_string(v.line) + ": " +
+			                  v.location + " - " + v.message;
+			if (v.role == SCHRole::Error) {
+				report.errors.push_back(msg);
+				out << "    [ERROR] " << v.location << " (line " << v.line << "): "
+					<< v.message << "\n";
+			} else {
+				report.warnings.push_back(msg);
+				report.hasWarnings = true;
+				out << "    [WARNING] " << v.location << " (line " << v.line << "): "
+					<< v.message << "\n";
+			}
+		}
+
+		for (const auto& [location, info] : templateRedundantByLocation) {
+			if (emittedTemplateRedundantLocations.find(location) != emittedTemplateRedundantLocations.end())
+				continue;
+
+			emitTemplateRedundantWarning(info);
+		}
+
+		// Whole <bone> declarations that only restate the auto-created default bone:
+		// the engine would fabricate an identical body on demand, so the declaration
+		// is removable. See CollectRedundantBoneDeclarations for the comparison.
+		for (const auto& bone : redundancyInfo.redundantBones) {
+			const std::string named = bone.boneName.empty() ? std::string() : " \"" + bone.boneName + "\"";
+			std::string msg = xmlPath + ":" + std::to_string(bone.line) + ": " + bone.location +
+			                  " - <bone>" + named +
+			                  " only restates the default bone settings; the engine creates an"
+			                  " identical bone on demand, so this declaration is unnecessary and can be removed.";
+			report.warnings.push_back(msg);
+			report.hasWarnings = true;
+			out << "    [WARNING] " << bone.location << " (line " << bone.line << "): <bone>" << named
+				<< " only restates the default bone settings; the engine creates an identical bone on"
+				   " demand, so this declaration can be removed.\n";
+		}
+
+		// Schema-valid but numerically unstable settings, judged on the effective
+		// (template-applied) values at the host's physics step.
+		for (const auto& f : LintPhysicsStability(xmlPath, timeStep)) {
+			std::string msg = xmlPath + ":" + std::to_string(f.line) + ": " + f.location + " - " + f.subject + ": " + f.message;
+			report.warnings.push_back(msg);
+			report.hasWarnings = true;
+			out << "    [WARNING] " << f.location << " (line " << f.line << "): " << f.subject << ": " << f.message << "\n";
+		}
+	}
+
+	/// Validates multiple XML files in parallel, running both XSD and SCH validators on each.
+	/// Both validators use std::once_flag-protected schema loading, making this thread-safe.
+	/// Results are returned in the same order as input paths.
+	static std::vector<XMLValidationPair> parallelValidateXMLs(const std::vector<std::string>& paths)
+	{
+		std::vector<XMLValidationPair> results(paths.size());
+		ParallelForChunks(paths.size(), [&](size_t begin, size_t end) {
+			for (size_t j = begin; j < end; ++j)
+				results[j] = { ValidatePhysicsXMLWithXSD(paths[j]), ValidatePhysicsXMLWithSchematron(paths[j]) };
+		});
+		return results;
+	}
+
+	std::string BuildErrorsOnlyReport(
+		const AssetValidationResult& report,
+		const std::string& timestamp,
+		bool equippedOnly)
+	{
+		std::ostringstream reportStream;
+		reportStream << "========================================\n";
+		if (equippedOnly) {
+			reportStream << "FSMP Equipped Gear Validation Report (Errors Only)\n";
+		} else {
+			reportStream << "FSMP Asset Validation Report (Errors Only)\n";
+		}
+		reportStream << "Generated: " << timestamp << "\n";
+		reportStream << "========================================\n\n";
+
+		reportStream << "== Summary ==\n";
+		reportStream << "  Duration:      " << std::fixed << std::setprecision(2) << report.elapsedSeconds << "s\n";
+		reportStream << "  XMLs found:    " << report.totalXMLsFound << "\n";
+		reportStream << "  XMLs failed:   " << report.xmlErrorCount << "\n";
+		reportStream << "  Errors:        " << report.errors.size() << "\n\n";
+
+		reportStream << "== Errors ==\n";
+		if (report.errors.empty()) {
+			reportStream << "  [OK] No errors found.\n";
+		} else {
+			for (const auto& e : report.errors)
+				reportStream << "  [ERROR] " << e << "\n";
+		}
+
+		reportStream << "\n========================================\n";
+		return reportStream.str();
+	}
+
+	// ═══════════════════════════════════════════════════════════════════════════════
+	// §4  Discovery
+	//     Locate assets, loose or packed.  Order: file-system leaf helpers → BBP discovery →
+	//     NIF scanners (private to discoverPhysicsAssets) → discoverPhysicsAssets.
+	//     Equipped gear is discovered by the in-game host.
+	// ═══════════════════════════════════════════════════════════════════════════════
+
+	/// Discovers TRI collision files related to a given NIF.
+	/// TRI files are canonical and not weight-variant split:
+	///   - foo.nif       -> foo.tri
+	///   - foo_0.nif     -> foo.tri
+	///   - foo_1.nif     -> foo.tri
+	static std::vector<std::string> discoverRelatedTRIFiles(const std::string& nifPath)
+	{
+		namespace fs = std::filesystem;
+		auto hasSuffix = [](const std::string& s, const char* suffix) {
+			const size_t n = std::char_traits<char>::length(suffix);
+			return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+		};
+
+		std::vector<std::string> result;
+		std::unordered_set<std::string> seen;
+
+		fs::path nifFsPath = nifPath;
+		if (!nifFsPath.has_extension())
+			return result;
+
+		auto ext = PathToUtf8(nifFsPath.extension());
+		std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+		if (ext != ".nif")
+			return result;
+
+		const fs::path parent = nifFsPath.parent_path();
+		const std::string stem = PathToUtf8(nifFsPath.stem());
+
+		std::string triStem = stem;
+		if (stem.size() > 2 && (hasSuffix(stem, "_0") || hasSuffix(stem, "_1")))
+			triStem = stem.substr(0, stem.size() - 2);
+
+		std::vector<fs::path> candidates;
+		candidates.push_back(parent / (triStem + ".tri"));
+
+		for (const auto& candidate : candidates) {
+			auto location = LocateDataFile(PathToUtf8(candidate));
+			if (!location.exists)
+				continue;
+
+			auto norm = NormalizePathForComparison(location.path);
+			if (seen.insert(norm).second)
+				result.push_back(std::move(location.path));
+		}
+
+		return result;
+	}
+
+	struct DefaultBBPEntry
+	{
+		std::string shape;    // shape name from <map shape="...">
+		std::string xmlPath;  // resolved path (data/...)
+		std::string xmlArchive;  // archive it is packed in; empty when loose
+		bool xmlExists = false;
+	};
+
+	// Parse defaultBBPs.xml and resolve the file path of each <map> entry.
+	static std::vector<DefaultBBPEntry> discoverDefaultBBPXMLs()
+	{
+		std::vector<DefaultBBPEntry> result;
+		namespace fs = std::filesystem;
+
+		const auto bbpFile = LocateDataFile("data/SKSE/Plugins/hdtSkinnedMeshConfigs/defaultBBPs.xml");
+		if (!bbpFile.exists) {
+			logger::info("[Validator] defaultBBPs.xml not found at {}, skipping Phase 0",
+				bbpFile.path);
+			return result;
+		}
+
+		pugi::xml_document doc;
+		std::string bbpBytes = ReadDataFile(bbpFile.path);
+		auto parseResult = doc.load_buffer(bbpBytes.data(), bbpBytes.size());
+		if (!parseResult) {
+			logger::warn("[Validator] Failed to parse defaultBBPs.xml: {}",
+				parseResult.description());
+			return result;
+		}
+
+		for (auto& map : doc.child("default-bbps").children("map")) {
+			std::string shape = map.attribute("shape").as_string();
+			std::string rawFile = map.attribute("file").as_string();
+			if (shape.empty() || rawFile.empty())
+				continue;
+
+			// Normalise path separators
+			std::replace(rawFile.begin(), rawFile.end(), '\\', '/');
+
+			// Try "data/<path>" first, then as-is (in case it's already absolute or
+			// differently rooted), loose before packed.
+			DefaultBBPEntry entry;
+			entry.shape = shape;
+
+			auto location = LocateDataFile("data/" + rawFile);
+			if (!location.exists) {
+				if (auto asIs = LocateDataFile(rawFile); asIs.exists)
+					location = std::move(asIs);
+			}
+			entry.xmlPath = std::move(location.path);
+			entry.xmlArchive = std::move(location.archive);
+			entry.xmlExists = location.exists;
+
+			result.push_back(std::move(entry));
+		}
+
+		return result;
+	}
+
+	// Portable recursive NIF walk: the VFS scan of data/ in game, and the only scan
+	// outside Windows.
+	static void findNifsRecursive(const std::filesystem::path& dir,
+		std::vector<std::string>& out)
+	{
+		namespace fs = std::filesystem;
+		std::error_code ec;
+		for (auto& entry : fs::recursive_directory_iterator(
+				 dir,
+				 fs::directory_options::skip_permission_denied,
+				 ec)) {
+			if (ec) {
+				ec.clear();
+				continue;
+			}
+			if (!entry.is_regular_file(ec) || ec) {
+				ec.clear();
+				continue;
+			}
+			auto ext = PathToUtf8(entry.path().extension());
+			std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+			if (ext != ".nif")
+				continue;
+			try {
+				out.push_back(PathToUtf8(entry.path()));
+			} catch (...) {}
+		}
+	}
+
+#ifdef _WIN32
+	// ── Win32 NIF scanner (native NTFS, no VFS) ──────────────────────────────
+	// Two passes per directory:
+	//   Pass 1  *.nif + FindExSearchNameMatch        → NTFS returns NIF files only
+	//   Pass 2  *     + FindExSearchLimitToDirectories → NTFS returns dirs only
+	//
+	// This is effective on the native filesystem where NTFS applies the filter at
+	// the driver level. It is ineffective through MO2's VFS because the VFS hook
+	// enumerates all entries before applying the pattern.
+	static void findNifsNative(const std::filesystem::path& dir,
+		std::vector<std::string>& out)
+	{
+		// Single pass: enumerate all entries, collect NIFs and recurse into dirs.
+		// Previously used two passes (*.nif + FindExSearchLimitToDirectories) but
+		// FindExSearchLimitToDirectories is advisory and ignored by NTFS — Pass 2
+		// enumerated all files anyway, doubling the I/O cost on animation mods.
+		// One pass with FIND_FIRST_EX_LARGE_FETCH is faster overall.
+		const std::wstring dirW = dir.wstring();
+		WIN32_FIND_DATAW fd;
+
+		HANDLE h = FindFirstFileExW((dirW + L"\\*").c_str(),
+			FindExInfoBasic, &fd,
+			FindExSearchNameMatch,
+			nullptr, FIND_FIRST_EX_LARGE_FETCH);
+		if (h == INVALID_HANDLE_VALUE)
+			return;
+
+		do {
+			if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+				if (fd.cFileName[0] != L'.')
+					findNifsNative(dir / fd.cFileName, out);
+			} else {
+				// Check for .nif extension (case-insensitive)
+				const wchar_t* name = fd.cFileName;
+				const wchar_t* dot = wcsrchr(name, L'.');
+				if (dot && _wcsicmp(dot, L".nif") == 0) {
+					try {
+						out.push_back(PathToUtf8(dir / name));
+					} catch (...) {}
+				}
+			}
+		} while (FindNextFileW(h, &fd));
+
+		FindClose(h);
+	}
+#else
+	// Without a VFS to bypass, the portable walk is the native one.
+	static void findNifsNative(const std::filesystem::path& dir,
+		std::vector<std::string>& out)
+	{
+		findNifsRecursive(dir, out);
+	}
+#endif
+
+	/// One line per node reference a skeleton does not provide, naming the affected
+	/// element role and the runtime consequence so an author can see why their physics
+	/// detaches.
+	std::string DescribeMissingBoneRef(const MissingBoneRef& m, const std::string& xmlPath,
+		const std::string& skeletonName)
+	{
+		std::string effect;
+		if (m.usedAsBone && m.constraintRefs > 0)
+			effect = "its <bone> body is skipped and " + std::to_string(m.constraintRefs) +
+			         " constraint(s) referencing it are dropped";
+		else if (m.usedAsBone)
+			effect = "its <bone> body is skipped (no physics body created)";
+		else
+			effect = std::to_string(m.constraintRefs) + " constraint(s) referencing it are dropped";
+
+		std::string line = xmlPath + ": node '" + m.resolvedName + "' is absent from the '" +
+		                   skeletonName + "' skeleton — " + effect;
+		if (m.referencedName != m.resolvedName)
+			line += " (XML name '" + m.referencedName + "' renamed to '" + m.resolvedName + "')";
+		if (m.constraintRefs > 0)
+			line += "; dynamic bones anchored only through it may detach/sag";
+		line += ".";
+		return line;
+	}
+
+	/// Discovers physics-enabled assets: scans data/ (or the configured physical mods dir)
+	/// and the mounted archives for NIF files.
+	///   Phase 1 (serial + parallel): directory walk to collect .nif paths, then the packed
+	///     NIFs no loose file overrides.
+	///   Phase 2 (parallel): binary scan to detect physics-marker blocks in each NIF; the
+	///     parses of the physics NIFs go to `parsedNifs`, when given, as far as its budget allows.
+	/// Equipped gear is the host's to discover (ValidationHost::discoverEquipped).
+	static std::vector<PhysicsAsset> discoverPhysicsAssets(
+		std::vector<std::string>* outNifScanViolations = nullptr,
+		int* outFilesystemNifFilesDiscovered = nullptr,
+		int* outPackedNifFilesDiscovered = nullptr,
+		ParsedNifStore* parsedNifs = nullptr)
+	{
+		if (outNifScanViolations)
+			outNifScanViolations->clear();
+		if (outFilesystemNifFilesDiscovered)
+			*outFilesystemNifFilesDiscovered = 0;
+		if (outPackedNifFilesDiscovered)
+			*outPackedNifFilesDiscovered = 0;
+
+		// ---- Filesystem: NIF discovery ----
+		// Temporary debug mode: scan a single hardcoded NIF directly.
+		namespace fs = std::filesystem;
+		using Clock = std::chrono::high_resolution_clock;
+		auto msElapsed = [](Clock::time_point a, Clock::time_point b) {
+			return std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count();
+		};
+		std::error_code ec;
+
+		fs::path scanRoot = ResolvePathCase("data");
+		if (!fs::exists(scanRoot, ec) || !fs::is_directory(scanRoot, ec)) {
+			logger::warn("[Validator] Data directory not found: {}", PathToUtf8(scanRoot));
+			return {};
+		}
+
+		// ── Phase 1a: serial first-level scan ────────────────────────────────
+		// Single non-recursive pass over data/ to collect top-level subdirs.
+		// Timing each dir reveals which ones are slow to open (VFS overhead).
+		auto tp1a = Clock::now();
+		std::vector<std::string> nifPaths;
+		std::vector<fs::path> scanTasks;  // dirs for parallel scan
+
+		// Physical mods directory bypass: enumerate each mod's directory
+		// directly on NTFS, avoiding MO2 VFS hook overhead entirely.
+		// Driven by <mods-dir> in configs.xml; falls back to the VFS scan of
+		// data/ when modsDir is empty (Vortex users, or unconfigured installs).
+		const fs::path kPhysModsDir = !g_validationConfig.modsDir.empty() ? fs::path(g_validationConfig.modsDir) : fs::path{};
+		const bool physScan = !kPhysModsDir.empty() && fs::exists(kPhysModsDir, ec) && fs::is_directory(kPhysModsDir, ec);
+		ec.clear();
+
+		if (physScan) {
+			logger::info("[Validator][PROF] Phase 1: using physical mods dir: {}", PathToUtf8(kPhysModsDir));
+			for (auto& entry : fs::directory_iterator(kPhysModsDir, ec)) {
+				if (ec) {
+					ec.clear();
+					continue;
+				}
+				if (entry.is_directory(ec) && !ec)
+					scanTasks.push_back(entry.path());
+			}
+		} else {
+			// VFS scan of data/ (original path)
+			for (auto& entry : fs::directory_iterator(scanRoot, ec)) {
+				if (ec) {
+					ec.clear();
+					continue;
+				}
+				if (entry.is_directory(ec) && !ec) {
+					scanTasks.push_back(entry.path());
+				} else if (entry.is_regular_file(ec) && !ec) {
+					auto ext = PathToUtf8(entry.path().extension());
+					std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+					if (ext == ".nif") {
+						try {
+							nifPaths.push_back(PathToUtf8(entry.path()));
+						} catch (...) {}
+					}
+				}
+			}
+		}
+
+		auto tp1b = Clock::now();
+
+		// ── Phase 1b: parallel recursive scan of all top-level subdirs ─────
+		// One future per top-level dir so heavy dirs (meshes/, textures/) and
+		// light dirs (sounds/, scripts/) overlap naturally.
+		// Note: FindFirstFileExW with *.nif filter was tested but proved slower —
+		// MO2's VFS hook processes all entries before applying the filter, so
+		// a two-pass approach pays the VFS cost twice. Single-pass
+		// recursive_directory_iterator is optimal in this environment.
+		// Per-task wall time recorded for the slowest-dir report.
+		std::vector<std::vector<std::string>> perDirNifs(scanTasks.size());
+		std::vector<long long> taskMs(scanTasks.size(), 0);
+		{
+			const size_t n = scanTasks.size();
+			std::vector<std::future<void>> futures;
+			futures.reserve(n);
+			for (size_t j = 0; j < n; ++j) {
+				futures.push_back(std::async(std::launch::async, [&, j]() {
+					auto tTask = Clock::now();
+					if (physScan) {
+						// Native NTFS: Win32 two-pass scan (*.nif + dirs only).
+						// NTFS applies the filter at the driver level so we never
+						// pay the per-entry cost for non-NIF files.
+						findNifsNative(scanTasks[j], perDirNifs[j]);
+					} else {
+						// VFS fallback: single-pass recursive_directory_iterator.
+						findNifsRecursive(scanTasks[j], perDirNifs[j]);
+					}
+					taskMs[j] = msElapsed(tTask, Clock::now());
+				}));
+			}
+			for (auto& f : futures) f.get();
+		}
+		auto tp1c = Clock::now();
+
+		// ── Phase 1c: merge ───────────────────────────────────────────────────
+		if (physScan) {
+			// Physical scan: convert absolute paths to data/-relative virtual paths
+			// and deduplicate — multiple mods may supply the same NIF (priority
+			// overrides).  We keep the first occurrence; Phase 2+3 open paths
+			// through the VFS so they always get the highest-priority version.
+			std::unordered_set<std::string> seen;
+			for (size_t j = 0; j < scanTasks.size(); ++j) {
+				// Prefix = "c:/Modlists/JOJ/mods/<ModName>/" (forward slashes, trailing /)
+				std::string prefix = PathToUtf8(scanTasks[j]);
+				if (!prefix.empty() && prefix.back() != '/')
+					prefix += '/';
+				const std::string normPrefix = NormalizePathForComparison(prefix);
+
+				for (auto& physPath : perDirNifs[j]) {
+					if (physPath.size() <= prefix.size())
+						continue;
+					// Case-insensitive prefix strip (Windows paths may differ in case)
+					bool prefixMatch = NormalizePathForComparison(physPath.substr(0, prefix.size())) == normPrefix;
+					if (!prefixMatch)
+						continue;
+					std::string rel = physPath.substr(prefix.size());
+					std::string virt = "data/" + rel;
+					if (seen.insert(virt).second)
+						nifPaths.push_back(std::move(virt));
+				}
+			}
+		} else {
+			size_t total = nifPaths.size();
+			for (auto& v : perDirNifs) total += v.size();
+			nifPaths.reserve(total);
+			for (auto& v : perDirNifs)
+				for (auto& p : v) nifPaths.push_back(std::move(p));
+		}
+		auto tp1d = Clock::now();
+
+		// ── Phase 1d: packed NIFs ─────────────────────────────────────────────
+		// A loose file overrides the packed one of the same path, as in game. The rest
+		// are appended after the loose ones; their paths are the archives' (lower case).
+		std::unordered_set<std::string> looseNifs;
+		looseNifs.reserve(nifPaths.size());
+		for (const auto& p : nifPaths)
+			looseNifs.insert(NormalizePathForComparison(p));
+		size_t packedNifs = 0;
+		for (auto& p : ListPackedDataFiles(".nif")) {
+			if (looseNifs.contains(p))
+				continue;
+			nifPaths.push_back(std::move(p));
+			++packedNifs;
+		}
+		auto tp1e = Clock::now();
+
+		logger::info("[Validator][PROF] Phase 1 breakdown ({} tasks, {} NIFs found, {} packed, mode={}):",
+			scanTasks.size(), nifPaths.size(), packedNifs, physScan ? "physical-mods" : "vfs-data");
+		logger::info("[Validator][PROF]   1a serial scan        {:>6} ms", msElapsed(tp1a, tp1b));
+		logger::info("[Validator][PROF]   1b parallel scan      {:>6} ms  (wall, {} tasks)", msElapsed(tp1b, tp1c), scanTasks.size());
+		logger::info("[Validator][PROF]   1c merge              {:>6} ms", msElapsed(tp1c, tp1d));
+		logger::info("[Validator][PROF]   1d packed NIFs        {:>6} ms", msElapsed(tp1d, tp1e));
+		logger::info("[Validator][PROF]   Phase 1 total         {:>6} ms", msElapsed(tp1a, tp1e));
+
+		// Per-task parallel scan timings (top 15 slowest) — shows which
+		// second-level dirs dominate the parallel scan wall time.
+		struct TaskStat
+		{
+			std::string path;
+			long long ms;
+			size_t nifs;
+		};
+		std::vector<TaskStat> taskStats;
+		taskStats.reserve(scanTasks.size());
+		for (size_t j = 0; j < scanTasks.size(); ++j)
+			taskStats.push_back({ PathToUtf8(scanTasks[j]), taskMs[j], perDirNifs[j].size() });
+		std::sort(taskStats.begin(), taskStats.end(),
+			[](const auto& a, const auto& b) { return a.ms > b.ms; });
+		logger::info("[Validator][PROF] Slowest scan tasks (top 15):");
+		for (size_t i = 0; i < std::min<size_t>(15, taskStats.size()); ++i)
+			logger::info("[Validator][PROF]   {:>6} ms  {:>6} nifs  {}",
+				taskStats[i].ms, taskStats[i].nifs, taskStats[i].path);
+
+		logger::info("[Validator] Found {} NIF files, scanning for physics data...", nifPaths.size());
+		if (outFilesystemNifFilesDiscovered)
+			*outFilesystemNifFilesDiscovered = static_cast<int>(nifPaths.size());
+		if (outPackedNifFilesDiscovered)
+			*outPackedNifFilesDiscovered = static_cast<int>(packedNifs);
+		const size_t firstPacked = nifPaths.size() - packedNifs;
+
+		// ── Phase 2: parallel physics marker scan ─────────────────────────────
+		auto tp2a = Clock::now();
+		const size_t n = nifPaths.size();
+		std::vector<std::optional<PhysicsAsset>> scanResults(n);
+		std::vector<std::vector<std::string>> scanViolations(n);
+
+		ParallelForChunks(n, [&](size_t begin, size_t end) {
+			for (size_t j = begin; j < end; ++j) {
+				const auto& pathStr = nifPaths[j];
+				try {
+					auto scanRes = ExtractPhysicsXmlRefsFromNIFs(pathStr);
+					for (const auto& err : scanRes.errors)
+						scanViolations[j].push_back(err);
+
+					if (!scanRes.hasPhysicsData)
+						continue;
+					if (parsedNifs && scanRes.parsed)
+						parsedNifs->offer(pathStr, std::move(scanRes.parsed));
+
+					PhysicsAsset asset;
+					asset.nifPath = pathStr;
+					asset.nifExists = true;
+					if (j >= firstPacked)
+						asset.nifArchive = LocateDataFile(pathStr).archive;
+					asset.hasOrphanedPhysicsMarker = scanRes.hasOrphanedPhysicsMarker;
+					asset.relatedTRIPaths = discoverRelatedTRIFiles(pathStr);
+					asset.allPhysicsXmlPaths = scanRes.allPhysicsXmlPaths;
+
+					if (!scanRes.physicsXmlPath.empty()) {
+						auto xml = ResolveDataFile(scanRes.physicsXmlPath);
+						asset.xmlPath = std::move(xml.path);
+						asset.xmlArchive = std::move(xml.archive);
+						asset.xmlExists = xml.exists;
+					}
+
+					scanResults[j] = std::move(asset);
+				} catch (const std::exception& e) {
+					scanViolations[j].push_back("Exception while scanning NIF '" + pathStr + "': " + e.what());
+					logger::warn("[Validator] Error scanning NIF {}: {}", pathStr, e.what());
+				} catch (...) {
+					scanViolations[j].push_back("Unknown exception while scanning NIF: " + pathStr);
+					logger::warn("[Validator] Unknown error scanning NIF {}", pathStr);
+				}
+			}
+		});
+		auto tp2b = Clock::now();
+
+		// Collect physics-enabled NIFs, preserving discovery order.
+		std::vector<PhysicsAsset> result;
+		result.reserve(n);
+		for (auto& opt : scanResults) {
+			if (opt)
+				result.push_back(std::move(*opt));
+		}
+		if (outNifScanViolations) {
+			for (auto& errs : scanViolations)
+				for (auto& err : errs)
+					outNifScanViolations->push_back(std::move(err));
+		}
+		auto tp2c = Clock::now();
+
+		logger::info("[Validator][PROF] Phase 2 breakdown ({} NIFs scanned, {} physics):",
+			n, result.size());
+		logger::info("[Validator][PROF]   2a parallel scan     {:>6} ms  (wall)", msElapsed(tp2a, tp2b));
+		logger::info("[Validator][PROF]   2b collect results   {:>6} ms", msElapsed(tp2b, tp2c));
+		logger::info("[Validator][PROF]   Phase 2 total        {:>6} ms", msElapsed(tp2a, tp2c));
+
+		logger::info("[Validator] Scanned {} NIF files, found {} physics-enabled NIFs",
+			nifPaths.size(), result.size());
+		if (parsedNifs)
+			logger::info("[Validator] Kept {} NIF parse(s) ({} MB) for the later phases, {} over budget",
+				parsedNifs->size(), parsedNifs->bytes() >> 20, parsedNifs->refused());
+		return result;
+	}
+
+	// ═══════════════════════════════════════════════════════════════════════════════
+	// §5  Validation pipeline
+	//     Phase-ordered validators called by RunValidationCore.
+	// ═══════════════════════════════════════════════════════════════════════════════
+
+	/// The parse of one NIF: the one Phase 2 kept in `parsedNifs`, else read, loose or
+	/// packed, and parsed again. Null when it is unreadable, oversized or malformed (the
+	/// discovery phases already report those).
+	static std::shared_ptr<const ParsedNif> loadParsedNif(const std::string& nifPath,
+		const ParsedNifStore* parsedNifs = nullptr)
+	{
+		if (parsedNifs)
+			if (auto kept = parsedNifs->find(nifPath))
+				return kept;
+		const std::string bytes = ReadDataFile(nifPath, nif::kMaxNifFileSize + 1);
+		if (bytes.empty() || bytes.size() > nif::kMaxNifFileSize)
+			return nullptr;
+		auto parsed = parseNif(std::vector<uint8_t>(bytes.begin(), bytes.end()));
+		return parsed ? std::make_shared<const ParsedNif>(std::move(*parsed)) : nullptr;
+	}
+
+	/// Node names of the reference skeleton configured for the offline bone-reference
+	/// check (validation.reference-skeleton). nullopt when none is configured; a
+	/// configured one that does not load is reported, and the check skipped.
+	static std::optional<std::vector<std::string>> loadReferenceSkeletonNodes(
+		AssetValidationResult& report, std::ostream& out, std::string& skeletonName)
+	{
+		if (g_validationConfig.referenceSkeleton.empty()) {
+			out << "  (no validation.reference-skeleton configured: bone references are not checked)\n";
+			return std::nullopt;
+		}
+
+		const auto skeleton = ResolveDataFile(g_validationConfig.referenceSkeleton);
+		const std::string& path = skeleton.path;
+		auto parsed = skeleton.exists ? loadParsedNif(path) : nullptr;
+		auto nodes = parsed ? CollectNifNodeNames(*parsed, true) : std::vector<std::string>();
+		if (nodes.empty()) {
+			std::string warn = g_validationConfig.referenceSkeleton +
+			                   ": reference skeleton not found or not an SE skeleton NIF; bone references are not checked.";
+			report.warnings.push_back(warn);
+			report.hasWarnings = true;
+			out << "  [WARNING] " << warn << "\n";
+			return std::nullopt;
+		}
+
+		skeletonName = path.substr(path.find_last_of("/\\") + 1);
+		out << "  Bone references checked against " << path;
+		if (!skeleton.archive.empty())
+			out << " [" << skeleton.archive << "]";
+		out << " (" << nodes.size() << " nodes).\n";
+		return nodes;
+	}
+
+	/// Validates that _0.nif and _1.nif NIF pairs reference the same physics XML at the same block positions.
+	/// For every _0.nif, checks that the matching _1.nif exists and references identical physics data.
+	/// Emits errors if pairs are missing or mismatched, then diffs the meshes of every pair found
+	/// (DiffWeightVariantNifs): differences in shapes, skinning or physics data are errors, in nodes warnings.
+	static void validateNifPairConsistency(const std::vector<PhysicsAsset>& nifAssets,
+		AssetValidationResult& report, std::ostream& out, const ParsedNifStore* parsedNifs = nullptr)
+	{
+		// Build a fast lookup: normalised nif path -> index in nifAssets
+		std::unordered_map<std::string, size_t> nifByNormPath;
+		nifByNormPath.reserve(nifAssets.size());
+		for (size_t i = 0; i < nifAssets.size(); ++i)
+			nifByNormPath[NormalizePathForComparison(nifAssets[i].nifPath)] = i;
+
+		// Track _0.nif paths we've already checked (avoid reporting the same pair twice)
+		std::unordered_set<std::string> checked;
+
+		struct NifPair
+		{
+			size_t nif0 = 0;
+			size_t nif1 = 0;
+			bool xmlMismatch = false;  // already reported above; its physics data differences are not repeated
+		};
+		std::vector<NifPair> pairs;
+
+		for (size_t i = 0; i < nifAssets.size(); ++i) {
+			const auto& asset = nifAssets[i];
+
+			// We only initiate checks from the _0.nif side
+			auto normPath = NormalizePathForComparison(asset.nifPath);
+			if (!normPath.ends_with("_0.nif"))
+				continue;
+			if (checked.count(normPath))
+				continue;
+			checked.insert(normPath);
+
+			// Derive the expected _1.nif path
+			std::string norm1 = normPath.substr(0, normPath.size() - 6) + "_1.nif";
+
+			auto it1 = nifByNormPath.find(norm1);
+			if (it1 == nifByNormPath.end()) {
+				// _1.nif has no physics data or does not exist — only warn if _0 has physics
+				if (!asset.xmlPath.empty()) {
+					std::string msg = asset.nifPath + ": _0.nif has physics data but the matching _1.nif (" + norm1 + ") was not found or has no physics reference.";
+					report.errors.push_back(msg);
+					report.hasErrors = true;
+					out << "  [ERROR] " << asset.nifPath << "\n";
+					out << "    Matching _1.nif not found or has no physics reference: " << norm1 << "\n";
+				}
+				continue;
+			}
+
+			const auto& asset1 = nifAssets[it1->second];
+			const size_t errorsBefore = report.errors.size();
+
+			// 1. Both must reference the same XML (normalised)
+			auto normXml0 = NormalizePathForComparison(asset.xmlPath);
+			auto normXml1 = NormalizePathForComparison(asset1.xmlPath);
+			if (normXml0 != normXml1) {
+				std::string msg = asset.nifPath + " and " + asset1.nifPath +
+				                  ": _0/_1 NIF pair reference different physics XMLs: '" +
+				                  asset.xmlPath + "' vs '" + asset1.xmlPath + "'.";
+				report.errors.push_back(msg);
+				report.hasErrors = true;
+				out << "  [ERROR] " << asset.nifPath << "\n";
+				out << "    _0.nif XML: " << (asset.xmlPath.empty() ? "(none)" : asset.xmlPath) << "\n";
+				out << "    _1.nif XML: " << (asset1.xmlPath.empty() ? "(none)" : asset1.xmlPath) << "\n";
+				out << "    _0/_1 NIF pair reference different physics XMLs.\n";
+			}
+
+			// 2. Both must have the same number of physics blocks at the same positions
+			const auto& paths0 = asset.allPhysicsXmlPaths;
+			const auto& paths1 = asset1.allPhysicsXmlPaths;
+			if (paths0.size() != paths1.size()) {
+				std::string msg = asset.nifPath + " and " + asset1.nifPath +
+				                  ": _0/_1 NIF pair have a different number of physics XML blocks (" +
+				                  std::to_string(paths0.size()) + " vs " + std::to_string(paths1.size()) + ").";
+				report.errors.push_back(msg);
+				report.hasErrors = true;
+				out << "  [ERROR] " << asset.nifPath << " vs " << asset1.nifPath << "\n";
+				out << "    Block count mismatch: _0.nif has " << paths0.size()
+					<< " block(s), _1.nif has " << paths1.size() << " block(s).\n";
+			} else {
+				for (size_t k = 0; k < paths0.size(); ++k) {
+					if (NormalizePathForComparison(paths0[k]) != NormalizePathForComparison(paths1[k])) {
+						std::string msg = asset.nifPath + " and " + asset1.nifPath +
+						                  ": _0/_1 NIF pair have different physics XML at block index " +
+						                  std::to_string(k) + ": '" + paths0[k] + "' vs '" + paths1[k] + "'.";
+						report.errors.push_back(msg);
+						report.hasErrors = true;
+						out << "  [ERROR] " << asset.nifPath << " vs " << asset1.nifPath << "\n";
+						out << "    Block " << k << " mismatch:\n";
+						out << "      _0.nif: " << paths0[k] << "\n";
+						out << "      _1.nif: " << paths1[k] << "\n";
+					}
+				}
+			}
+
+			if (asset.nifExists && asset1.nifExists)
+				pairs.push_back({ i, it1->second, report.errors.size() != errorsBefore });
+		}
+
+		// 3. Both must have the same meshes, but for the vertex positions
+		std::vector<std::vector<NifPairDifference>> diffs(pairs.size());
+		std::vector<char> unreadable(pairs.size(), 0);
+		ParallelForChunks(pairs.size(), [&](size_t begin, size_t end) {
+			for (size_t p = begin; p < end; ++p) {
+				auto parsed0 = loadParsedNif(nifAssets[pairs[p].nif0].nifPath, parsedNifs);
+				auto parsed1 = loadParsedNif(nifAssets[pairs[p].nif1].nifPath, parsedNifs);
+				if (parsed0 && parsed1)
+					diffs[p] = DiffWeightVariantNifs(*parsed0, *parsed1);
+				else
+					unreadable[p] = 1;
+			}
+		});
+
+		size_t compared = 0;
+		for (size_t p = 0; p < pairs.size(); ++p) {
+			if (unreadable[p])
+				continue;  // reported by the NIF scan
+			++compared;
+			const auto& asset0 = nifAssets[pairs[p].nif0];
+			const auto& asset1 = nifAssets[pairs[p].nif1];
+			bool printed = false;
+			for (const auto& diff : diffs[p]) {
+				if (pairs[p].xmlMismatch && diff.kind == NifPairDifferenceKind::PhysicsData)
+					continue;
+				const bool error = diff.kind != NifPairDifferenceKind::Node;
+				const std::string what = std::string(NifPairDifferenceKindName(diff.kind)) +
+				                         (diff.block.empty() ? "" : " of " + diff.block) + ": " + diff.detail;
+				std::string msg = asset0.nifPath + " and " + asset1.nifPath + ": _0/_1 meshes differ in " + what + ".";
+				if (error) {
+					report.errors.push_back(std::move(msg));
+					report.hasErrors = true;
+				} else {
+					report.warnings.push_back(std::move(msg));
+					report.hasWarnings = true;
+				}
+				if (!printed) {
+					out << "  [MESH] " << asset0.nifPath << " vs " << asset1.nifPath << "\n";
+					++report.nifPairMismatchesFound;
+					printed = true;
+				}
+				out << "    [" << (error ? "ERROR" : "WARNING") << "] " << what << "\n";
+			}
+		}
+		out << "  Compared the meshes of " << compared << " _0/_1 pair(s); " << report.nifPairMismatchesFound
+			<< " differ.\n";
+	}
+
+	/// Validates physics XMLs referenced by NIF assets with per-NIF error context.
+	/// Validates each unique XML, warns if NIFs reference missing XMLs or have multiple physics blocks,
+	/// and deduplicates validation results across NIFs sharing the same XML file.
+	/// With checkBoneRefsOffline, also resolves each NIF's XML node references against the
+	/// configured reference skeleton (the equipped pipeline checks the live one instead).
+	static void validateNIFAssets(const std::vector<PhysicsAsset>& nifAssets,
+		AssetValidationResult& report, std::ostream& out, float timeStep, bool checkBoneRefsOffline = false,
+		const ParsedNifStore* parsedNifs = nullptr)
+	{
+		// Pre-collect unique XML paths from all NIF assets (serial dedup).
+		// xmlToIdx maps normalised path → index in batch.
+		std::unordered_map<std::string, size_t> xmlToIdx;
+		std::vector<std::string> batch;
+		for (const auto& asset : nifAssets) {
+			if (asset.xmlPath.empty() || !asset.xmlExists)
+				continue;
+			auto norm = NormalizePathForComparison(asset.xmlPath);
+			if (!xmlToIdx.count(norm)) {
+				xmlToIdx[norm] = batch.size();
+				batch.push_back(asset.xmlPath);
+			}
+		}
+
+		// Parallel validate all unique XMLs.
+		auto batchResults = parallelValidateXMLs(batch);
+
+		// Node references are checked per NIF, not per XML: what the XML may reference
+		// depends on the nodes each mesh merges into the skeleton.
+		std::string skeletonName;
+		auto skeletonNodes = checkBoneRefsOffline ? loadReferenceSkeletonNodes(report, out, skeletonName) : std::nullopt;
+		std::vector<std::vector<MissingBoneRef>> missingRefs(nifAssets.size());
+		if (skeletonNodes) {
+			ParallelForChunks(nifAssets.size(), [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					const auto& asset = nifAssets[i];
+					if (!asset.nifExists || !asset.xmlExists || asset.xmlPath.empty())
+						continue;
+					if (auto parsed = loadParsedNif(asset.nifPath, parsedNifs))
+						missingRefs[i] = FindMissingPhysicsXmlBoneRefsOffline(*parsed, *skeletonNodes, asset.xmlPath);
+				}
+			});
+		}
+
+		// Report per-NIF in original order (serial).
+		// reportedXMLs tracks which XMLs have already been reported within Phase 3
+		// (multiple NIFs often share the same physics XML).
+		std::unordered_set<std::string> reportedXMLs;
+
+		for (size_t assetIdx = 0; assetIdx < nifAssets.size(); ++assetIdx) {
+			const auto& asset = nifAssets[assetIdx];
+			out << "  [NIF]  " << asset.nifPath;
+			if (!asset.nifArchive.empty())
+				out << " [" << asset.nifArchive << "]";
+			out << "\n";
+
+			// Warn about a leftover physics marker with no backing data block.
+			if (asset.hasOrphanedPhysicsMarker) {
+				report.warnings.push_back(asset.nifPath +
+										  ": has the \"HDT Skinned Mesh Physics Object\" marker string but no"
+										  " NiStringExtraData physics block; the marker is leftover and no physics is applied.");
+				report.hasWarnings = true;
+				out << "    [WARNING] Leftover \"HDT Skinned Mesh Physics Object\" marker with no"
+					   " NiStringExtraData block; no physics applied\n";
+			}
+
+			// Warn if multiple "HDT Skinned Mesh Physics Object" blocks found
+			if (asset.allPhysicsXmlPaths.size() > 1) {
+				std::string msg = asset.nifPath + ": has " +
+				                  std::to_string(asset.allPhysicsXmlPaths.size()) +
+				                  " \"HDT Skinned Mesh Physics Object\" blocks; only the first is used by the runtime.";
+				report.warnings.push_back(msg);
+				report.hasWarnings = true;
+				out << "    [WARNING] Multiple \"HDT Skinned Mesh Physics Object\" blocks found ("
+					<< asset.allPhysicsXmlPaths.size() << "); only the first is used:\n";
+				for (const auto& p : asset.allPhysicsXmlPaths)
+					out << "      - " << p << "\n";
+			}
+
+			if (!asset.xmlExists && !asset.xmlPath.empty()) {
+				std::string err = "NIF " + asset.nifPath +
+				                  " references missing XML: " + asset.xmlPath;
+				report.errors.push_back(err);
+				report.hasErrors = true;
+				out << "    [ERROR] Referenced XML not found: " << asset.xmlPath << "\n";
+			} else if (!asset.xmlPath.empty()) {
+				out << "    -> " << asset.xmlPath;
+				if (!asset.xmlArchive.empty())
+					out << " [" << asset.xmlArchive << "]";
+				out << "\n";
+
+				for (const auto& m : missingRefs[assetIdx]) {
+					report.warnings.push_back(asset.nifPath + ": " + DescribeMissingBoneRef(m, asset.xmlPath, skeletonName));
+					report.hasWarnings = true;
+					out << "    [WARNING] " << DescribeMissingBoneRef(m, "bone reference", skeletonName) << "\n";
+				}
+
+				auto norm = NormalizePathForComparison(asset.xmlPath);
+				if (reportedXMLs.count(norm)) {
+					out << "    (already validated)\n";
+					continue;
+				}
+				reportedXMLs.insert(norm);
+				++report.totalXMLsFound;
+
+				const auto& pair = batchResults[xmlToIdx[norm]];
+				bool xmlHasErrors = hasBlockingXsdErrors(pair.first) || hasBlockingSchErrors(pair.second);
+
+				if (xmlHasErrors) {
+					++report.xmlErrorCount;
+					report.hasErrors = true;
+				} else {
+					++report.xmlPassCount;
+				}
+
+				appendXmlViolationsToReport(pair, asset.xmlPath, report, out, timeStep);
+			} else {
+				out << "    [WARN] Could not determine XML path from NIF\n";
+			}
+		}
+	}
+
+	// ═══════════════════════════════════════════════════════════════════════════════
+	// §6  XML optimization and NIF repair
+	//     RunOptimizationCore rewrites every physics XML, RunNifRepairCore every physics
+	//     NIF with a repairable skin mesh, into an output directory.
+	// ═══════════════════════════════════════════════════════════════════════════════
+
+	/// The physics XMLs the full pipeline validates: the defaultBBPs.xml map entries, then
+	/// the XMLs of the physics NIFs (the first one of each, the one the runtime loads).
+	static std::vector<std::string> collectPhysicsXmlPaths()
+	{
+		std::vector<std::string> paths;
+		std::unordered_set<std::string> seen;
+		auto add = [&](const std::string& path, bool exists) {
+			if (exists && !path.empty() && seen.insert(NormalizePathForComparison(path)).second)
+				paths.push_back(path);
+		};
+
+		for (const auto& entry : discoverDefaultBBPXMLs())
+			add(entry.xmlPath, entry.xmlExists);
+		for (const auto& asset : discoverPhysicsAssets())
+			add(asset.xmlPath, asset.xmlExists);
+		return paths;
+	}
+
+	/// Where the rewritten copy of a data file goes under outputDir: its path below data/,
+	/// so that the directory can be dropped into a mod as is (and, loose, overrides a
+	/// packed original).
+	static std::filesystem::path outputPathOf(const std::filesystem::path& outputDir, const std::string& dataPath)
+	{
+		std::filesystem::path relative = stripDataPrefix(dataPath);
+		if (relative.is_absolute())
+			relative = relative.relative_path();
+		return outputDir / relative;
+	}
+
+	/// Optimize every physics XML (see OptimizePhysicsXml) and write the ones that changed
+	/// to outputDir; the originals are never touched. Returns the diff summary: per XML,
+	/// the size change and every edit with its line in the original.
+	std::string RunOptimizationCore(XmlOptimizationResult& result, const std::filesystem::path& outputDir,
+		const ValidationHost& host)
+	{
+		auto wallStart = std::chrono::steady_clock::now();
+		DataArchiveMount archives(ResolvePathCase("data"), host.pluginLoadOrder);
+		const auto paths = collectPhysicsXmlPaths();
+		result.xmlsFound = static_cast<int>(paths.size());
+
+		std::vector<size_t> originalSizes(paths.size(), 0);
+		std::vector<XmlOptimizerResult> optimized(paths.size());
+		ParallelForChunks(paths.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const std::string bytes = ReadDataFile(paths[i]);
+				originalSizes[i] = bytes.size();
+				optimized[i] = OptimizePhysicsXml(bytes);
+			}
+		});
+
+		std::ostringstream details;
+		for (size_t i = 0; i < paths.size(); ++i) {
+			const auto& xml = optimized[i];
+			if (!xml.parsed) {
+				++result.xmlsFailed;
+				details << "  [SKIP] " << paths[i] << ": could not be parsed; run 'smp report' for details.\n";
+				continue;
+			}
+			if (!xml.changed()) {
+				++result.xmlsUnchanged;
+				for (const auto& step : xml.rejectedSteps)
+					details << "  [KEPT] " << paths[i] << ": '" << step << "' would change the resolved definitions; not applied.\n";
+				continue;
+			}
+
+			const auto outPath = outputPathOf(outputDir, paths[i]);
+			std::error_code ec;
+			std::filesystem::create_directories(outPath.parent_path(), ec);
+			std::ofstream out(outPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!out.is_open() || !(out << xml.optimized)) {
+				++result.xmlsFailed;
+				details << "  [ERROR] " << paths[i] << ": could not write " << PathToUtf8(outPath) << "\n";
+				continue;
+			}
+
+			++result.xmlsOptimized;
+			result.bytesBefore += originalSizes[i];
+			result.bytesAfter += xml.optimized.size();
+			details << "  [OPTIMIZED] " << paths[i] << " -> " << PathToUtf8(outPath) << "\n";
+			details << "    " << originalSizes[i] << " -> " << xml.optimized.size() << " bytes; "
+					<< xml.mergedTemplates << " template(s) merged, " << xml.removedDefaults << " unused template(s) and "
+					<< xml.removedChildren << " redundant tag(s) removed.\n";
+			for (const auto& step : xml.rejectedSteps)
+				details << "    '" << step << "' would change the resolved definitions; not applied.\n";
+			for (const auto& edit : xml.edits)
+				details << "    line " << edit.line << ": " << edit.description << "\n";
+		}
+
+		result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+		std::ostringstream summary;
+		summary << "========================================\n";
+		summary << "FSMP Physics XML Optimization\n";
+		summary << "Output:    " << PathToUtf8(outputDir) << "\n";
+		summary << "========================================\n\n";
+		summary << "== Summary ==\n";
+		summary << "  Duration:      " << std::fixed << std::setprecision(2) << result.elapsedSeconds << "s\n";
+		summary << "  XMLs found:    " << result.xmlsFound << "\n";
+		summary << "  Optimized:     " << result.xmlsOptimized << "\n";
+		summary << "  Unchanged:     " << result.xmlsUnchanged << "\n";
+		summary << "  Failed:        " << result.xmlsFailed << "\n";
+		summary << "  Bytes:         " << result.bytesBefore << " -> " << result.bytesAfter << "\n\n";
+		summary << "== Changes ==\n";
+		summary << details.str();
+		summary << "\n========================================\n";
+		return summary.str();
+	}
+
+	/// Repair the skin meshes of every physics NIF (see RepairNifSkinMeshes) and write the
+	/// repaired copies to outputDir; the originals are never touched. With `dryRun` only
+	/// the plans are made and nothing is written. Returns the summary: per NIF, every
+	/// repair with the shape it rewrites, and every issue left as it was.
+	std::string RunNifRepairCore(NifRepairResult& result, const std::filesystem::path& outputDir,
+		const ValidationHost& host, bool dryRun)
+	{
+		auto wallStart = std::chrono::steady_clock::now();
+		DataArchiveMount archives(ResolvePathCase("data"), host.pluginLoadOrder);
+
+		ParsedNifStore parsedNifs(static_cast<size_t>(std::max(0, g_validationConfig.parseCacheMB)) << 20);
+		std::vector<std::string> paths;
+		std::unordered_set<std::string> seen;
+		for (const auto& asset : discoverPhysicsAssets(nullptr, nullptr, nullptr, &parsedNifs))
+			if (asset.nifExists && seen.insert(NormalizePathForComparison(asset.nifPath)).second)
+				paths.push_back(asset.nifPath);
+		result.nifsChecked = static_cast<int>(paths.size());
+
+		std::vector<std::optional<NifRepairOutcome>> outcomes(paths.size());
+		ParallelForChunks(paths.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				if (auto parsed = loadParsedNif(paths[i], &parsedNifs))
+					outcomes[i] = RepairNifSkinMeshes(*parsed, paths[i], outputPathOf(outputDir, paths[i]), dryRun);
+		});
+
+		std::ostringstream details;
+		for (size_t i = 0; i < paths.size(); ++i) {
+			if (!outcomes[i]) {
+				++result.nifsFailed;
+				details << "  [SKIP] " << paths[i] << ": could not be parsed; run 'smp report' for details.\n";
+				continue;
+			}
+			const auto& outcome = *outcomes[i];
+			if (!outcome.needed()) {
+				if (outcome.plan.unrepairable.empty())
+					continue;
+				++result.nifsUnrepairable;
+				details << "  [KEPT] " << paths[i] << "\n";
+			} else if (dryRun || outcome.written) {
+				++result.nifsRepaired;
+				result.repairsApplied += static_cast<int>(outcome.plan.repairs.size()) + (outcome.orphanedSkinInstances > 0 ? 1 : 0);
+				if (dryRun)
+					details << "  [PLAN] " << paths[i] << "\n";
+				else
+					details << "  [REPAIRED] " << paths[i] << " -> " << PathToUtf8(outputPathOf(outputDir, paths[i])) << "\n";
+			} else {
+				++result.nifsFailed;
+				details << "  [ERROR] " << paths[i] << ": " << outcome.failure << "; nothing written.\n";
+			}
+
+			for (const auto& repair : outcome.plan.repairs)
+				details << "    BSTriShape[" << repair.triShapeBlockIndex << "] (" << repair.shapeType << "): "
+						<< NifSkinMeshRepairActionName(repair.action) << ", " << repair.detail << "\n";
+			if (outcome.orphanedSkinInstances > 0)
+				details << "    remove " << outcome.orphanedSkinInstances
+						<< " NiSkinInstance block(s) with no NiSkinPartition\n";
+			for (const auto& issue : outcome.plan.unrepairable) {
+				++result.issuesLeft;
+				details << "    BSTriShape[" << issue.triShapeBlockIndex << "] (" << issue.shapeType << "): "
+						<< issue.reasonCode << " has no safe repair; left as is.\n";
+			}
+		}
+
+		result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+		std::ostringstream summary;
+		summary << "========================================\n";
+		summary << (dryRun ? "FSMP NIF Repair Plan (dry run)\n" : "FSMP NIF Repair\n");
+		summary << "Output:    " << PathToUtf8(outputDir) << "\n";
+		summary << "========================================\n\n";
+		summary << "== Summary ==\n";
+		summary << "  Duration:      " << std::fixed << std::setprecision(2) << result.elapsedSeconds << "s\n";
+		summary << "  NIFs checked:  " << result.nifsChecked << "\n";
+		summary << (dryRun ? "  To repair:     " : "  Repaired:      ") << result.nifsRepaired << "\n";
+		summary << "  Repairs:       " << result.repairsApplied << "\n";
+		summary << "  Unrepairable:  " << result.nifsUnrepairable << " NIF(s), " << result.issuesLeft << " issue(s) left\n";
+		summary << "  Failed:        " << result.nifsFailed << "\n\n";
+		summary << "== Changes ==\n";
+		summary << details.str();
+		summary << "\n========================================\n";
+		return summary.str();
+	}
+
+	// ═══════════════════════════════════════════════════════════════════════════════
+	// §7  Orchestration
+	//     RunValidationCore drives the full pipeline in phase order.
+	// ═══════════════════════════════════════════════════════════════════════════════
+
+	/// Warn about the geometry defects of the collision shapes of one NIF + XML pair (see
+	/// AuditCollisionMeshes), one line per kind of defect and shape.
+	static void reportCollisionMeshAudit(const PhysicsAsset& asset, const std::vector<CollisionMeshAudit>& audits,
+		AssetValidationResult& report, std::ostream& out)
+	{
+		if (audits.empty())
+			return;
+
+		out << "  [NIF]  " << asset.nifPath << "\n";
+		for (const auto& audit : audits) {
+			report.collisionMeshIssuesFound += 1;
+
+			const std::string shape = audit.shapeType + "[" + std::to_string(audit.blockIndex) + "] \"" + audit.name + "\" (" +
+			                          (audit.perTriangle ? "per-triangle-shape" : "per-vertex-shape") + "): ";
+			const std::string ofVertices = " of " + std::to_string(audit.vertices) + " vertices ";
+			const std::string ofTriangles = " of " + std::to_string(audit.triangles) + " triangles ";
+			std::vector<std::string> msgs;
+			if (audit.degenerateTriangles > 0)
+				msgs.push_back(std::to_string(audit.degenerateTriangles) + ofTriangles +
+				               "are degenerate (repeated vertex or no area) — colliders with no contact normal.");
+			if (audit.sliverTriangles > 0)
+				msgs.push_back(std::to_string(audit.sliverTriangles) + ofTriangles +
+				               "are slivers — their contact normals flip from frame to frame.");
+			if (audit.disjointBoneTriangles > 0)
+				msgs.push_back(std::to_string(audit.disjointBoneTriangles) + ofTriangles +
+				               "join vertices with no bone in common — their AABBs stretch as the bones move apart.");
+			if (audit.duplicateVertices > 0)
+				msgs.push_back(std::to_string(audit.duplicateVertices) + ofVertices +
+				               "share the position of another vertex (UV or normal seams) — each is one more collider.");
+			if (audit.unnormalizedVertices > 0)
+				msgs.push_back(std::to_string(audit.unnormalizedVertices) + ofVertices +
+				               "have weights that don't sum to 1 — their colliders lag behind or overshoot the mesh.");
+			if (audit.unlistedBoneVertices > 0)
+				msgs.push_back(std::to_string(audit.unlistedBoneVertices) + ofVertices +
+				               "are weighted to a bone missing from the skin's bone list — data corruption.");
+
+			for (const auto& msg : msgs) {
+				report.warnings.push_back(asset.nifPath + ": " + shape + msg);
+				report.hasWarnings = true;
+				out << "    [WARNING] " << shape << msg << "\n";
+			}
+		}
+	}
+
+	/// Executes the complete validation pipeline (full or equipped-only) and generates a report.
+	/// Full pipeline (equippedOnly=false):
+	///   - Phase 0: Validates DefaultBBP XML entries.
+	///   - Phase 2: Discovers NIFs via filesystem or mods-dir scan.
+	///   - Phase 2.5: Validates _0/_1 NIF pair consistency.
+	///   - Phase 3: Validates NIF-referenced XMLs with NIF context.
+	///   - Phase 3.6: Estimates the runtime cost of each NIF + XML pair.
+	/// Equipped-only pipeline (equippedOnly=true):
+	///   - Discovers equipped armor and headparts.
+	///   - Validates their physics XMLs.
+	/// Run two structural checks on the parse of each NIF: orphaned NiSkinInstance
+	/// blocks (no NiSkinPartition child — runtime crash) and the full set of skin mesh
+	/// integrity issues from steps 4–11 of decimateCandidateFailClosed. NIFs with a
+	/// physics XML also get their collision shapes audited. The checks run in parallel,
+	/// on the parses Phase 2 kept where it could; the report follows the asset order.
+	static void validateNIFStructure(const std::vector<PhysicsAsset>& nifAssets,
+		AssetValidationResult& report, std::ostream& out, const ParsedNifStore* parsedNifs = nullptr)
+	{
+		struct StructureFindings
+		{
+			bool parsed = false;
+			bool preSE = false;
+			uint32_t bsVersion = 0;
+			int orphanedSkinInstances = 0;
+			std::vector<NifSkinMeshIssue> skinIssues;
+			std::vector<CollisionMeshAudit> collisionAudits;
+		};
+
+		std::vector<StructureFindings> findings(nifAssets.size());
+		ParallelForChunks(nifAssets.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const auto& asset = nifAssets[i];
+				if (!asset.nifExists)
+					continue;
+				auto parsed = loadParsedNif(asset.nifPath, parsedNifs);
+				if (!parsed)
+					continue;
+
+				auto& f = findings[i];
+				f.parsed = true;
+				f.preSE = isPreSESkyrimNif(*parsed);
+				f.bsVersion = parsed->bsVersion;
+				f.orphanedSkinInstances = countOrphanedSkinInstances(*parsed);
+				f.skinIssues = detectNIFSkinMeshIssues(*parsed, asset.nifPath);
+				if (asset.xmlExists && !asset.xmlPath.empty())
+					f.collisionAudits = AuditCollisionMeshes(*parsed, asset.xmlPath);
+			}
+		});
+
+		for (size_t i = 0; i < nifAssets.size(); ++i) {
+			const auto& asset = nifAssets[i];
+			const auto& f = findings[i];
+			if (!f.parsed)
+				continue;
+
+			if (f.preSE) {
+				std::string warn = asset.nifPath + ": appears to be a Skyrim LE / pre-SE NIF (bsVersion " +
+				                   std::to_string(f.bsVersion) +
+				                   "); FSMP requires SE-format meshes. Convert with SSE NIF Optimizer. 'smp trim nif' will skip it.";
+				report.warnings.push_back(warn);
+				report.hasWarnings = true;
+				out << "  [NIF]  " << asset.nifPath << "\n";
+				out << "    [WARNING] Skyrim LE / pre-SE NIF (bsVersion " << f.bsVersion
+					<< "); FSMP requires SE-format meshes. Convert with SSE NIF Optimizer.\n";
+			}
+
+			int count = f.orphanedSkinInstances;
+			if (count > 0) {
+				std::string err = asset.nifPath + ": " + std::to_string(count) +
+				                  " NiSkinInstance block(s) with no NiSkinPartition ref"
+				                  " — would crash the physics runtime. Run 'smp fix nif' to fix.";
+				report.errors.push_back(err);
+				report.hasErrors = true;
+				out << "  [NIF]  " << asset.nifPath << "\n";
+				out << "    [ERROR] " << count << " NiSkinInstance block(s) missing NiSkinPartition"
+												  " — would crash the physics runtime. Run 'smp fix nif' to fix.\n";
+			}
+
+			const auto& skinIssues = f.skinIssues;
+			if (!skinIssues.empty()) {
+				out << "  [NIF]  " << asset.nifPath << "\n";
+				for (const auto& issue : skinIssues) {
+					report.skinMeshIssuesFound += 1;
+
+					std::string msg;
+					bool isError = true;
+					if (issue.reasonCode == "unsupported-trishape-layout") {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType + "): vertex format not recognised by this tool.";
+						isError = false;
+					} else if (issue.reasonCode == "unsupported-skin-partition-layout") {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType + "): NiSkinPartition format not recognised by this tool.";
+						isError = false;
+					} else if (issue.reasonCode == "shape-partition-count-mismatch") {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType +
+						      "): BSTriShape and NiSkinPartition report different"
+						      " vertex or triangle counts — data corruption.";
+					} else if (issue.reasonCode == "unsupported-non-permutation-vertex-map") {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType +
+						      "): NiSkinPartition vertex map is not a bijection"
+						      " — malformed data. 'smp fix nif' may repair it.";
+					} else if (issue.reasonCode == "shape-partition-vertexdata-mismatch") {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType +
+						      "): BSTriShape and NiSkinPartition vertex data"
+						      " are inconsistent — data corruption. 'smp fix nif' may repair it.";
+					} else if (issue.reasonCode == "partition-triangle-copy-mismatch") {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType +
+						      "): NiSkinPartition has two inconsistent triangle"
+						      " arrays. Run 'smp fix nif' to fix.";
+					} else if (issue.reasonCode == "shape-partition-triangle-mismatch") {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType +
+						      "): BSTriShape and NiSkinPartition triangle lists"
+						      " are inconsistent — data corruption. 'smp fix nif' may repair it.";
+					} else if (issue.reasonCode == "triangle-index-out-of-range") {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType +
+						      "): NiSkinPartition triangle references a"
+						      " non-existent vertex — data corruption.";
+					} else {
+						msg = "BSTriShape[" + std::to_string(issue.triShapeBlockIndex) +
+						      "] (" + issue.shapeType + "): " + issue.reasonCode + ".";
+					}
+
+					const std::string fullMsg = asset.nifPath + ": " + msg;
+					if (isError) {
+						report.errors.push_back(fullMsg);
+						report.hasErrors = true;
+						out << "    [ERROR] " << msg << "\n";
+					} else {
+						report.warnings.push_back(fullMsg);
+						report.hasWarnings = true;
+						out << "    [WARNING] " << msg << "\n";
+					}
+				}
+			}
+
+			reportCollisionMeshAudit(asset, f.collisionAudits, report, out);
+		}
+	}
+
+	/// Estimate what each NIF + XML pair costs once loaded (see EstimatePhysicsCost) and
+	/// warn about the heavy ones, and about the outliers of this run: an asset costing
+	/// many times the median of the others is usually a collision mesh nobody trimmed.
+	/// The costliest assets are listed whatever their class, for comparison.
+	static void validatePhysicsCost(const std::vector<PhysicsAsset>& nifAssets,
+		AssetValidationResult& report, std::ostream& out, const ParsedNifStore* parsedNifs = nullptr)
+	{
+		constexpr double kOutlierFactor = 8.0;
+		constexpr size_t kListedAssets = 20;
+
+		std::vector<std::optional<PhysicsCostEstimate>> estimates(nifAssets.size());
+		ParallelForChunks(nifAssets.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const auto& asset = nifAssets[i];
+				if (!asset.nifExists || !asset.xmlExists || asset.xmlPath.empty())
+					continue;
+				auto parsed = loadParsedNif(asset.nifPath, parsedNifs);
+				if (!parsed)
+					continue;
+				auto estimate = EstimatePhysicsCost(*parsed, asset.xmlPath);
+				if (estimate.valid)
+					estimates[i] = std::move(estimate);
+			}
+		});
+
+		std::vector<size_t> estimated;
+		for (size_t i = 0; i < estimates.size(); ++i)
+			if (estimates[i])
+				estimated.push_back(i);
+		if (estimated.empty()) {
+			out << "  No NIF with a readable physics XML to estimate.\n";
+			return;
+		}
+
+		std::sort(estimated.begin(), estimated.end(), [&](size_t a, size_t b) {
+			return estimates[a]->msPerFrame > estimates[b]->msPerFrame;
+		});
+		const double median = estimates[estimated[estimated.size() / 2]]->msPerFrame;
+
+		auto formatMs = [](double ms) {
+			std::ostringstream s;
+			s << std::fixed << std::setprecision(3) << ms << " ms";
+			return s.str();
+		};
+		auto describe = [&](const PhysicsCostEstimate& e) {
+			size_t dynamicColliders = 0;
+			for (const auto& shape : e.shapes)
+				dynamicColliders += shape.dynamicColliders;
+			return "~" + formatMs(e.msPerFrame) + "/frame (" + PhysicsCostClassName(e.costClass) + "): " +
+			       std::to_string(e.totalColliders()) + " colliders (" + std::to_string(dynamicColliders) + " dynamic), " +
+			       std::to_string(e.dynamicBones) + " dynamic bones, " + std::to_string(e.totalSolverRows()) + " solver rows";
+		};
+
+		out << "  Estimated " << estimated.size() << " asset(s); median " << formatMs(median) << "/frame.\n";
+
+		for (size_t i : estimated) {
+			const auto& asset = nifAssets[i];
+			const auto& e = *estimates[i];
+			const bool heavy = e.costClass == PhysicsCostClass::Heavy || e.costClass == PhysicsCostClass::Extreme;
+			const bool outlier = e.costClass != PhysicsCostClass::Light && median > 0 && e.msPerFrame > kOutlierFactor * median;
+			if (!heavy && !outlier)
+				continue;
+
+			std::string msg = describe(e);
+			if (outlier)
+				msg += "; " + std::to_string(static_cast<int>(e.msPerFrame / median)) + "x the median asset";
+			report.warnings.push_back(asset.nifPath + ": runtime cost " + msg + ".");
+			report.hasWarnings = true;
+			++report.costOutliersFound;
+
+			out << "  [NIF]  " << asset.nifPath << "\n";
+			out << "    [WARNING] Runtime cost " << msg << "\n";
+			for (const auto& shape : e.shapes) {
+				out << "      " << (shape.perTriangle ? "per-triangle-shape " : "per-vertex-shape ") << shape.name << ": ";
+				if (!shape.foundInNif) {
+					out << "no skinned shape of that name in the NIF\n";
+					continue;
+				}
+				out << shape.colliders << " colliders (" << shape.dynamicColliders << " dynamic)";
+				if (shape.perTriangle)
+					out << " + " << shape.vertexColliders << " vertex colliders";
+				out << ", tree " << shape.treeNodes << " nodes, depth " << shape.treeDepth
+					<< ", leaves up to " << shape.maxLeafColliders << " (mean " << std::fixed << std::setprecision(1)
+					<< shape.meanLeafColliders << ")\n";
+			}
+			out << "      constraints: generic " << e.generic.constraints << " (" << e.generic.solverRows << " rows), stiffspring "
+				<< e.stiffSpring.constraints << " (" << e.stiffSpring.solverRows << " rows), conetwist "
+				<< e.coneTwist.constraints << " (" << e.coneTwist.solverRows << " rows)";
+			const size_t skipped = e.generic.skipped + e.stiffSpring.skipped + e.coneTwist.skipped;
+			if (skipped)
+				out << ", " << skipped << " between kinematic bones";
+			out << "\n";
+		}
+
+		out << "\n  -- Costliest assets --\n";
+		for (size_t n = 0; n < estimated.size() && n < kListedAssets; ++n)
+			out << "    " << describe(*estimates[estimated[n]]) << "  " << nifAssets[estimated[n]].nifPath << "\n";
+	}
+
+	std::string RunValidationCore(AssetValidationResult& report, const std::string& timestamp,
+		const ValidationHost& host, bool equippedOnly)
+	{
+		auto wallStart = std::chrono::steady_clock::now();
+		std::ostringstream bodyStream;
+
+		// Archives first: every phase reads NIFs and XMLs through them (hdtDataFileSystem.h).
+		DataArchiveMount archives(ResolvePathCase("data"), host.pluginLoadOrder);
+		report.archivesMounted = static_cast<int>(archives.result().archives.size());
+		bodyStream << "== Archives ==\n";
+		bodyStream << "  Mounted " << archives.result().archives.size() << " BSA archive(s) with "
+				   << archives.result().files << " packed file(s)"
+				   << (host.pluginLoadOrder.empty() ? " (no load order: every archive, by name)" : " in plugin load order")
+				   << "; loose files override them.\n";
+		for (const auto& error : archives.result().errors) {
+			report.warnings.push_back("data/" + error + "; its files are not validated.");
+			report.hasWarnings = true;
+			bodyStream << "  [WARNING] " << error << "; its files are not validated.\n";
+		}
+		bodyStream << "\n";
+
+		if (equippedOnly) {
+			// ---- Simplified: Equipped-only validation ----
+			bodyStream << "== Phase 1: Equipped Gear Discovery ==\n";
+			std::vector<std::string> nifScanViolations;
+			auto equippedAssets = host.discoverEquipped ? host.discoverEquipped(nifScanViolations) : std::vector<PhysicsAsset>();
+			report.equippedNifsDiscovered = static_cast<int>(equippedAssets.size());
+			report.filesystemNifFilesDiscovered = 0;
+			report.nifScanViolationCount = static_cast<int>(nifScanViolations.size());
+			report.totalNIFsScanned = report.equippedNifsDiscovered;
+			bodyStream << "  Found " << equippedAssets.size() << " equipped physics item(s).\n";
+			bodyStream << "  NIF discovery metrics: filesystem=0, equipped=" << report.equippedNifsDiscovered
+					   << ", scan violations=" << report.nifScanViolationCount << "\n";
+
+			if (!nifScanViolations.empty()) {
+				bodyStream << "\n  -- NIF Scan Violations --\n";
+				bodyStream << "  Count: " << nifScanViolations.size() << "\n";
+				for (const auto& violation : nifScanViolations) {
+					report.errors.push_back(violation);
+					report.hasErrors = true;
+					bodyStream << "    [ERROR] " << violation << "\n";
+				}
+			}
+
+			if (!equippedAssets.empty()) {
+				bodyStream << "\n== Phase 2: Equipped Gear XML Validation ==\n";
+				validateNIFAssets(equippedAssets, report, bodyStream, host.timeStep);
+
+				bodyStream << "\n== Phase 2.5: NIF Structural Validation ==\n";
+				validateNIFStructure(equippedAssets, report, bodyStream);
+
+				bodyStream << "\n== Phase 2.6: Runtime Cost Estimate ==\n";
+				validatePhysicsCost(equippedAssets, report, bodyStream);
+			}
+		} else {
+			// ---- Full: Comprehensive validation pipeline ----
+			// Shared dedup set for this run's XML validations.
+			std::unordered_set<std::string> globalValidatedXMLs;
+
+			// Phase 0: DefaultBBP XML validation
+			auto bbpEntries = discoverDefaultBBPXMLs();
+			if (!bbpEntries.empty()) {
+				bodyStream << "== Phase 0: DefaultBBP XML Validation ==\n";
+				bodyStream << "  Found " << bbpEntries.size() << " map entries in defaultBBPs.xml.\n";
+
+				std::vector<size_t> validBatchIdx(bbpEntries.size(), SIZE_MAX);
+				std::vector<std::string> batch;
+				for (size_t i = 0; i < bbpEntries.size(); ++i) {
+					const auto& entry = bbpEntries[i];
+					if (entry.xmlPath.empty() || !entry.xmlExists)
+						continue;
+
+					auto norm = NormalizePathForComparison(entry.xmlPath);
+					if (globalValidatedXMLs.count(norm))
+						continue;
+
+					globalValidatedXMLs.insert(norm);
+					validBatchIdx[i] = batch.size();
+					batch.push_back(entry.xmlPath);
+				}
+
+				auto batchResults = parallelValidateXMLs(batch);
+
+				for (size_t i = 0; i < bbpEntries.size(); ++i) {
+					const auto& entry = bbpEntries[i];
+					size_t batchIdx = validBatchIdx[i];
+
+					bodyStream << "  [BBP]  shape=" << entry.shape << " -> " << entry.xmlPath << "\n";
+
+					if (!entry.xmlExists) {
+						std::string err = "defaultBBPs.xml: shape '" + entry.shape + "' references missing XML: " + entry.xmlPath;
+						report.errors.push_back(err);
+						report.hasErrors = true;
+						bodyStream << "    [ERROR] XML file not found\n";
+						continue;
+					}
+
+					if (batchIdx == SIZE_MAX) {
+						bodyStream << "    (already validated)\n";
+						continue;
+					}
+
+					++report.totalXMLsFound;
+					const auto& pair = batchResults[batchIdx];
+					bool fileHasErrors = hasBlockingXsdErrors(pair.first) || hasBlockingSchErrors(pair.second);
+
+					if (fileHasErrors) {
+						++report.xmlErrorCount;
+						report.hasErrors = true;
+						bodyStream << "    [FAIL]\n";
+					} else {
+						++report.xmlPassCount;
+						bodyStream << "    [OK]\n";
+					}
+
+					appendXmlViolationsToReport(pair, entry.xmlPath, report, bodyStream, host.timeStep);
+				}
+				bodyStream << "\n";
+			}
+
+			// Phase 2: NIF discovery
+			bodyStream << "\n== Phase 2: NIF File Discovery ==\n";
+			std::vector<std::string> nifScanViolations;
+			int filesystemNifFilesDiscovered = 0;
+			int packedNifFilesDiscovered = 0;
+			// Released with the phases that use it, at the end of this block.
+			ParsedNifStore parsedNifs(static_cast<size_t>(std::max(0, g_validationConfig.parseCacheMB)) << 20);
+			auto nifAssets = discoverPhysicsAssets(&nifScanViolations, &filesystemNifFilesDiscovered,
+				&packedNifFilesDiscovered, &parsedNifs);
+			report.filesystemNifFilesDiscovered = filesystemNifFilesDiscovered;
+			report.packedNifFilesDiscovered = packedNifFilesDiscovered;
+			report.equippedNifsDiscovered = 0;
+			report.nifScanViolationCount = static_cast<int>(nifScanViolations.size());
+			report.totalNIFsScanned = report.filesystemNifFilesDiscovered;
+			std::unordered_set<std::string> relatedTRINorm;
+			for (const auto& a : nifAssets)
+				for (const auto& tri : a.relatedTRIPaths)
+					relatedTRINorm.insert(NormalizePathForComparison(tri));
+			bodyStream << "  Scanned " << filesystemNifFilesDiscovered << " NIF file(s) in data/ ("
+					   << packedNifFilesDiscovered << " of them packed in archives).\n";
+			bodyStream << "  Found " << nifAssets.size() << " NIF file(s) referencing physics configs.\n";
+			bodyStream << "  Identified " << relatedTRINorm.size() << " related TRI file(s).\n";
+			// The skeleton missing-node cross-reference is gear-only by design: a filesystem
+			// scan has no equipped actor, so there is no skeleton to resolve <bone>/constraint
+			// node names against. Say so here so a full-scan reader doesn't assume it ran.
+			bodyStream << "  Note: the skeleton missing-node check (each <bone> name and each constraint\n"
+					   << "        bodyA/bodyB vs the actor's skeleton) runs only in 'smp report gear';\n"
+					   << "        a full filesystem scan has no equipped skeleton to check against, so it\n"
+					   << "        is skipped here. Run 'smp report gear' to perform it.\n";
+
+			if (!nifScanViolations.empty()) {
+				bodyStream << "\n  -- NIF Scan Violations --\n";
+				bodyStream << "  Count: " << nifScanViolations.size() << "\n";
+				for (const auto& violation : nifScanViolations) {
+					report.errors.push_back(violation);
+					report.hasErrors = true;
+					bodyStream << "    [ERROR] " << violation << "\n";
+				}
+			}
+
+			// Phase 2.5: NIF _0/_1 pair consistency check
+			bodyStream << "\n== Phase 2.5: NIF Pair Consistency Check ==\n";
+			validateNifPairConsistency(nifAssets, report, bodyStream, &parsedNifs);
+
+			// Phase 3: NIF-referenced XML validation
+			if (!nifAssets.empty()) {
+				bodyStream << "\n== Phase 3: NIF-Referenced XML Validation ==\n";
+				validateNIFAssets(nifAssets, report, bodyStream, host.timeStep, true, &parsedNifs);
+
+				bodyStream << "\n== Phase 3.5: NIF Structural Validation ==\n";
+				validateNIFStructure(nifAssets, report, bodyStream, &parsedNifs);
+
+				bodyStream << "\n== Phase 3.6: Runtime Cost Estimate ==\n";
+				validatePhysicsCost(nifAssets, report, bodyStream, &parsedNifs);
+			}
+		}
+
+		// Stop timer
+		auto wallEnd = std::chrono::steady_clock::now();
+		double elapsedSec = std::chrono::duration<double>(wallEnd - wallStart).count();
+		report.elapsedSeconds = elapsedSec;
+
+		// Errors and warnings index (appended after body for quick reference)
+		std::ostringstream tailStream;
+		if (!report.errors.empty()) {
+			tailStream << "== Errors ==\n";
+			for (const auto& e : report.errors)
+				tailStream << "  [ERROR] " << e << "\n";
+			tailStream << "\n";
+		}
+		if (!report.warnings.empty()) {
+			tailStream << "== Warnings ==\n";
+			for (const auto& w : report.warnings)
+				tailStream << "  [WARN] " << w << "\n";
+			tailStream << "\n";
+		}
+
+		// Assemble final report: header + summary + body + tail
+		std::ostringstream reportStream;
+		reportStream << "========================================\n";
+		if (equippedOnly) {
+			reportStream << "FSMP Equipped Gear Validation Report\n";
+		} else {
+			reportStream << "FSMP Asset Validation Report\n";
+		}
+		reportStream << "Generated: " << timestamp << "\n";
+		reportStream << "========================================\n\n";
+
+		reportStream << "== Summary ==\n";
+		reportStream << "  Duration:      " << std::fixed << std::setprecision(2) << elapsedSec << "s\n";
+		reportStream << "  XMLs found:    " << report.totalXMLsFound << "\n";
+		reportStream << "  XMLs passed:   " << report.xmlPassCount << "\n";
+		reportStream << "  XMLs failed:   " << report.xmlErrorCount << "\n";
+		reportStream << "  Archives:      " << report.archivesMounted << "\n";
+		reportStream << "  NIF discovery: filesystem=" << report.filesystemNifFilesDiscovered
+					 << " (packed=" << report.packedNifFilesDiscovered << ")"
+					 << ", equipped=" << report.equippedNifsDiscovered
+					 << ", scan violations=" << report.nifScanViolationCount << "\n";
+		reportStream << "  Costly assets: " << report.costOutliersFound << "\n";
+		reportStream << "  Mesh defects:  " << report.collisionMeshIssuesFound << "\n";
+		reportStream << "  _0/_1 diffs:   " << report.nifPairMismatchesFound << "\n";
+		reportStream << "  Warnings:      " << report.warnings.size() << "\n";
+		reportStream << "  Errors:        " << report.errors.size() << "\n";
+		reportStream << "\n";
+
+		reportStream << bodyStream.str();
+		reportStream << "\n";
+		reportStream << tailStream.str();
+		reportStream << "========================================\n";
+		return reportStream.str();
+	}
+
+}  // namespace hdt
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Platform-neutral validation pipeline: discovery over std::filesystem and the BSA
+// archives of data/ (Utils/hdtDataFileSystem.h), the XML, NIF and cost phases, and the
+// report text. Paths are relative to the game directory (the
+// one holding data/), which is the working directory in game. Everything that needs
+// the running game is supplied through ValidationHost by hdtAssetValidator.cpp; the
+// standalone command-line validator (Cli/hdtValidatorCli.cpp) supplies the step and,
+// from a plugins.txt, the load order.
+namespace hdt
+{
+	struct MissingBoneRef;
+
+	// ── Config ────────────────────────────────────────────────────────────────
+
+	struct ValidationConfig
+	{
+		std::string modsDir;  // mods folder (MO2 mods/ or Vortex staging) scanned natively, bypassing the VFS
+		std::string referenceSkeleton;  // skeleton NIF the bone references of every physics asset are resolved against
+		int parseCacheMB = 512;  // memory budget of the NIF parses the scan keeps for the later phases; 0 keeps none
+	};
+
+	extern ValidationConfig g_validationConfig;
+
+	// ── Shared asset type ─────────────────────────────────────────────────────
+
+	struct PhysicsAsset
+	{
+		std::string nifPath;
+		std::string xmlPath;
+		std::vector<std::string> relatedTRIPaths;
+		std::vector<std::string> allPhysicsXmlPaths;  // all "HDT Skinned Mesh Physics Object" blocks
+		std::string nifArchive;  // archive the NIF is read from; empty when loose
+		std::string xmlArchive;  // likewise for the XML
+		bool nifExists = false;
+		bool xmlExists = false;
+		bool hasOrphanedPhysicsMarker = false;  // marker string present but no NiStringExtraData block
+	};
+
+	// ── Validation ────────────────────────────────────────────────────────────
+
+	enum class ValidationReportMode
+	{
+		Full,
+		ErrorsOnly
+	};
+
+	struct AssetValidationResult
+	{
+		bool hasErrors = false;
+		bool hasWarnings = false;
+		int skinMeshIssuesFound = 0;
+		int costOutliersFound = 0;  // heavy assets and outliers of the runtime cost estimate
+		int collisionMeshIssuesFound = 0;  // collision shapes with geometry defects
+		int nifPairMismatchesFound = 0;    // _0/_1 weight variants whose meshes differ
+		int filesystemNifFilesDiscovered = 0;  // loose and packed
+		int packedNifFilesDiscovered = 0;      // of which read from archives
+		int archivesMounted = 0;
+		int equippedNifsDiscovered = 0;
+		int nifScanViolationCount = 0;
+		int totalNIFsScanned = 0;
+		int totalXMLsFound = 0;
+		int xmlPassCount = 0;
+		int xmlErrorCount = 0;
+		int xmlWarningCount = 0;
+		double elapsedSeconds = 0.0;
+		std::vector<std::string> errors;
+		std::vector<std::string> warnings;
+		std::vector<PhysicsAsset> assets;
+	};
+
+	// What the pipeline needs from the program running it.
+	struct ValidationHost
+	{
+		float timeStep = 1 / 60.f;  // physics step the stability lint judges the settings at
+		// Equipped-gear discovery for the equipped-only pipeline: returns the equipped
+		// physics items and appends the violations found on their live nodes. Empty
+		// outside the game, where that pipeline finds nothing.
+		std::function<std::vector<PhysicsAsset>(std::vector<std::string>& outViolations)> discoverEquipped;
+		// Active plugins in load order ("Skyrim.esm", ...), which decides which archives
+		// load and which of them wins (see MountDataArchives). Empty: every archive, by name.
+		std::vector<std::string> pluginLoadOrder;
+	};
+
+	// Run the full pipeline (defaultBBPs.xml, every NIF below data/ or the configured
+	// mods dir, _0/_1 pairs, XMLs, NIF structure, runtime cost) or the equipped-only one,
+	// filling `report`. Returns the full report text, headed with `timestamp`.
+	std::string RunValidationCore(AssetValidationResult& report, const std::string& timestamp,
+		const ValidationHost& host, bool equippedOnly = false);
+
+	// The errors-only report of a finished run.
+	std::string BuildErrorsOnlyReport(const AssetValidationResult& report, const std::string& timestamp,
+		bool equippedOnly);
+
+	// One report line for a node reference the skeleton named `skeletonName` lacks.
+	std::string DescribeMissingBoneRef(const MissingBoneRef& m, const std::string& xmlPath,
+		const std::string& skeletonName);
+
+	// ── XML optimization ──────────────────────────────────────────────────────
+
+	struct XmlOptimizationResult
+	{
+		int xmlsFound = 0;
+		int xmlsOptimized = 0;  // rewritten into the output directory
+		int xmlsUnchanged = 0;  // nothing to remove, or no rewrite kept the resolved definitions
+		int xmlsFailed = 0;     // unparsable, or the copy could not be written
+		size_t bytesBefore = 0;  // of the optimized XMLs
+		size_t bytesAfter = 0;
+		double elapsedSeconds = 0.0;
+	};
+
+	// Optimize every physics XML the full pipeline covers (see OptimizePhysicsXml) into
+	// `outputDir`, which must exist. Returns the diff summary text.
+	std::string RunOptimizationCore(XmlOptimizationResult& result, const std::filesystem::path& outputDir,
+		const ValidationHost& host);
+
+	// ── NIF repair ────────────────────────────────────────────────────────────
+
+	struct NifRepairResult
+	{
+		int nifsChecked = 0;
+		int nifsRepaired = 0;      // repaired copy written (in a dry run: repairs planned)
+		int nifsUnrepairable = 0;  // skin mesh issues, none of them with a safe repair
+		int nifsFailed = 0;        // unparsable, or the repaired copy failed re-validation or could not be written
+		int repairsApplied = 0;    // rewrites of one shape, plus one per orphaned-skin removal
+		int issuesLeft = 0;        // skin mesh issues no repair addresses
+		double elapsedSeconds = 0.0;
+	};
+
+	// Repair the skin meshes of every physics NIF the full pipeline covers (see
+	// RepairNifSkinMeshes) into `outputDir`, which must exist; with `dryRun`, only plan
+	// the repairs. Returns the summary text.
+	std::string RunNifRepairCore(NifRepairResult& result, const std::filesystem::path& outputDir,
+		const ValidationHost& host, bool dryRun = false);
+
+}  // namespace hdt
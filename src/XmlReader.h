@@ -3,7 +3,10 @@
 #include "XmlInspector/CharactersReader.hpp"
 #include "XmlInspector/XmlInspector.hpp"
 
-#include "hdtSkinnedMesh/hdtBulletHelper.h"
+#include <LinearMath/btTransform.h>
+
+#include <cstdint>
+#include <string>
 
 namespace hdt
 {
@@ -13,7 +16,7 @@ namespace hdt
 		bool isEmptyStart;
 
 	public:
-		XMLReader(BYTE* data, size_t count) :
+		XMLReader(uint8_t* data, size_t count) :
 			Base(data, data + count)
 		{
 		}
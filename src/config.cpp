@@ -3,6 +3,7 @@
 #include "Validator/hdtAssetValidator.h"
 #include "XmlReader.h"
 #include "hdtSkyrimPhysicsWorld.h"
+#include "hdtSystemSnapshot.h"
 
 namespace hdt
 {
@@ -22,6 +23,18 @@ namespace hdt
 					SkyrimPhysicsWorld::get()->m_timeTick = 1.0f / SkyrimPhysicsWorld::get()->min_fps;
 				} else if (reader.GetLocalName() == "maxSubSteps") {
 					SkyrimPhysicsWorld::get()->m_maxSubSteps = btClamped(reader.readInt(), 1, 60);
+				} else if (reader.GetLocalName() == "smoothKinematics") {
+					SkyrimPhysicsWorld::get()->m_smoothKinematics = reader.readBool();
+				} else if (reader.GetLocalName() == "tethers") {
+					SkyrimPhysicsWorld::get()->m_enableTethers = reader.readBool();
+				} else if (reader.GetLocalName() == "tetherSlack") {
+					SkyrimPhysicsWorld::get()->m_tetherSlack = btClamped(reader.readFloat(), 0.f, 1.f);
+				} else if (reader.GetLocalName() == "symmetricSolver") {
+					SkyrimPhysicsWorld::get()->m_symmetricSolver = reader.readBool();
+				} else if (reader.GetLocalName() == "resetRecoverySteps") {
+					SkyrimPhysicsWorld::get()->m_resetRecoverySteps = btClamped(reader.readInt(), 0, 16);
+				} else if (reader.GetLocalName() == "maxMassRatio") {
+					SkyrimPhysicsWorld::get()->m_maxMassRatio = btClamped(reader.readFloat(), 1.f, 1000.f);
 				} else {
 					logger::warn("Unknown config : {}", reader.GetLocalName());
 					reader.skipCurrentElement();
@@ -46,6 +59,22 @@ namespace hdt
 					SkyrimPhysicsWorld::get()->m_distanceForNoWind = btClamped(reader.readFloat(), 0.f, 10000.f);
 				} else if (reader.GetLocalName() == "distanceForMaxWind") {
 					SkyrimPhysicsWorld::get()->m_distanceForMaxWind = btClamped(reader.readFloat(), 0.f, 10000.f);
+				} else if (reader.GetLocalName() == "windFieldResolution") {
+					auto world = SkyrimPhysicsWorld::get();
+					world->m_windFieldResolution = btClamped(reader.readInt(), 2, 64);
+					world->getWindField().setResolution(world->m_windFieldResolution, world->m_windFieldCellSize);
+				} else if (reader.GetLocalName() == "windFieldCellSize") {
+					auto world = SkyrimPhysicsWorld::get();
+					world->m_windFieldCellSize = btClamped(reader.readFloat(), 16.f, 4096.f);
+					world->getWindField().setResolution(world->m_windFieldResolution, world->m_windFieldCellSize);
+				} else if (reader.GetLocalName() == "aerodynamics") {
+					SkyrimPhysicsWorld::get()->m_aerodynamics = reader.readBool();
+				} else if (reader.GetLocalName() == "dragCoefficient") {
+					SkyrimPhysicsWorld::get()->m_dragCoefficient = btClamped(reader.readFloat(), 0.f, 10.f);
+				} else if (reader.GetLocalName() == "liftCoefficient") {
+					SkyrimPhysicsWorld::get()->m_liftCoefficient = btClamped(reader.readFloat(), 0.f, 10.f);
+				} else if (reader.GetLocalName() == "windAirSpeed") {
+					SkyrimPhysicsWorld::get()->m_windAirSpeed = btClamped(reader.readFloat(), 0.f, 100.f);
 				} else {
 					logger::warn("Unknown config : {}", reader.GetLocalName());
 					reader.skipCurrentElement();
@@ -93,6 +122,10 @@ namespace hdt
 					SkyrimPhysicsWorld::get()->m_unclampedResets = reader.readBool();
 				} else if (reader.GetLocalName() == "unclampedResetAngle") {
 					SkyrimPhysicsWorld::get()->m_unclampedResetAngle = reader.readFloat();
+				} else if (reader.GetLocalName() == "physicsToggleBlendTime") {
+					SkyrimPhysicsWorld::get()->m_physicsToggleBlendTime = std::max(reader.readFloat(), 0.0f);
+				} else if (reader.GetLocalName() == "persistPoses") {
+					SnapshotStore::GetSingleton()->m_enabled = reader.readBool();
 				} else if (reader.GetLocalName() == "budgetMs") {
 					SkyrimPhysicsWorld::get()->m_budgetMs = std::clamp(reader.readFloat(), 0.1f, 20.0f);
 				} else if (reader.GetLocalName() == "useRealTime") {
@@ -129,6 +162,10 @@ namespace hdt
 			case XMLReader::Inspected::StartTag:
 				if (reader.GetLocalName() == "mods-dir") {
 					g_validationConfig.modsDir = reader.readText();
+				} else if (reader.GetLocalName() == "reference-skeleton") {
+					g_validationConfig.referenceSkeleton = reader.readText();
+				} else if (reader.GetLocalName() == "parse-cache-mb") {
+					g_validationConfig.parseCacheMB = std::clamp(reader.readInt(), 0, 16384);
 				} else {
 					logger::warn("Unknown config : {}", reader.GetLocalName());
 					reader.skipCurrentElement();
@@ -195,11 +232,23 @@ namespace hdt
 		LOG("solver.erp", w->getSolverInfo().m_erp);
 		LOG("solver.min-fps", w->min_fps);
 		LOG("solver.maxSubSteps", w->m_maxSubSteps);
+		LOG("solver.smoothKinematics", w->m_smoothKinematics);
+		LOG("solver.tethers", w->m_enableTethers);
+		LOG("solver.tetherSlack", w->m_tetherSlack);
+		LOG("solver.maxMassRatio", w->m_maxMassRatio);
+		LOG("solver.resetRecoverySteps", w->m_resetRecoverySteps);
+		LOG("solver.symmetricSolver", w->m_symmetricSolver);
 
 		LOG("wind.windStrength", w->m_windStrength);
 		LOG("wind.enabled", w->m_enableWind);
 		LOG("wind.distanceForNoWind", w->m_distanceForNoWind);
 		LOG("wind.distanceForMaxWind", w->m_distanceForMaxWind);
+		LOG("wind.windFieldResolution", w->m_windFieldResolution);
+		LOG("wind.windFieldCellSize", w->m_windFieldCellSize);
+		LOG("wind.aerodynamics", w->m_aerodynamics);
+		LOG("wind.dragCoefficient", w->m_dragCoefficient);
+		LOG("wind.liftCoefficient", w->m_liftCoefficient);
+		LOG("wind.windAirSpeed", w->m_windAirSpeed);
 
 		LOG("smp.logLevel", 5 - g_logLevel);
 
@@ -212,6 +261,8 @@ namespace hdt
 		LOG("smp.rotationSpeedLimit", w->m_rotationSpeedLimit);
 		LOG("smp.unclampedResets", w->m_unclampedResets);
 		LOG("smp.unclampedResetAngle", w->m_unclampedResetAngle);
+		LOG("smp.physicsToggleBlendTime", w->m_physicsToggleBlendTime);
+		LOG("smp.persistPoses", SnapshotStore::GetSingleton()->m_enabled);
 		LOG("smp.budgetMS", w->m_budgetMs);
 		LOG("smp.useRealTime", w->m_useRealTime);
 		LOG("smp.minCullingDistance", a->m_minCullingDistance);
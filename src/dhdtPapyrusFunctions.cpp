@@ -89,10 +89,13 @@ std::vector<bool> hdt::papyrus::impl::TogglePhysicsImpl(RE::Actor* actor, std::v
 			auto world = hdt::SkyrimPhysicsWorld::get();
 			auto simLock = world->lockSimulation();
 
+			std::unordered_set<SkyrimSystem*> toggledSystems;
+			std::unordered_set<SkinnedMeshBone*> toggledBones;
+
 			for (size_t i = 0; i < boneNames.size(); ++i) {
 				bool foundAny = false;
 
-				auto processBone = [&](SkinnedMeshBone* bone) {
+				auto processBone = [&](SkyrimSystem* system, SkinnedMeshBone* bone) {
 					if (!bone)
 						return;
 
@@ -122,20 +125,45 @@ std::vector<bool> hdt::papyrus::impl::TogglePhysicsImpl(RE::Actor* actor, std::v
 					bone->m_rig.setInterpolationAngularVelocity(zero);
 
 					world->updateConstraintsForBone(bone);
+					bone->beginToggleBlend(world->m_physicsToggleBlendTime);
+
+					toggledSystems.insert(system);
+					toggledBones.insert(bone);
 				};
 
 				for (auto& armor : skeleton.getArmors()) {
 					if (armor.m_physics) {
-						processBone(armor.m_physics->findBone(boneNames[i]));
+						processBone(armor.m_physics.get(), armor.m_physics->findBone(boneNames[i]));
 					}
 				}
 
 				for (auto& headPart : skeleton.head.headParts) {
 					if (headPart.m_physics) {
-						processBone(headPart.m_physics->findBone(boneNames[i]));
+						processBone(headPart.m_physics.get(), headPart.m_physics->findBone(boneNames[i]));
 					}
 				}
 			}
+
+			// The colliders skinned to the toggled bones changed flexibility: the trees are partitioned again, so that
+			// the pairs that became all kinematic aren't tested anymore, and the new dynamic ones are.
+			for (auto system : toggledSystems) {
+				for (auto& body : system->meshes()) {
+					const bool affected = std::any_of(body->m_skinnedBones.begin(), body->m_skinnedBones.end(), [&](const SkinnedMeshBody::SkinnedBone& b) {
+						return toggledBones.contains(b.ptr);
+					});
+					if (affected)
+						body->updateKinematic();
+				}
+			}
+
+			// The tethers and the root-to-tip order are built from which bones are kinematic: build them again, and
+			// give the constraints to the world in the new order.
+			for (auto system : toggledSystems) {
+				system->buildTethers();
+				system->buildSolverOrder();
+			}
+			if (!toggledSystems.empty())
+				world->restoreConstraintOrder();
 		}
 		break;
 	}
@@ -0,0 +1,223 @@
+#include "hdtExternalCollider.h"
+#include "hdtSkinnedMesh/hdtSkinnedMeshShape.h"
+#include "hdtSkyrimPhysicsWorld.h"
+
+#include <LinearMath/btConvexHullComputer.h>
+
+namespace hdt
+{
+	namespace
+	{
+		// The bone rigid bodies don't take part in the Bullet collision, they only need a shape to exist.
+		btEmptyShape emptyShape;
+
+		btRigidBody::btRigidBodyConstructionInfo& kinematicInfo()
+		{
+			static btRigidBody::btRigidBodyConstructionInfo ci(0, nullptr, &emptyShape);
+			return ci;
+		}
+
+		Vertex boundVertex(const btVector3& p)
+		{
+			Vertex v(p.x(), p.y(), p.z());
+			v.m_weight[0] = 1.0f;
+			v.setBoneIdx(0, 0);
+			return v;
+		}
+	}
+
+	ExternalColliderBone::ExternalColliderBone(const RE::BSFixedString& name, const btTransform& transform) :
+		SkinnedMeshBone(name, kinematicInfo()), m_target(transform)
+	{
+		m_rig.setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
+		m_rig.setWorldTransform(transform);
+		m_rig.setInterpolationWorldTransform(transform);
+		m_currentTransform = btQsTransform(transform);
+	}
+
+	void ExternalColliderBone::setTarget(const btTransform& transform, bool teleport)
+	{
+		std::lock_guard<decltype(m_targetLock)> l(m_targetLock);
+		m_target = transform;
+		m_teleport = m_teleport || teleport;
+	}
+
+	void ExternalColliderBone::readTransform(float timeStep)
+	{
+		btTransform dest;
+		bool teleport;
+		{
+			std::lock_guard<decltype(m_targetLock)> l(m_targetLock);
+			dest = m_target;
+			teleport = m_teleport;
+			m_teleport = false;
+		}
+
+		if (teleport || timeStep <= RESET_PHYSICS) {
+			static const btVector3 zero(0, 0, 0);
+			m_rig.setWorldTransform(dest);
+			m_rig.setInterpolationWorldTransform(dest);
+			m_rig.setLinearVelocity(zero);
+			m_rig.setAngularVelocity(zero);
+			m_rig.setInterpolationLinearVelocity(zero);
+			m_rig.setInterpolationAngularVelocity(zero);
+			m_kinematicTrack.reset();
+		} else {
+			btVector3 linVel, angVel;
+			btTransformUtil::calculateVelocity(m_rig.getWorldTransform(), dest, timeStep, linVel, angVel);
+			m_rig.setLinearVelocity(linVel);
+			m_rig.setAngularVelocity(angVel);
+			m_rig.setInterpolationLinearVelocity(linVel);
+			m_rig.setInterpolationAngularVelocity(angVel);
+			m_kinematicTrack.push(m_rig.getWorldTransform(), dest, timeStep);
+		}
+	}
+
+	RE::BSTSmartPointer<ExternalColliderBody> ExternalColliderBody::create(const ExternalColliderInfo& info)
+	{
+		auto body = RE::make_smart<ExternalColliderBody>();
+		body->m_name = info.m_name;
+		body->m_bone = RE::make_smart<ExternalColliderBone>(info.m_name, info.m_transform);
+		body->m_tags = info.m_tags;
+		body->m_canCollideWithTags = info.m_canCollideWithTags;
+		body->m_noCollideWithTags = info.m_noCollideWithTags;
+
+		bool built = false;
+		switch (info.m_shape) {
+		case ExternalColliderInfo::Shape::Sphere:
+			built = body->buildSphereChain({ btVector3(0, 0, 0) }, info.m_radius);
+			break;
+		case ExternalColliderInfo::Shape::Capsule:
+			{
+				// Spheres half a radius apart, the dips between them are about 3% of the radius.
+				constexpr size_t maxSpheres = 64;
+				const btScalar halfHeight = btMax(info.m_halfHeight, btScalar(0.0f));
+				const size_t intervals = info.m_radius > 0.0f ?
+				                             std::min(maxSpheres - 1, static_cast<size_t>(std::ceil(halfHeight * 4.0f / info.m_radius))) :
+				                             0;
+				std::vector<btVector3> centers;
+				for (size_t i = 0; i <= intervals; ++i) {
+					const btScalar t = intervals ? static_cast<btScalar>(i) / static_cast<btScalar>(intervals) : 0.5f;
+					centers.emplace_back(0.0f, 0.0f, (t * 2.0f - 1.0f) * halfHeight);
+				}
+				built = body->buildSphereChain(centers, info.m_radius);
+			}
+			break;
+		case ExternalColliderInfo::Shape::Box:
+			{
+				const btVector3& e = info.m_halfExtents;
+				std::vector<btVector3> corners;
+				for (int i = 0; i < 8; ++i)
+					corners.emplace_back(i & 1 ? e.x() : -e.x(), i & 2 ? e.y() : -e.y(), i & 4 ? e.z() : -e.z());
+				built = body->buildHull(corners, info.m_margin);
+			}
+			break;
+		case ExternalColliderInfo::Shape::ConvexHull:
+			if (info.m_points.size() > ExternalColliderInfo::maxHullPoints) {
+				logger::warn("External collider {} has {} hull points, the maximum is {}", info.m_name.c_str(), info.m_points.size(), ExternalColliderInfo::maxHullPoints);
+				return nullptr;
+			}
+			built = body->buildHull(info.m_points, info.m_margin);
+			break;
+		}
+
+		if (!built) {
+			logger::warn("External collider {} has a degenerate shape, ignored", info.m_name.c_str());
+			return nullptr;
+		}
+
+		body->finishBuild();
+		return body;
+	}
+
+	bool ExternalColliderBody::buildSphereChain(const std::vector<btVector3>& centers, btScalar radius)
+	{
+		if (radius <= 0.0f || centers.empty())
+			return false;
+
+		btScalar extent = 0;
+		for (auto& c : centers) {
+			m_vertices.push_back(boundVertex(c));
+			extent = btMax(extent, c.length());
+		}
+
+		addBone(m_bone.get(), btQsTransform(), BoundingSphere(btVector3(0, 0, 0), extent + radius));
+
+		// The vertex margin multiplier is 1, so the margin is the radius of the spheres.
+		auto shape = RE::make_smart<PerVertexShape>(this);
+		shape->m_shapeProp.margin = radius;
+		shape->autoGen();
+		return true;
+	}
+
+	// Boxes and hulls are closed triangle meshes with one-sided faces pointing outwards,
+	// deep enough to push back anything that reached the center.
+	bool ExternalColliderBody::buildHull(const std::vector<btVector3>& points, btScalar margin)
+	{
+		if (points.size() < 4)
+			return false;
+
+		std::vector<float> coords;
+		coords.reserve(points.size() * 3);
+		for (auto& p : points) {
+			coords.push_back(p.x());
+			coords.push_back(p.y());
+			coords.push_back(p.z());
+		}
+
+		btConvexHullComputer hull;
+		hull.compute(coords.data(), static_cast<int>(sizeof(float) * 3), static_cast<int>(points.size()), 0.0f, 0.0f);
+		if (hull.vertices.size() < 4 || hull.faces.size() < 4)
+			return false;
+
+		btVector3 centroid(0, 0, 0);
+		for (int i = 0; i < hull.vertices.size(); ++i)
+			centroid += hull.vertices[i];
+		centroid /= static_cast<btScalar>(hull.vertices.size());
+
+		btScalar extent = 0;
+		for (int i = 0; i < hull.vertices.size(); ++i) {
+			m_vertices.push_back(boundVertex(hull.vertices[i]));
+			extent = btMax(extent, (hull.vertices[i] - centroid).length());
+		}
+
+		addBone(m_bone.get(), btQsTransform(), BoundingSphere(centroid, extent + margin));
+
+		auto shape = RE::make_smart<PerTriangleShape>(this);
+		shape->m_shapeProp.margin = margin;
+
+		btScalar depth = BT_LARGE_FLOAT;
+		std::vector<int> loop;
+		for (int f = 0; f < hull.faces.size(); ++f) {
+			loop.clear();
+			auto first = &hull.edges[hull.faces[f]];
+			auto edge = first;
+			do {
+				loop.push_back(edge->getSourceVertex());
+				edge = edge->getNextEdgeOfFace();
+			} while (edge != first);
+
+			for (size_t k = 1; k + 1 < loop.size(); ++k) {
+				int a = loop[0];
+				int b = loop[k];
+				int c = loop[k + 1];
+				auto& pa = hull.vertices[a];
+				auto normal = (hull.vertices[b] - pa).cross(hull.vertices[c] - pa);
+				if (normal.fuzzyZero())
+					continue;
+				if (normal.dot(pa - centroid) < 0) {
+					std::swap(b, c);
+					normal = -normal;
+				}
+				depth = btMin(depth, normal.normalized().dot(pa - centroid));
+				shape->addTriangle(a, b, c);
+			}
+		}
+
+		if (depth <= 0.0f || depth == BT_LARGE_FLOAT)
+			return false;
+
+		shape->m_shapeProp.penetration = depth;
+		return true;
+	}
+}
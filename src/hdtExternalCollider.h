@@ -0,0 +1,68 @@
+#pragma once
+
+#include "hdtSkyrimBody.h"
+
+namespace hdt
+{
+	// A kinematic primitive that doesn't come from an armor NIF, e.g. a weapon, a shield or a piece of furniture
+	// registered by another plugin. It is built as a regular skinned body bound to a single bone, so that it goes
+	// through the same broadphase and narrowphase as everything else.
+	struct ExternalColliderInfo
+	{
+		enum class Shape
+		{
+			Sphere,
+			Capsule,     // along the local z axis
+			Box,
+			ConvexHull,
+		};
+
+		static constexpr size_t maxHullPoints = 64;
+
+		RE::BSFixedString m_name;
+		Shape m_shape = Shape::Sphere;
+		btScalar m_radius = 10.0f;      // sphere and capsule
+		btScalar m_halfHeight = 0.0f;   // capsule, distance from the center to the center of a cap
+		btVector3 m_halfExtents = btVector3(10.0f, 10.0f, 10.0f);
+		std::vector<btVector3> m_points;  // convex hull, local space
+		btScalar m_margin = 1.0f;       // thickness added to the faces of boxes and hulls
+		btTransform m_transform = btTransform::getIdentity();
+
+		std::vector<RE::BSFixedString> m_tags;
+		std::unordered_set<RE::BSFixedString> m_canCollideWithTags;
+		std::unordered_set<RE::BSFixedString> m_noCollideWithTags;
+	};
+
+	// Follows a transform pushed from outside instead of a skeleton node.
+	class ExternalColliderBone : public SkinnedMeshBone
+	{
+	public:
+		ExternalColliderBone(const RE::BSFixedString& name, const btTransform& transform);
+
+		// Can be called from any thread. The bone moves there smoothly during the next step, unless teleport is set.
+		void setTarget(const btTransform& transform, bool teleport);
+
+		void readTransform(float timeStep) override;
+		void writeTransform() override {}
+
+	private:
+		SpinLock m_targetLock;
+		btTransform m_target;
+		bool m_teleport = true;
+	};
+
+	class ExternalColliderBody : public SkyrimBody
+	{
+	public:
+		// Returns nullptr if the shape is degenerate.
+		static RE::BSTSmartPointer<ExternalColliderBody> create(const ExternalColliderInfo& info);
+
+		ExternalColliderBone* bone() const { return m_bone.get(); }
+
+	private:
+		bool buildSphereChain(const std::vector<btVector3>& centers, btScalar radius);
+		bool buildHull(const std::vector<btVector3>& points, btScalar margin);
+
+		RE::BSTSmartPointer<ExternalColliderBone> m_bone;
+	};
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+// Plain file access with no game dependency, shared by the runtime and the Validator
+// (whose standalone command-line build has no CommonLibSSE). Reads through the game's
+// archives belong in NetImmerseUtils.h (readAllFile).
+namespace hdt
+{
+	static inline std::string readAllFile2(const char* path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream.is_open()) {
+			return "";
+		}
+
+		stream.seekg(0, std::ios::end);
+		auto size = stream.tellg();
+		stream.seekg(0, std::ios::beg);
+		std::string ret;
+		ret.resize(size);
+		stream.read(&ret[0], size);
+		return ret;
+	}
+}  // namespace hdt
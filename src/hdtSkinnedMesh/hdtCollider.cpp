@@ -121,19 +121,32 @@ namespace hdt
 	}
 
 	void ColliderTree::updateKinematic(const std::function<float(const Collider*)>& func)
+	{
+		updateKinematic(colliders.data(), colliders.data() + colliders.size(), false, func);
+	}
+
+	void ColliderTree::repartitionKinematic(const std::function<float(const Collider*)>& func)
+	{
+		updateKinematic(cbuf, cbuf + numCollider, true, func);
+	}
+
+	void ColliderTree::updateKinematic(Collider* begin, Collider* end, bool exported, const std::function<float(const Collider*)>& func)
 	{
 		U32 k = true;
-		for (auto& i : colliders) {
-			i.flexible = func(&i);
-			k &= i.flexible < FLT_EPSILON;
+		for (auto i = begin; i < end; ++i) {
+			i->flexible = func(i);
+			k &= i->flexible < FLT_EPSILON;
 		}
 
 		for (auto& i : children) {
-			i.updateKinematic(func);
+			if (exported)
+				i.repartitionKinematic(func);
+			else
+				i.updateKinematic(func);
 			k &= i.isKinematic;
 		}
 
-		std::sort(colliders.begin(), colliders.end(), [](const Collider& a, const Collider& b) {
+		std::sort(begin, end, [](const Collider& a, const Collider& b) {
 			return a.flexible > b.flexible;
 		});
 		std::sort(children.begin(), children.end(), [](const ColliderTree& a, const ColliderTree& b) {
@@ -149,8 +162,9 @@ namespace hdt
 				if (children[dynChild].isKinematic)
 					break;
 
-			for (dynCollider = 0; dynCollider < colliders.size(); ++dynCollider)
-				if (colliders[dynCollider].flexible < FLT_EPSILON)
+			const auto count = static_cast<U32>(end - begin);
+			for (dynCollider = 0; dynCollider < count; ++dynCollider)
+				if (begin[dynCollider].flexible < FLT_EPSILON)
 					break;
 		}
 	}
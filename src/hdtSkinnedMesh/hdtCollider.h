@@ -75,6 +75,8 @@ namespace hdt
 		void checkCollisionR(ColliderTree* r, std::vector<std::pair<ColliderTree*, ColliderTree*>>& ret);
 		void clipCollider(const std::function<bool(const Collider&)>& func);
 		void updateKinematic(const std::function<float(const Collider*)>& func);
+		// Same, once the colliders are exported: they are sorted in place in the buffer of the shape.
+		void repartitionKinematic(const std::function<float(const Collider*)>& func);
 		void visitColliders(const std::function<void(Collider*)>& func);
 		void updateAabb();
 		void optimize();
@@ -83,5 +85,8 @@ namespace hdt
 
 		bool collapseCollideL(ColliderTree* r);
 		bool collapseCollideR(ColliderTree* r);
+
+	private:
+		void updateKinematic(Collider* begin, Collider* end, bool exported, const std::function<float(const Collider*)>& func);
 	};
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "hdtBoneScaleConstraint.h"
+#include "hdtShapeMatchingConstraint.h"
 
 namespace hdt
 {
@@ -12,5 +13,6 @@ namespace hdt
 				i->scaleConstraint();
 		}
 		std::vector<RE::BSTSmartPointer<BoneScaleConstraint>> m_constraints;
+		std::vector<RE::BSTSmartPointer<ShapeMatchingConstraint>> m_shapeMatchings;  // solved after the constraints
 	};
 }
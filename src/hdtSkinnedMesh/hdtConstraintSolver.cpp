@@ -0,0 +1,20 @@
+#include "hdtConstraintSolver.h"
+#include "hdtSkyrimPhysicsWorld.h"
+
+namespace hdt
+{
+	btScalar ConstraintSolver::solveSingleIteration(int iteration, btCollisionObject** bodies, int numBodies,
+		btPersistentManifold** manifoldPtr, int numManifolds, btTypedConstraint** constraints, int numConstraints,
+		const btContactSolverInfo& infoGlobal, btIDebugDraw* debugDrawer)
+	{
+		// The order is rebuilt forwards for every island, reversing it before each following iteration alternates.
+		if (iteration > 0 && hdt::SkyrimPhysicsWorld::get()->m_symmetricSolver) {
+			const int n = m_orderNonContactConstraintPool.size();
+			for (int i = 0; i < n / 2; ++i)
+				m_orderNonContactConstraintPool.swap(i, n - 1 - i);
+		}
+
+		return btSequentialImpulseConstraintSolver::solveSingleIteration(iteration, bodies, numBodies, manifoldPtr,
+			numManifolds, constraints, numConstraints, infoGlobal, debugDrawer);
+	}
+}
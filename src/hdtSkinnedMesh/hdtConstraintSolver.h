@@ -0,0 +1,22 @@
+#pragma once
+
+#include "hdtBulletHelper.h"
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
+
+namespace hdt
+{
+	// Sequential impulse solver going through the constraints of an island alternately forwards and backwards
+	// (symmetric Gauss-Seidel). The constraints of the systems are added root to tip (see
+	// SkinnedMeshSystem::buildSolverOrder), so the corrections travel down the chains and back up on every other
+	// iteration instead of only one way, and long chains converge in fewer iterations.
+	class ConstraintSolver : public btSequentialImpulseConstraintSolver
+	{
+	public:
+		BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	protected:
+		btScalar solveSingleIteration(int iteration, btCollisionObject** bodies, int numBodies,
+			btPersistentManifold** manifoldPtr, int numManifolds, btTypedConstraint** constraints, int numConstraints,
+			const btContactSolverInfo& infoGlobal, btIDebugDraw* debugDrawer) override;
+	};
+}
@@ -0,0 +1,60 @@
+#include "hdtContactReport.h"
+
+namespace hdt
+{
+	void ContactReport::addContact(SkinnedMeshBody* bodyA, SkinnedMeshBody* bodyB, SkinnedMeshBone* boneA, SkinnedMeshBone* boneB,
+		const btVector3& position, const btVector3& normal, btScalar impulse)
+	{
+		auto [it, inserted] = m_current.try_emplace(Key{ bodyA, bodyB, boneA, boneB });
+		auto& record = it->second;
+		if (inserted) {
+			record.bodyA = bodyA;
+			record.bodyB = bodyB;
+			record.boneA = boneA;
+			record.boneB = boneB;
+			record.impulse = 0;
+		}
+
+		// keep the latest substep geometry, but the impulse of the whole frame
+		record.position = position;
+		record.normal = normal;
+		record.impulse += impulse;
+	}
+
+	void ContactReport::endFrame()
+	{
+		m_records.clear();
+		m_records.reserve(m_current.size() + m_previous.size());
+
+		for (auto& [key, record] : m_current) {
+			record.phase = m_previous.contains(key) ? ContactRecord::Phase::Persist : ContactRecord::Phase::Begin;
+			m_records.push_back(record);
+		}
+
+		for (auto& [key, record] : m_previous) {
+			if (!m_current.contains(key)) {
+				m_records.push_back(record);
+				m_records.back().phase = ContactRecord::Phase::End;
+				m_records.back().impulse = 0;
+			}
+		}
+
+		std::swap(m_previous, m_current);
+		m_current.clear();
+	}
+
+	void ContactReport::removeBody(const SkinnedMeshBody* body)
+	{
+		auto isOf = [body](const auto& entry) { return entry.first.bodyA == body || entry.first.bodyB == body; };
+		std::erase_if(m_current, isOf);
+		std::erase_if(m_previous, isOf);
+		std::erase_if(m_records, [body](const ContactRecord& r) { return r.bodyA == body || r.bodyB == body; });
+	}
+
+	void ContactReport::clear()
+	{
+		m_current.clear();
+		m_previous.clear();
+		m_records.clear();
+	}
+}
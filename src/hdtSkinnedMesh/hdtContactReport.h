@@ -0,0 +1,79 @@
+#pragma once
+
+#include "hdtBulletHelper.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace hdt
+{
+	struct SkinnedMeshBone;
+	class SkinnedMeshBody;
+
+	// One bone-to-bone contact of a frame, merged over the substeps.
+	struct ContactRecord
+	{
+		enum class Phase : uint8_t
+		{
+			Begin,    // the pair wasn't touching during the previous frame
+			Persist,  // the pair was already touching during the previous frame
+			End,      // the pair was touching during the previous frame but isn't anymore
+		};
+
+		SkinnedMeshBody* bodyA;
+		SkinnedMeshBody* bodyB;
+		SkinnedMeshBone* boneA;
+		SkinnedMeshBone* boneB;
+		btVector3 position;  // on B, world space
+		btVector3 normal;    // on B
+		btScalar impulse;    // normal impulse applied by the solver, summed over the substeps
+		Phase phase;
+	};
+
+	// Collects the contacts solved during a frame and classifies them against the previous frame.
+	// The manifolds are destroyed at the end of each substep, so the contacts have to be gathered
+	// in solveConstraints, right after the solver wrote the applied impulses back.
+	class ContactReport
+	{
+	public:
+		void addContact(SkinnedMeshBody* bodyA, SkinnedMeshBody* bodyB, SkinnedMeshBone* boneA, SkinnedMeshBone* boneB,
+			const btVector3& position, const btVector3& normal, btScalar impulse);
+
+		// Builds the records of the frame; must be called once after the last substep.
+		void endFrame();
+
+		// Forgets the contacts of a body that is leaving the world, without reporting their end.
+		void removeBody(const SkinnedMeshBody* body);
+
+		void clear();
+
+		const std::vector<ContactRecord>& records() const { return m_records; }
+
+	private:
+		struct Key
+		{
+			SkinnedMeshBody* bodyA;
+			SkinnedMeshBody* bodyB;
+			SkinnedMeshBone* boneA;
+			SkinnedMeshBone* boneB;
+
+			bool operator==(const Key& rhs) const = default;
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& k) const
+			{
+				size_t h = std::hash<void*>()(k.bodyA);
+				h = h * 31 + std::hash<void*>()(k.bodyB);
+				h = h * 31 + std::hash<void*>()(k.boneA);
+				h = h * 31 + std::hash<void*>()(k.boneB);
+				return h;
+			}
+		};
+
+		std::unordered_map<Key, ContactRecord, KeyHash> m_current;
+		std::unordered_map<Key, ContactRecord, KeyHash> m_previous;
+		std::vector<ContactRecord> m_records;
+	};
+}
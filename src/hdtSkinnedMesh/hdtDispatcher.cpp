@@ -19,6 +19,7 @@ namespace hdt
 				btAlignedFree(manifold);
 		}
 		m_manifoldsPtr.clear();
+		m_contactSources.clear();
 	}
 
 	bool needsCollision(const SkinnedMeshBody* shape0, const SkinnedMeshBody* shape1)
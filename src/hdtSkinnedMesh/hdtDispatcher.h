@@ -40,7 +40,24 @@ namespace hdt
 
 		void clearAllManifold();
 
+		// Remembers which skinned bodies produced a manifold, so that contacts can be reported per body
+		// once the solver is done. Only recorded while m_recordContactSources is set.
+		struct ContactSource
+		{
+			btPersistentManifold* manifold;
+			SkinnedMeshBody* body0;
+			SkinnedMeshBody* body1;
+		};
+
+		void addContactSource(btPersistentManifold* manifold, SkinnedMeshBody* body0, SkinnedMeshBody* body1)
+		{
+			std::lock_guard<decltype(m_lock)> l(m_lock);
+			m_contactSources.push_back({ manifold, body0, body1 });
+		}
+
 		hdt::SpinLock m_lock;
 		std::vector<std::pair<SkinnedMeshBody*, SkinnedMeshBody*>> m_pairs;
+		std::vector<ContactSource> m_contactSources;
+		bool m_recordContactSources = false;
 	};
 }
@@ -0,0 +1,110 @@
+#include "hdtKinematicTrack.h"
+
+namespace hdt
+{
+	namespace
+	{
+		// Rotation vectors (axis * angle) are used for the logarithm, so that they add up with the angular velocities.
+		btVector3 logMap(btQuaternion q)
+		{
+			if (q.w() < 0)
+				q = -q;
+
+			const btVector3 v(q.x(), q.y(), q.z());
+			const btScalar sinHalfAngle = v.length();
+			if (sinHalfAngle < SIMD_EPSILON)
+				return v * 2.0f;
+			return v * (2.0f * btAtan2(sinHalfAngle, q.w()) / sinHalfAngle);
+		}
+
+		btQuaternion expMap(const btVector3& v)
+		{
+			const btScalar angle = v.length();
+			if (angle < SIMD_EPSILON)
+				return btQuaternion(v.x() * 0.5f, v.y() * 0.5f, v.z() * 0.5f, 1.0f).normalized();
+			return btQuaternion(v / angle, angle);
+		}
+
+		btQuaternion slerp(const btQuaternion& a, const btQuaternion& b, btScalar t)
+		{
+			return a * expMap(logMap(a.inverse() * b) * t);
+		}
+	}
+
+	void KinematicTrack::push(const btTransform& from, const btTransform& to, btScalar duration)
+	{
+		if (duration <= 0) {
+			reset();
+			return;
+		}
+
+		btVector3 linear, angular;
+		btTransformUtil::calculateVelocity(from, to, duration, linear, angular);
+
+		// The tangent at the start is the one the previous segment ended with. The one at the end is the derivative
+		// of the quadratic through the last three samples, which only needs the past.
+		btVector3 startLinear = linear, startAngular = angular;
+		btVector3 endLinear = linear, endAngular = angular;
+		if (m_hasPrevious) {
+			startLinear = m_endLinear;
+			startAngular = m_endAngular;
+
+			const btScalar total = m_previousDuration + duration;
+			const btScalar current = (2.0f * duration + m_previousDuration) / total;
+			const btScalar previous = duration / total;
+			endLinear = linear * current - m_previousLinear * previous;
+			endAngular = angular * current - m_previousAngular * previous;
+		}
+
+		m_hasPrevious = true;
+		m_previousDuration = duration;
+		m_previousLinear = linear;
+		m_previousAngular = angular;
+		m_endLinear = endLinear;
+		m_endAngular = endAngular;
+
+		m_p1 = from.getOrigin();
+		m_p2 = to.getOrigin();
+		m_m1 = startLinear * duration;
+		m_m2 = endLinear * duration;
+
+		// Squad control points giving the same angular velocities at both ends, in the frame of each end.
+		m_q1 = from.getRotation();
+		m_q2 = to.getRotation();
+		if (m_q1.dot(m_q2) < 0)
+			m_q2 = -m_q2;
+		const btVector3 delta = logMap(m_q1.inverse() * m_q2);
+		const btVector3 w1 = quatRotate(m_q1.inverse(), startAngular) * duration;
+		const btVector3 w2 = quatRotate(m_q2.inverse(), endAngular) * duration;
+		m_s1 = m_q1 * expMap((w1 - delta) * 0.5f);
+		m_s2 = m_q2 * expMap((delta - w2) * 0.5f);
+
+		m_duration = duration;
+		m_elapsed = 0;
+	}
+
+	void KinematicTrack::reset()
+	{
+		m_hasPrevious = false;
+		m_duration = 0;
+		m_elapsed = 0;
+	}
+
+	btTransform KinematicTrack::advance(btScalar timeStep)
+	{
+		m_elapsed = btMin(m_elapsed + timeStep, m_duration);
+		return evaluate(m_elapsed / m_duration);
+	}
+
+	btTransform KinematicTrack::evaluate(btScalar s) const
+	{
+		const btScalar s2 = s * s;
+		const btScalar s3 = s2 * s;
+		const btVector3 origin = m_p1 * (2.0f * s3 - 3.0f * s2 + 1.0f) + m_m1 * (s3 - 2.0f * s2 + s) +
+		                         m_p2 * (3.0f * s2 - 2.0f * s3) + m_m2 * (s3 - s2);
+
+		const btQuaternion rotation = slerp(slerp(m_q1, m_q2, s), slerp(m_s1, m_s2, s), 2.0f * s * (1.0f - s));
+
+		return btTransform(rotation, origin);
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "hdtBulletHelper.h"
+
+namespace hdt
+{
+	// The path followed by a kinematic bone between two animation samples.
+	// The animation is only sampled once per frame, but the frame can be simulated in several substeps.
+	// Moving the bone at a constant velocity from one sample to the next makes its velocity jump at every frame,
+	// which the dynamic bones attached to it turn into jitter. Instead, the position follows a cubic Hermite curve
+	// and the rotation a squad curve, whose tangents at the samples are estimated from the last three samples and
+	// carried over from one segment to the next, so that the path and its velocity are continuous.
+	class KinematicTrack
+	{
+	public:
+		// Starts a new segment from the transform the bone reached to the new sample, to be covered in duration.
+		void push(const btTransform& from, const btTransform& to, btScalar duration);
+
+		// Forgets the previous samples, e.g. after a teleport; the next segment starts at a constant velocity.
+		void reset();
+
+		bool active() const { return m_duration > 0; }
+
+		// Moves by timeStep along the current segment, and returns where the bone should be; stops at the sample.
+		btTransform advance(btScalar timeStep);
+
+	private:
+		btTransform evaluate(btScalar s) const;
+
+		// current segment, the tangents are scaled by the duration
+		btVector3 m_p1, m_p2, m_m1, m_m2;
+		btQuaternion m_q1, m_q2, m_s1, m_s2;
+		btScalar m_duration = 0;
+		btScalar m_elapsed = 0;
+
+		// previous segment
+		bool m_hasPrevious = false;
+		btScalar m_previousDuration = 0;
+		btVector3 m_previousLinear, m_previousAngular;  // average velocities
+		btVector3 m_endLinear, m_endAngular;            // velocities at the end
+	};
+}
@@ -0,0 +1,127 @@
+#include "hdtShapeMatchingConstraint.h"
+
+namespace hdt
+{
+	ShapeMatchingConstraint::ShapeMatchingConstraint(const std::vector<SkinnedMeshBone*>& bones)
+	{
+		m_particles.reserve(bones.size());
+		for (auto bone : bones) {
+			auto& transform = bone->m_rig.getWorldTransform();
+			m_particles.push_back({ bone, transform.getOrigin(), transform.getRotation(), bone->m_currentTransform.getScale() });
+		}
+	}
+
+	// The animated bones hold the shape as much as all the dynamic ones together, so that the accessory follows
+	// what it's attached to.
+	btScalar ShapeMatchingConstraint::weight(const Particle& particle, btScalar dynamicMass) const
+	{
+		auto& rig = particle.bone->m_rig;
+		return rig.isStaticOrKinematicObject() ? dynamicMass : 1.0f / rig.getInvMass();
+	}
+
+	void ShapeMatchingConstraint::solve(btScalar timeStep)
+	{
+		if (timeStep <= 0 || m_stiffness <= 0)
+			return;
+
+		btScalar dynamicMass = 0;
+		for (auto& particle : m_particles)
+			if (!particle.bone->m_rig.isStaticOrKinematicObject())
+				dynamicMass += 1.0f / particle.bone->m_rig.getInvMass();
+		if (dynamicMass <= 0)
+			return;
+
+		// Centers of mass, at rest and now. The masses may have changed since the rest pose was taken.
+		btScalar totalWeight = 0;
+		btVector3 restCenter(0, 0, 0), center(0, 0, 0);
+		for (auto& particle : m_particles) {
+			const btScalar w = weight(particle, dynamicMass);
+			totalWeight += w;
+			restCenter += particle.restOrigin * w;
+			center += particle.bone->m_rig.getWorldTransform().getOrigin() * w;
+		}
+		restCenter /= totalWeight;
+		center /= totalWeight;
+
+		// Rest offsets, at the current scale of the bones.
+		const size_t n = m_particles.size();
+		btAlignedObjectArray<btVector3> restOffsets;
+		restOffsets.resize(static_cast<int>(n));
+		btScalar spread = 0;
+		for (size_t i = 0; i < n; ++i) {
+			auto& particle = m_particles[i];
+			const btScalar scale = particle.restScale > FLT_EPSILON ? particle.bone->m_currentTransform.getScale() / particle.restScale : 1.0f;
+			restOffsets[static_cast<int>(i)] = (particle.restOrigin - restCenter) * scale;
+			spread += restOffsets[static_cast<int>(i)].length2() * weight(particle, dynamicMass);
+		}
+		spread = spread > FLT_EPSILON * totalWeight ? spread / totalWeight : 1.0f;
+
+		// Moment matrix of the positions; the orientations of the bones are added with the size of the shape as lever,
+		// so that the fit stays defined when the bones are aligned or only two.
+		btMatrix3x3 moment(0, 0, 0, 0, 0, 0, 0, 0, 0);
+		for (size_t i = 0; i < n; ++i) {
+			auto& particle = m_particles[i];
+			auto& transform = particle.bone->m_rig.getWorldTransform();
+			const btScalar w = weight(particle, dynamicMass);
+			const btVector3 p = (transform.getOrigin() - center) * w;
+			const btVector3& q = restOffsets[static_cast<int>(i)];
+			const btMatrix3x3 orientation(transform.getRotation() * particle.restRotation.inverse());
+			for (int r = 0; r < 3; ++r)
+				moment[r] += q * p[r] + orientation[r] * (w * spread);
+		}
+
+		// Rotational part of the moment matrix, by the iterations of Muller et al. 2016 from the last fit; converges
+		// in one or two iterations when the shape barely rotated since the previous substep.
+		for (int iteration = 0; iteration < 8; ++iteration) {
+			const btMatrix3x3 rotation(m_rotation);
+			btVector3 omega(0, 0, 0);
+			btScalar alignment = 0;
+			for (int c = 0; c < 3; ++c) {
+				omega += rotation.getColumn(c).cross(moment.getColumn(c));
+				alignment += rotation.getColumn(c).dot(moment.getColumn(c));
+			}
+			omega /= btFabs(alignment) + SIMD_EPSILON;
+
+			const btScalar angle = omega.length();
+			if (angle < 1e-6f)
+				break;
+			m_rotation = btQuaternion(omega / angle, angle) * m_rotation;
+			m_rotation.normalize();
+		}
+
+		// Frame-rate independent: the same part of the way is covered per second whatever the substeps.
+		const btScalar alpha = m_stiffness >= 1.0f ? 1.0f : 1.0f - btPow(1.0f - m_stiffness, timeStep * 60.0f);
+		const btScalar invTimeStep = 1.0f / timeStep;
+		for (size_t i = 0; i < n; ++i) {
+			auto& particle = m_particles[i];
+			auto& rig = particle.bone->m_rig;
+			if (rig.isStaticOrKinematicObject())
+				continue;
+
+			btTransform transform = rig.getWorldTransform();
+			const btVector3 goal = center + quatRotate(m_rotation, restOffsets[static_cast<int>(i)]);
+			const btVector3 move = (goal - transform.getOrigin()) * alpha;
+
+			const btQuaternion current = transform.getRotation();
+			btQuaternion goalRotation = m_rotation * particle.restRotation;
+			if (goalRotation.dot(current) < 0)
+				goalRotation = -goalRotation;
+			const btQuaternion rotation = current.slerp(goalRotation, alpha).normalized();
+			btQuaternion turn = rotation * current.inverse();
+			if (turn.w() < 0)
+				turn = -turn;
+
+			transform.setOrigin(transform.getOrigin() + move);
+			transform.setRotation(rotation);
+			rig.setWorldTransform(transform);
+			rig.setInterpolationWorldTransform(transform);
+
+			// As position-based dynamics do, the velocities take the correction so that it isn't undone next substep.
+			rig.setLinearVelocity(rig.getLinearVelocity() + move * invTimeStep);
+			const btScalar turnAngle = turn.getAngle();
+			if (turnAngle > SIMD_EPSILON)
+				rig.setAngularVelocity(rig.getAngularVelocity() + turn.getAxis() * (turnAngle * invTimeStep));
+			rig.updateInertiaTensor();
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "hdtBulletHelper.h"
+#include "hdtSkinnedMeshBone.h"
+
+namespace hdt
+{
+	// Keeps a set of bones close to the configuration they had at rest, as one rigid shape that may deform.
+	// Each substep, the rotation that best fits the rest configuration onto the current one (in the least-squares
+	// sense, the rotational part of the polar decomposition) is extracted, and the dynamic bones are moved towards
+	// their place in the fitted shape. It is meant for the semi-rigid accessories (pouches, belts, jewelry), where it
+	// replaces the many rows of the constraints tying their bones together with one closed-form step.
+	class ShapeMatchingConstraint : public RefObject
+	{
+	public:
+		BT_DECLARE_ALIGNED_ALLOCATOR();
+
+		// The bones must be at their rest pose.
+		explicit ShapeMatchingConstraint(const std::vector<SkinnedMeshBone*>& bones);
+
+		// After the solver; moves the dynamic bones and their velocities as a position-based projection.
+		void solve(btScalar timeStep);
+
+		size_t size() const { return m_particles.size(); }
+
+		float m_stiffness = 0.5f;  // part of the way to the fitted shape covered in 1/60s, 1 is rigid
+
+	protected:
+		struct Particle
+		{
+			SkinnedMeshBone* bone;
+			btVector3 restOrigin;
+			btQuaternion restRotation;
+			btScalar restScale;
+		};
+
+		btScalar weight(const Particle& particle, btScalar dynamicMass) const;
+
+		std::vector<Particle> m_particles;
+		btQuaternion m_rotation = btQuaternion::getIdentity();  // last fit, the start of the next one
+	};
+}
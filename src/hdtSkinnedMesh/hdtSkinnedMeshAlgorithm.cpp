@@ -478,6 +478,9 @@ namespace hdt
 
 			auto maniford = dispatcher->getNewManifold(&rb0->m_rig, &rb1->m_rig);
 			maniford->addManifoldPoint(newPt);
+
+			if (dispatcher->m_recordContactSources)
+				dispatcher->addContactSource(maniford, body0, body1);
 		}
 	}
 
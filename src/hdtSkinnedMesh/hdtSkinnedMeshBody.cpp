@@ -234,6 +234,18 @@ namespace hdt
 		m_useBoundingSphere = m_shape->m_colliders.size() > 10;
 	}
 
+	void SkinnedMeshBody::updateKinematic()
+	{
+		m_isKinematic = true;
+		for (auto& i : m_skinnedBones) {
+			i.isKinematic = i.ptr->m_rig.isStaticOrKinematicObject();
+			if (!i.isKinematic)
+				m_isKinematic = false;
+		}
+
+		m_shape->updateKinematic();
+	}
+
 	bool SkinnedMeshBody::canCollideWith(const SkinnedMeshBody* body) const
 	{
 		if (m_isKinematic && body->m_isKinematic)
@@ -80,6 +80,7 @@ namespace hdt
 		int addBone(SkinnedMeshBone* bone, const btQsTransform& verticesToBone, const BoundingSphere& boundingSphere);
 
 		void finishBuild();
+		void updateKinematic();  // after bones were toggled between kinematic and dynamic
 		virtual void internalUpdate();
 
 		std::vector<SkinnedBone> m_skinnedBones;
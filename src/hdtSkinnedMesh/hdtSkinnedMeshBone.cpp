@@ -25,6 +25,41 @@ namespace hdt
 		m_currentTransform.setOrigin(t.getOrigin());
 	}
 
+	// btRigidBody::applyDamping with quadratic air drag: the exact solution over the step of dv/dt = -k v - q v^2,
+	// with k from the damping of the rig (the fraction of the velocity lost per second, so that without drag this is
+	// Bullet's pow(1 - d, dt)) and q the air drag.
+	void SkinnedMeshBone::applyDamping(btScalar timeStep)
+	{
+		const btScalar linearDamping = m_rig.getLinearDamping();
+		const btScalar angularDamping = m_rig.getAngularDamping();
+
+		if (angularDamping >= 1.0f)
+			m_rig.setAngularVelocity(btVector3(0, 0, 0));
+		else if (angularDamping > 0.0f)
+			m_rig.setAngularVelocity(m_rig.getAngularVelocity() * btPow(1.0f - angularDamping, timeStep));
+
+		if (linearDamping >= 1.0f) {
+			m_rig.setLinearVelocity(btVector3(0, 0, 0));
+			return;
+		}
+
+		const btVector3& velocity = m_rig.getLinearVelocity();
+		const btScalar speed = velocity.length();
+		if (speed < SIMD_EPSILON)
+			return;
+
+		const btScalar k = -btLog(1.0f - linearDamping);
+		const btScalar q = m_airDrag;
+		btScalar newSpeed;
+		if (k < SIMD_EPSILON)
+			newSpeed = speed / (1.0f + q * speed * timeStep);
+		else {
+			const btScalar decay = btExp(-k * timeStep);
+			newSpeed = k * speed * decay / (k + q * speed * (1.0f - decay));
+		}
+		m_rig.setLinearVelocity(velocity * (newSpeed / speed));
+	}
+
 	bool SkinnedMeshBone::canCollideWith(SkinnedMeshBone* rhs)
 	{
 		if (m_canCollideWithBone.size()) {
@@ -2,6 +2,7 @@
 
 #include "hdtAABB.h"
 #include "hdtBulletHelper.h"
+#include "hdtKinematicTrack.h"
 #include <memory>
 
 namespace hdt
@@ -21,19 +22,25 @@ namespace hdt
 		float m_boudingSphereMultipler = 1.0f;
 		float m_gravityFactor = 1.0f;
 		float m_windFactor = 1.0f;  // Mapped to <wind-factor> in the XML. Acts as a multiplier for the global wind force applied to this bone (0.0 = no wind, 2.0 = double wind)
+		bool m_drivesSurface = false;  // skins a dynamic per-triangle shape, which takes the wind when aerodynamics are enabled
+		float m_airDrag = 0.0f;        // quadratic drag, fraction of the linear velocity lost per unit of length travelled
 
 		btRigidBody m_rig;
 		btTransform m_localToRig;
 		btTransform m_rigToLocal;
 		btQsTransform m_currentTransform;
+		KinematicTrack m_kinematicTrack;  // followed during the substeps while the bone is kinematic
 
 		std::vector<RE::BSFixedString> m_canCollideWithBone;
 		std::vector<RE::BSFixedString> m_noCollideWithBone;
 
 		virtual void readTransform(float timeStep) = 0;
 		virtual void writeTransform() = 0;
+		// The bone was just switched between kinematic and dynamic, its pose goes from one to the other over the duration.
+		virtual void beginToggleBlend([[maybe_unused]] float duration) {}
 
 		void internalUpdate();
+		void applyDamping(btScalar timeStep);
 
 		bool canCollideWith(SkinnedMeshBone* rhs);
 	};
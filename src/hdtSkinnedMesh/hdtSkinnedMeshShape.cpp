@@ -41,9 +41,7 @@ namespace hdt
 	void PerVertexShape::finishBuild()
 	{
 		m_tree.optimize();
-		m_tree.updateKinematic([this](const Collider* n) {
-			return m_owner->flexible(m_owner->m_vertices[n->vertex]);
-		});
+		m_tree.updateKinematic([this](const Collider* c) { return flexible(c); });
 
 		m_owner->setCollisionFlags(m_tree.isKinematic ? btCollisionObject::CF_KINEMATIC_OBJECT : 0);
 
@@ -52,6 +50,19 @@ namespace hdt
 		m_tree.remapColliders(m_colliders.data(), m_aabb.data());
 	}
 
+	// The bones of the body changed between kinematic and dynamic: the colliders are sorted again in place, so
+	// that the collision still skips the kinematic parts of the tree without rebuilding it.
+	void PerVertexShape::updateKinematic()
+	{
+		m_tree.repartitionKinematic([this](const Collider* c) { return flexible(c); });
+		m_owner->setCollisionFlags(m_tree.isKinematic ? btCollisionObject::CF_KINEMATIC_OBJECT : 0);
+	}
+
+	float PerVertexShape::flexible(const Collider* c)
+	{
+		return m_owner->flexible(m_owner->m_vertices[c->vertex]);
+	}
+
 	void PerVertexShape::internalUpdate()
 	{
 		const VertexPos* __restrict vertices = m_owner->m_vpos.data();
@@ -146,12 +157,7 @@ namespace hdt
 	void PerTriangleShape::finishBuild()
 	{
 		m_tree.optimize();
-		m_tree.updateKinematic([=](const Collider* c) {
-			float k = m_owner->flexible(m_owner->m_vertices[c->vertices[0]]);
-			k += m_owner->flexible(m_owner->m_vertices[c->vertices[1]]);
-			k += m_owner->flexible(m_owner->m_vertices[c->vertices[2]]);
-			return k / 3;
-		});
+		m_tree.updateKinematic([this](const Collider* c) { return flexible(c); });
 
 		m_owner->setCollisionFlags(m_tree.isKinematic ? btCollisionObject::CF_KINEMATIC_OBJECT : 0);
 
@@ -169,6 +175,21 @@ namespace hdt
 		m_verticesCollision->finishBuild();
 	}
 
+	void PerTriangleShape::updateKinematic()
+	{
+		m_tree.repartitionKinematic([this](const Collider* c) { return flexible(c); });
+		m_owner->setCollisionFlags(m_tree.isKinematic ? btCollisionObject::CF_KINEMATIC_OBJECT : 0);
+		m_verticesCollision->updateKinematic();
+	}
+
+	float PerTriangleShape::flexible(const Collider* c)
+	{
+		float k = m_owner->flexible(m_owner->m_vertices[c->vertices[0]]);
+		k += m_owner->flexible(m_owner->m_vertices[c->vertices[1]]);
+		k += m_owner->flexible(m_owner->m_vertices[c->vertices[2]]);
+		return k / 3;
+	}
+
 	void PerTriangleShape::markUsedVertices(bool* flags)
 	{
 		for (auto& i : m_colliders) {
@@ -24,6 +24,7 @@ namespace hdt
 
 		virtual void clipColliders();
 		virtual void finishBuild() = 0;
+		virtual void updateKinematic() = 0;
 		virtual void internalUpdate() = 0;
 		virtual void markUsedVertices(bool* flags) = 0;
 		virtual void remapVertices(UINT* map) = 0;
@@ -56,6 +57,7 @@ namespace hdt
 		inline float baryWeight([[maybe_unused]] const btVector3& w, [[maybe_unused]] int boneIdx) override final { return 1; }
 
 		void finishBuild() override;
+		void updateKinematic() override;
 		void markUsedVertices(bool* flags) override;
 		void remapVertices(UINT* map) override;
 		void autoGen();
@@ -64,6 +66,9 @@ namespace hdt
 		{
 			float margin = 1.0f;
 		} m_shapeProp;
+
+	private:
+		float flexible(const Collider* c);
 	};
 
 	class PerTriangleShape : public SkinnedMeshShape
@@ -103,6 +108,7 @@ namespace hdt
 		inline float baryWeight(const btVector3& w, int boneIdx) override final { return w[boneIdx / 4]; }
 
 		void finishBuild() override;
+		void updateKinematic() override;
 		void markUsedVertices(bool* flags) override;
 		void remapVertices(UINT* map) override;
 
@@ -115,5 +121,8 @@ namespace hdt
 		} m_shapeProp;
 
 		RE::BSTSmartPointer<PerVertexShape> m_verticesCollision;
+
+	private:
+		float flexible(const Collider* c);
 	};
 }
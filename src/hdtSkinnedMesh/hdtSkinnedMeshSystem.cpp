@@ -4,6 +4,10 @@
 #include "hdtSkinnedMeshBody.h"
 #include "hdtSkinnedMeshShape.h"
 
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+
 namespace hdt
 {
 	void SkinnedMeshSystem::readTransform(float timeStep)
@@ -44,6 +48,33 @@ namespace hdt
 			i->updateBoundingSphereAabb();
 	}
 
+	SkinnedMeshSystem::Stats SkinnedMeshSystem::stats() const
+	{
+		Stats ret;
+		ret.bones = static_cast<uint32_t>(m_bones.size());
+		ret.bodies = static_cast<uint32_t>(m_meshes.size());
+		ret.constraints = static_cast<uint32_t>(m_constraints.size());
+		for (auto& i : m_constraintGroups)
+			ret.constraints += static_cast<uint32_t>(i->m_constraints.size());
+
+		for (auto& i : m_meshes)
+			ret.colliders += static_cast<uint32_t>(i->m_shape->m_colliders.size());
+
+		btScalar speedSum = 0;
+		for (auto& i : m_bones) {
+			if (i->m_rig.isStaticOrKinematicObject())
+				continue;
+			const btScalar speed = i->m_rig.getLinearVelocity().length();
+			ret.maxLinearSpeed = btMax(ret.maxLinearSpeed, speed);
+			speedSum += speed;
+			++ret.dynamicBones;
+		}
+		if (ret.dynamicBones)
+			ret.averageLinearSpeed = speedSum / static_cast<btScalar>(ret.dynamicBones);
+
+		return ret;
+	}
+
 	void SkinnedMeshSystem::gather(std::vector<SkinnedMeshBody*>& bodies, std::vector<SkinnedMeshShape*>& shapes)
 	{
 		for (auto& i : m_meshes) {
@@ -56,4 +87,212 @@ namespace hdt
 			}
 		}
 	}
+
+	void SkinnedMeshSystem::buildTethers()
+	{
+		m_tethers.clear();
+
+		const size_t n = m_bones.size();
+		std::unordered_map<SkinnedMeshBone*, size_t> index;
+		for (size_t i = 0; i < n; ++i)
+			index.emplace(m_bones[i].get(), i);
+
+		std::vector<std::vector<std::pair<size_t, btScalar>>> links(n);
+		auto link = [&](const BoneScaleConstraint* constraint) {
+			auto a = index.find(constraint->m_boneA);
+			auto b = index.find(constraint->m_boneB);
+			if (a == index.end() || b == index.end())
+				return;
+
+			// Measured the first time only: a rebuild after a toggle must not take the current stretch as the rest.
+			auto [it, inserted] = m_linkLengths.try_emplace(constraint, btScalar(0));
+			if (inserted) {
+				const auto& originA = constraint->m_boneA->m_rig.getWorldTransform().getOrigin();
+				const auto& originB = constraint->m_boneB->m_rig.getWorldTransform().getOrigin();
+				const btScalar scale = constraint->m_boneA->m_currentTransform.getScale();
+				it->second = (originA - originB).length() / (scale > FLT_EPSILON ? scale : btScalar(1));
+			}
+			const btScalar length = it->second;
+			links[a->second].emplace_back(b->second, length);
+			links[b->second].emplace_back(a->second, length);
+		};
+
+		for (auto& constraint : m_constraints)
+			link(constraint.get());
+		for (auto& group : m_constraintGroups)
+			for (auto& constraint : group->m_constraints)
+				link(constraint.get());
+
+		// Shortest paths from all the kinematic bones at once.
+		struct Path
+		{
+			btScalar length = BT_LARGE_FLOAT;
+			size_t anchor = SIZE_MAX;
+			uint32_t links = 0;
+		};
+
+		using Item = std::pair<btScalar, size_t>;
+		std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+		std::vector<Path> paths(n);
+		for (size_t i = 0; i < n; ++i) {
+			if (m_bones[i]->m_rig.isStaticOrKinematicObject()) {
+				paths[i] = { 0, i, 0 };
+				queue.emplace(btScalar(0), i);
+			}
+		}
+
+		while (!queue.empty()) {
+			const auto [length, i] = queue.top();
+			queue.pop();
+			if (length > paths[i].length)
+				continue;
+
+			for (auto [j, linkLength] : links[i]) {
+				if (length + linkLength < paths[j].length) {
+					paths[j] = { length + linkLength, paths[i].anchor, paths[i].links + 1 };
+					queue.emplace(paths[j].length, j);
+				}
+			}
+		}
+
+		// A bone linked directly to its anchor is already held by that constraint, the stretch comes from chains.
+		for (size_t i = 0; i < n; ++i) {
+			const auto& path = paths[i];
+			if (path.anchor == SIZE_MAX || path.links < 2)
+				continue;
+
+			m_tethers.push_back({ m_bones[path.anchor].get(), m_bones[i].get(), path.length });
+		}
+	}
+
+	void SkinnedMeshSystem::solveTethers(btScalar slack)
+	{
+		for (auto& tether : m_tethers) {
+			auto& rig = tether.bone->m_rig;
+			if (rig.isStaticOrKinematicObject())
+				continue;
+
+			auto& anchor = tether.anchor->m_rig;
+			const btScalar maxLength = tether.restLength * tether.anchor->m_currentTransform.getScale() * (1.0f + slack);
+			const btVector3 offset = rig.getWorldTransform().getOrigin() - anchor.getWorldTransform().getOrigin();
+			const btScalar length2 = offset.length2();
+			if (length2 <= maxLength * maxLength)
+				continue;
+
+			const btVector3 direction = offset / btSqrt(length2);
+			const btVector3 origin = anchor.getWorldTransform().getOrigin() + direction * maxLength;
+			rig.getWorldTransform().setOrigin(origin);
+			btTransform interpolation = rig.getInterpolationWorldTransform();
+			interpolation.setOrigin(origin);
+			rig.setInterpolationWorldTransform(interpolation);
+
+			// Only the velocity moving away from the anchor is removed, the bone can still swing and come back.
+			const btScalar away = (rig.getLinearVelocity() - anchor.getLinearVelocity()).dot(direction);
+			if (away > 0)
+				rig.setLinearVelocity(rig.getLinearVelocity() - direction * away);
+		}
+	}
+
+	void SkinnedMeshSystem::buildSolverOrder()
+	{
+		m_solverOrder.clear();
+		m_topology = {};
+
+		const size_t n = m_bones.size();
+		std::unordered_map<SkinnedMeshBone*, size_t> index;
+		for (size_t i = 0; i < n; ++i)
+			index.emplace(m_bones[i].get(), i);
+
+		for (auto& group : m_constraintGroups)
+			for (auto& constraint : group->m_constraints)
+				m_solverOrder.push_back(constraint.get());
+		for (auto& constraint : m_constraints)
+			m_solverOrder.push_back(constraint.get());
+
+		std::vector<std::vector<size_t>> links(n);
+		for (auto constraint : m_solverOrder) {
+			auto a = index.find(constraint->m_boneA);
+			auto b = index.find(constraint->m_boneB);
+			if (a == index.end() || b == index.end() || a->second == b->second)
+				continue;
+			links[a->second].push_back(b->second);
+			links[b->second].push_back(a->second);
+		}
+		// several constraints between the same bones are one link
+		for (auto& i : links) {
+			std::sort(i.begin(), i.end());
+			i.erase(std::unique(i.begin(), i.end()), i.end());
+		}
+
+		auto isDynamic = [this](size_t i) { return !m_bones[i]->m_rig.isStaticOrKinematicObject(); };
+
+		// Depth in links from all the kinematic bones at once.
+		constexpr uint32_t unreached = UINT32_MAX;
+		std::vector<uint32_t> depths(n, unreached);
+		std::queue<size_t> queue;
+		for (size_t i = 0; i < n; ++i) {
+			if (!isDynamic(i)) {
+				depths[i] = 0;
+				queue.push(i);
+			}
+		}
+		while (!queue.empty()) {
+			const size_t i = queue.front();
+			queue.pop();
+			for (auto j : links[i]) {
+				if (depths[j] == unreached) {
+					depths[j] = depths[i] + 1;
+					m_topology.maxDepth = std::max(m_topology.maxDepth, depths[j]);
+					queue.push(j);
+				}
+			}
+		}
+
+		// Connected parts of the dynamic bones.
+		std::vector<bool> visited(n, false);
+		for (size_t root = 0; root < n; ++root) {
+			if (visited[root] || !isDynamic(root))
+				continue;
+
+			size_t nodes = 0, degrees = 0, maxDegree = 0;
+			std::vector<size_t> stack{ root };
+			visited[root] = true;
+			while (!stack.empty()) {
+				const size_t i = stack.back();
+				stack.pop_back();
+				++nodes;
+				size_t degree = 0;
+				for (auto j : links[i]) {
+					if (!isDynamic(j))
+						continue;
+					++degree;
+					if (!visited[j]) {
+						visited[j] = true;
+						stack.push_back(j);
+					}
+				}
+				degrees += degree;
+				maxDegree = std::max(maxDegree, degree);
+			}
+
+			if (degrees / 2 >= nodes)
+				++m_topology.meshes;
+			else if (maxDegree > 2)
+				++m_topology.trees;
+			else
+				++m_topology.chains;
+		}
+
+		// Root to tip; the parts no kinematic bone reaches keep their declaration order, at the end.
+		auto depthOf = [&](const BoneScaleConstraint* constraint) {
+			auto a = index.find(constraint->m_boneA);
+			auto b = index.find(constraint->m_boneB);
+			const uint32_t depthA = a == index.end() ? unreached : depths[a->second];
+			const uint32_t depthB = b == index.end() ? unreached : depths[b->second];
+			return std::make_pair(std::min(depthA, depthB), std::max(depthA, depthB));
+		};
+		std::stable_sort(m_solverOrder.begin(), m_solverOrder.end(), [&](const auto a, const auto b) {
+			return depthOf(a) < depthOf(b);
+		});
+	}
 }
@@ -30,10 +30,59 @@ namespace hdt
 
 		bool valid() const { return !m_bones.empty(); }
 
+		struct Stats
+		{
+			uint32_t bones = 0;
+			uint32_t dynamicBones = 0;
+			uint32_t bodies = 0;
+			uint32_t colliders = 0;
+			uint32_t constraints = 0;
+			btScalar maxLinearSpeed = 0;
+			btScalar averageLinearSpeed = 0;  // of the dynamic bones
+		};
+
+		Stats stats() const;
+
+		// A one-sided maximum distance between a dynamic bone and the nearest kinematic bone of its chain.
+		// Long chains stretch under gravity and fast motion unless the solver does a lot of iterations;
+		// projecting the bones back within reach after the solver stops it at any iteration count.
+		struct Tether
+		{
+			SkinnedMeshBone* anchor;
+			SkinnedMeshBone* bone;
+			btScalar restLength;  // along the chain, at the first build, without the scale
+		};
+
+		// Follows the constraints from the kinematic bones; the first call must be made once the bones are at their
+		// rest pose, which the links keep for the later calls.
+		void buildTethers();
+		void solveTethers(btScalar slack);
+
+		const std::vector<Tether>& tethers() const { return m_tethers; }
+
+		// Shape of the graph of the dynamic bones linked by constraints, one entry per connected part.
+		struct Topology
+		{
+			uint32_t chains = 0;  // no branch, no loop: hair strands, tails
+			uint32_t trees = 0;   // branches but no loop
+			uint32_t meshes = 0;  // loops: cloth grids, rings
+			uint32_t maxDepth = 0;  // in links from the nearest kinematic bone
+		};
+
+		// Sorts the constraints root to tip, by their distance in links to the nearest kinematic bone, so that the
+		// solver goes down the chains in order instead of in declaration order. Must be called once all the
+		// constraints are created.
+		void buildSolverOrder();
+
+		const std::vector<BoneScaleConstraint*>& solverOrder() const { return m_solverOrder; }
+		const Topology& topology() const { return m_topology; }
+
 		std::vector<std::shared_ptr<btCollisionShape>> m_shapeRefs;
 		SkinnedMeshWorld* m_world = nullptr;
+		uint32_t m_handle = 0;  // given by the world, 0 while not in a world
 
 		bool block_resetting = false;
+		int m_recoverySteps = 0;  // substeps left pushing the dynamic bones out of the animated colliders after a reset
 		std::vector<RE::BSTSmartPointer<SkinnedMeshBone>>& getBones() { return m_bones; };
 
 	protected:
@@ -41,6 +90,10 @@ namespace hdt
 		std::vector<RE::BSTSmartPointer<SkinnedMeshBody>> m_meshes;
 		std::vector<RE::BSTSmartPointer<BoneScaleConstraint>> m_constraints;
 		std::vector<RE::BSTSmartPointer<ConstraintGroup>> m_constraintGroups;
+		std::vector<Tether> m_tethers;
+		std::unordered_map<const BoneScaleConstraint*, btScalar> m_linkLengths;  // rest lengths, without the scale
+		std::vector<BoneScaleConstraint*> m_solverOrder;  // all the constraints, owned by the members above
+		Topology m_topology;
 
 	private:
 		typedef tbb::task_group task_group;
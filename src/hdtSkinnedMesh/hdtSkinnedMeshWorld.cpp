@@ -1,5 +1,6 @@
 #include "hdtSkinnedMeshWorld.h"
 #include "hdtBoneScaleConstraint.h"
+#include "hdtConstraintSolver.h"
 #include "hdtDispatcher.h"
 #include "hdtSkinnedMeshAlgorithm.h"
 #include "hdtSkyrimPhysicsWorld.h"
@@ -25,16 +26,25 @@ namespace hdt
 
 			return concurrency;
 		}
+
+		// One solver per hardware thread, the pool owns and deletes them.
+		btConstraintSolverPoolMt* createSolverPool()
+		{
+			const int count = initBulletTbbAndGetThreadCount();
+			btAlignedObjectArray<btConstraintSolver*> solvers;
+			for (int i = 0; i < count; ++i)
+				solvers.push_back(new ConstraintSolver);
+			return new btConstraintSolverPoolMt(&solvers[0], count);
+		}
 	}
 
 	SkinnedMeshWorld::SkinnedMeshWorld() :
 		btDiscreteDynamicsWorldMt(
 			nullptr,
 			nullptr,
-			// Pool of regular sequential solvers one per hardware thread.
+			// Pool of sequential solvers one per hardware thread.
 			// Each island gets dispatched to a free solver on any thread.
-			new btConstraintSolverPoolMt(
-				initBulletTbbAndGetThreadCount()),
+			createSolverPool(),
 			nullptr,  // no Mt solver, avoids btBatchedConstraints entirely (we are not designed for that yet)
 			nullptr)
 	{
@@ -67,6 +77,15 @@ namespace hdt
 		}
 
 		m_systems.clear();
+		m_systemHandles.clear();
+
+		for (auto& body : m_externalBodies) {
+			removeCollisionObject(body.get());
+			for (auto& bone : body->m_skinnedBones)
+				removeRigidBody(&bone.ptr->m_rig);
+		}
+
+		m_externalBodies.clear();
 
 		auto solver = m_constraintSolver;
 		m_constraintSolver = nullptr;
@@ -80,22 +99,41 @@ namespace hdt
 		}
 
 		m_systems.push_back(hdt::make_smart(system));
+		// 0 is the invalid handle, skip it when the counter wraps
+		if (!m_nextSystemHandle)
+			++m_nextSystemHandle;
+		system->m_handle = m_nextSystemHandle++;
+		m_systemHandles[system->m_handle] = system;
+
 		for (int i = 0; i < system->m_meshes.size(); ++i) {
 			addCollisionObject(system->m_meshes[i].get(), 1, 1);
 		}
 
+		// The bones moving the skin of a dynamic per-triangle shape get their wind through it.
+		for (auto& body : system->m_meshes) {
+			auto shape = body->m_shape->asPerTriangleShape();
+			if (!shape || body->m_isKinematic)
+				continue;
+			for (auto& triangle : shape->m_colliders)
+				for (int c = 0; c < 3; ++c) {
+					const auto& vertex = body->m_vertices[triangle.vertices[c]];
+					for (int k = 0; k < 4; ++k)
+						if (vertex.m_weight[k] > FLT_EPSILON)
+							body->m_skinnedBones[vertex.getBoneIdx(k)].ptr->m_drivesSurface = true;
+				}
+		}
+
 		for (int i = 0; i < system->m_bones.size(); ++i) {
 			system->m_bones[i]->m_rig.setActivationState(DISABLE_DEACTIVATION);
 			// 0,0 mask disables the collision of this object on Bullet.
 			addRigidBody(&system->m_bones[i]->m_rig, 0, 0);
 		}
 
-		for (auto i : system->m_constraintGroups)
-			for (auto j : i->m_constraints)
-				addConstraint(j->m_constraint, true);
-
-		for (int i = 0; i < system->m_constraints.size(); ++i)
-			addConstraint(system->m_constraints[i]->m_constraint, true);
+		// The islands keep the order the constraints were added in, which is the order the solver goes through them.
+		std::vector<btTypedConstraint*> constraints;
+		collectConstraints(system, constraints);
+		for (auto constraint : constraints)
+			addConstraint(constraint, true);
 
 		// -10 allows RESET_PHYSICS down the calls. But equality with a float?...
 		system->readTransform(system->prepareForRead(RESET_PHYSICS));
@@ -114,18 +152,101 @@ namespace hdt
 				if (j->m_constraint)
 					removeConstraint(j->m_constraint);
 
-		for (int i = 0; i < system->m_meshes.size(); ++i)
+		for (int i = 0; i < system->m_meshes.size(); ++i) {
 			removeCollisionObject(system->m_meshes[i].get());
+			m_contactReport.removeBody(system->m_meshes[i].get());
+		}
 		for (int i = 0; i < system->m_constraints.size(); ++i)
 			if (system->m_constraints[i]->m_constraint)
 				removeConstraint(system->m_constraints[i]->m_constraint);
 		for (int i = 0; i < system->m_bones.size(); ++i)
 			removeRigidBody(&system->m_bones[i]->m_rig);
 
+		m_systemHandles.erase(system->m_handle);
+		system->m_handle = 0;
+
 		std::swap(*idx, m_systems.back());
 		m_systems.pop_back();
 
 		system->m_world = nullptr;
+
+		// Bullet removes a constraint by moving the last one into its slot.
+		restoreConstraintOrder();
+	}
+
+	// The constraints of a system in the order the solver should go through them: its solver order once built, else
+	// the order of declaration.
+	void SkinnedMeshWorld::collectConstraints(SkinnedMeshSystem* system, std::vector<btTypedConstraint*>& out)
+	{
+		if (!system->solverOrder().empty()) {
+			for (auto constraint : system->solverOrder())
+				if (constraint->m_constraint)
+					out.push_back(constraint->m_constraint);
+			return;
+		}
+
+		for (auto i : system->m_constraintGroups)
+			for (auto j : i->m_constraints)
+				if (j->m_constraint)
+					out.push_back(j->m_constraint);
+		for (int i = 0; i < system->m_constraints.size(); ++i)
+			if (system->m_constraints[i]->m_constraint)
+				out.push_back(system->m_constraints[i]->m_constraint);
+	}
+
+	void SkinnedMeshWorld::restoreConstraintOrder()
+	{
+		std::vector<btTypedConstraint*> ordered;
+		ordered.reserve(m_constraints.size());
+		for (auto& system : m_systems)
+			collectConstraints(system.get(), ordered);
+
+		// Only what is in the world, and what no system owns keeps its place, first.
+		std::unordered_set<btTypedConstraint*> present;
+		for (int i = 0; i < m_constraints.size(); ++i)
+			present.insert(m_constraints[i]);
+		std::unordered_set<btTypedConstraint*> owned(ordered.begin(), ordered.end());
+		btAlignedObjectArray<btTypedConstraint*> constraints;
+		constraints.reserve(m_constraints.size());
+		for (int i = 0; i < m_constraints.size(); ++i)
+			if (!owned.count(m_constraints[i]))
+				constraints.push_back(m_constraints[i]);
+		for (auto constraint : ordered)
+			if (present.erase(constraint))
+				constraints.push_back(constraint);
+
+		m_constraints.swap(constraints);
+	}
+
+	void SkinnedMeshWorld::addExternalBody(SkinnedMeshBody* body)
+	{
+		if (std::find(m_externalBodies.begin(), m_externalBodies.end(), body) != m_externalBodies.end()) {
+			return;
+		}
+
+		m_externalBodies.push_back(hdt::make_smart(body));
+		addCollisionObject(body, 1, 1);
+
+		for (auto& bone : body->m_skinnedBones) {
+			bone.ptr->m_rig.setActivationState(DISABLE_DEACTIVATION);
+			addRigidBody(&bone.ptr->m_rig, 0, 0);
+			bone.ptr->readTransform(RESET_PHYSICS);
+		}
+	}
+
+	void SkinnedMeshWorld::removeExternalBody(SkinnedMeshBody* body)
+	{
+		auto idx = std::find(m_externalBodies.begin(), m_externalBodies.end(), body);
+		if (idx == m_externalBodies.end())
+			return;
+
+		removeCollisionObject(body);
+		m_contactReport.removeBody(body);
+		for (auto& bone : body->m_skinnedBones)
+			removeRigidBody(&bone.ptr->m_rig);
+
+		std::swap(*idx, m_externalBodies.back());
+		m_externalBodies.pop_back();
 	}
 
 	void SkinnedMeshWorld::updateConstraintsForBone(SkinnedMeshBone* bone)
@@ -147,11 +268,61 @@ namespace hdt
 		}
 	}
 
+	SkinnedMeshSystem* SkinnedMeshWorld::findSystem(uint32_t handle) const
+	{
+		auto it = m_systemHandles.find(handle);
+		return it == m_systemHandles.end() ? nullptr : it->second;
+	}
+
+	void SkinnedMeshWorld::queueBoneForces(const BoneForce* forces, size_t count)
+	{
+		std::lock_guard<decltype(m_queuedForcesLock)> l(m_queuedForcesLock);
+		m_queuedForces.insert(m_queuedForces.end(), forces, forces + count);
+	}
+
+	// Handles are resolved here rather than when queued, so that forces for systems removed in between are dropped.
+	void SkinnedMeshWorld::applyQueuedForces()
+	{
+		{
+			std::lock_guard<decltype(m_queuedForcesLock)> l(m_queuedForcesLock);
+			if (m_queuedForces.empty())
+				return;
+			std::swap(m_stepForces, m_queuedForces);
+		}
+
+		for (auto& i : m_stepForces) {
+			auto system = findSystem(i.system);
+			if (!system || i.bone >= system->m_bones.size())
+				continue;
+
+			auto& rig = system->m_bones[i.bone]->m_rig;
+			if (rig.isStaticOrKinematicObject())
+				continue;
+
+			rig.applyCentralForce(i.force);
+			rig.applyTorque(i.torque);
+		}
+
+		m_stepForces.clear();
+	}
+
+	void SkinnedMeshWorld::setContactReporting(bool enabled)
+	{
+		if (m_reportContacts == enabled)
+			return;
+
+		m_reportContacts = enabled;
+		static_cast<CollisionDispatcher*>(m_dispatcher1)->m_recordContactSources = enabled;
+		m_contactReport.clear();
+	}
+
 	int SkinnedMeshWorld::stepSimulation(btScalar remainingTimeStep, int, btScalar fixedTimeStep)
 	{
 		applyGravity();
+		m_applyAerodynamics = hdt::SkyrimPhysicsWorld::get()->m_aerodynamics;
 		if (hdt::SkyrimPhysicsWorld::get()->m_enableWind)
 			applyWind(remainingTimeStep);
+		applyQueuedForces();
 
 		while (remainingTimeStep > fixedTimeStep) {
 			internalSingleStepSimulation(fixedTimeStep);
@@ -169,6 +340,9 @@ namespace hdt
 			internalSingleStepSimulation(remainingTimeStep);
 		clearForces();
 
+		if (m_reportContacts)
+			m_contactReport.endFrame();
+
 		_bodies.clear();
 		_shapes.clear();
 
@@ -179,7 +353,7 @@ namespace hdt
 	// This optimizes Bullet's broadphase by removing tons of redudent work. We don't use persistent manifolds,
 	// we don't have static objects, etc..
 	// HOWEVER: If we ever add non-skinned Bullet collision objects, or make (0,0) bodies participate in
-	// broadphase queries/collision, this optimization must be revisited.
+	// broadphase queries/collision, this optimization must be revisited. External bodies are skinned too.
 	void SkinnedMeshWorld::performDiscreteCollisionDetection()
 	{
 		BT_PROFILE("performDiscreteCollisionDetection");
@@ -188,6 +362,12 @@ namespace hdt
 			system->internalUpdate();
 		}
 
+		for (auto& body : m_externalBodies) {
+			for (auto& bone : body->m_skinnedBones)
+				bone.ptr->internalUpdate();
+			body->updateBoundingSphereAabb();
+		}
+
 		btDispatcherInfo& dispatchInfo = getDispatchInfo();
 
 		for (int i = 0; i < m_collisionObjects.size(); i++) {
@@ -208,6 +388,125 @@ namespace hdt
 		if (m_dispatcher1) {
 			m_dispatcher1->dispatchAllCollisionPairs(m_broadphasePairCache->getOverlappingPairCache(), dispatchInfo, m_dispatcher1);
 		}
+
+		if (std::any_of(m_systems.begin(), m_systems.end(), [](auto& system) { return system->m_recoverySteps > 0; }))
+			recoverFromResets();
+	}
+
+	// After a reset, the dynamic bones are at their animated pose, which often goes through the body; solving these
+	// contacts at once would throw them away. Instead, for the first substeps, they are projected out of the animated
+	// colliders along the normals of the narrowphase, a few relaxation passes per substep, and the velocities of the
+	// bones that were moved are zeroed. The solver only sees what's left of the penetration.
+	void SkinnedMeshWorld::recoverFromResets()
+	{
+		BT_PROFILE("recoverFromResets");
+
+		std::unordered_map<btRigidBody*, size_t> recovering;
+		for (auto& system : m_systems) {
+			if (system->m_recoverySteps <= 0)
+				continue;
+			--system->m_recoverySteps;
+			for (auto& bone : system->m_bones)
+				if (!bone->m_rig.isStaticOrKinematicObject())
+					recovering.emplace(&bone->m_rig, recovering.size());
+		}
+
+		struct Contact
+		{
+			btManifoldPoint* point;
+			btRigidBody* bone;
+			btRigidBody* other;
+			bool onA;
+		};
+
+		std::vector<Contact> contacts;
+		auto dispatcher = static_cast<CollisionDispatcher*>(m_dispatcher1);
+		auto manifolds = dispatcher->getInternalManifoldPointer();
+		for (int i = 0; i < dispatcher->getNumManifolds(); ++i) {
+			auto manifold = manifolds[i];
+			auto a = const_cast<btRigidBody*>(btRigidBody::upcast(manifold->getBody0()));
+			auto b = const_cast<btRigidBody*>(btRigidBody::upcast(manifold->getBody1()));
+			if (!a || !b)
+				continue;
+
+			// Only against the animated colliders, the dynamic ones are moving out of the way too.
+			const bool recoverA = recovering.count(a) && b->isStaticOrKinematicObject();
+			const bool recoverB = recovering.count(b) && a->isStaticOrKinematicObject();
+			if (!recoverA && !recoverB)
+				continue;
+
+			for (int j = 0; j < manifold->getNumContacts(); ++j)
+				contacts.push_back({ &manifold->getContactPoint(j), recoverA ? a : b, recoverA ? b : a, recoverA });
+		}
+
+		if (contacts.empty())
+			return;
+
+		// The depth of a contact, measured again from the contact points attached to the bodies.
+		auto measure = [](Contact& contact) {
+			auto& point = *contact.point;
+			auto& rigA = contact.onA ? *contact.bone : *contact.other;
+			auto& rigB = contact.onA ? *contact.other : *contact.bone;
+			const btVector3 onA = rigA.getWorldTransform() * point.m_localPointA;
+			const btVector3 onB = rigB.getWorldTransform() * point.m_localPointB;
+			point.m_distance1 = (onA - onB).dot(point.m_normalWorldOnB);
+			return point.m_distance1;
+		};
+
+		// Jacobi iterations: each bone moves by the average of what its contacts ask, then the depths are measured
+		// again.
+		constexpr int kIterations = 4;
+		btAlignedObjectArray<btVector3> moves;
+		std::vector<int> counts;
+		std::vector<uint8_t> moved(recovering.size(), 0);
+		moves.resize(static_cast<int>(recovering.size()));
+		counts.resize(recovering.size());
+		for (int iteration = 0; iteration < kIterations; ++iteration) {
+			for (int i = 0; i < moves.size(); ++i)
+				moves[i].setZero();
+			std::fill(counts.begin(), counts.end(), 0);
+
+			bool penetrating = false;
+			for (auto& contact : contacts) {
+				const btScalar depth = measure(contact);
+				if (depth >= 0)
+					continue;
+
+				// the normal points from B to A
+				penetrating = true;
+				const size_t index = recovering[contact.bone];
+				moves[static_cast<int>(index)] += contact.point->m_normalWorldOnB * (contact.onA ? -depth : depth);
+				++counts[index];
+			}
+			if (!penetrating)
+				break;
+
+			for (auto& [rig, index] : recovering) {
+				if (!counts[index])
+					continue;
+				const btVector3 move = moves[static_cast<int>(index)] / static_cast<btScalar>(counts[index]);
+				rig->getWorldTransform().setOrigin(rig->getWorldTransform().getOrigin() + move);
+				btTransform interpolation = rig->getInterpolationWorldTransform();
+				interpolation.setOrigin(interpolation.getOrigin() + move);
+				rig->setInterpolationWorldTransform(interpolation);
+				moved[index] = 1;
+			}
+		}
+
+		// The solver gets the depths left after the last move.
+		for (auto& contact : contacts)
+			measure(contact);
+
+		// Only the bones pushed out lose their motion: the free ones keep theirs, and their gravity.
+		static const btVector3 zero(0, 0, 0);
+		for (auto& [rig, index] : recovering) {
+			if (!moved[index])
+				continue;
+			rig->setLinearVelocity(zero);
+			rig->setAngularVelocity(zero);
+			rig->setInterpolationLinearVelocity(zero);
+			rig->setInterpolationAngularVelocity(zero);
+		}
 	}
 
 	void SkinnedMeshWorld::applyGravity()
@@ -224,38 +523,48 @@ namespace hdt
 		btDiscreteDynamicsWorldMt::applyGravity();
 	}
 
-	void SkinnedMeshWorld::applyWind(btScalar timeStep)
+	SkinnedMeshWorld::Gust SkinnedMeshWorld::gustAt(const btVector3& origin, const btVector3& windDirection, const btVector3& side, btScalar windMagnitude) const
 	{
-		constexpr btScalar kMaxFrameStep = 0.1f;
-		constexpr btScalar kTimeWrap = 4096.0f;
-		constexpr btScalar kResponseToBodyVelocity = 0.08f;
 		constexpr btScalar kGustSpeedPerForce = 7.0f;
 		constexpr btScalar kMinGustSpeed = 180.0f;
 		constexpr btScalar kMaxGustSpeed = 1200.0f;
 		constexpr btScalar kCrosswindTimeScale = 0.004f;
 		constexpr btScalar kVerticalPhaseScale = 0.006f;
+
+		const btScalar gustSpeed = clampScalar(windMagnitude * kGustSpeedPerForce, kMinGustSpeed, kMaxGustSpeed);
+
+		Gust ret;
+		// Move gust phases downwind so stronger wind carries the same gust across bones faster
+		ret.advectedTime = m_windTime - origin.dot(windDirection) / gustSpeed - origin.dot(side) * kCrosswindTimeScale;
+		ret.verticalPhase = origin.getZ() * kVerticalPhaseScale;
+
+		const btScalar longGust = std::sin(ret.advectedTime * 0.55f + ret.verticalPhase * 0.35f);
+		ret.midGust = std::sin(ret.advectedTime * 1.35f + ret.verticalPhase + longGust * 0.5f);
+		ret.flutter = std::sin(ret.advectedTime * 4.15f + ret.verticalPhase * 2.2f + ret.midGust);
+		const btScalar gustPulse = 0.5f + 0.5f * std::sin(ret.advectedTime * 0.85f + ret.verticalPhase * 0.6f);
+		ret.burst = gustPulse * gustPulse;
+		ret.scale = clampScalar(0.68f + longGust * 0.18f + ret.midGust * 0.12f + ret.flutter * 0.06f + ret.burst * 0.45f, 0.35f, 1.55f);
+		return ret;
+	}
+
+	void SkinnedMeshWorld::applyWind(btScalar timeStep)
+	{
+		constexpr btScalar kMaxFrameStep = 0.1f;
+		constexpr btScalar kTimeWrap = 4096.0f;
+		constexpr btScalar kResponseToBodyVelocity = 0.08f;
 		constexpr btScalar kPressureCenterOffset = 0.8f;
 
 		BT_PROFILE("HDTSMP_applyWind");
 
-		const btScalar windMagnitude = m_windSpeed.length();
-		if (btFuzzyZero(windMagnitude))
+		if (btFuzzyZero(m_windSpeed.length()) && !m_windField.isActive())
 			return;
 
 		m_windTime += clampScalar(timeStep, 0.0f, kMaxFrameStep);
 		if (m_windTime > kTimeWrap)
 			m_windTime -= kTimeWrap;
 
-		const btVector3 windDirection = m_windSpeed / windMagnitude;
 		const btVector3 up(0.0f, 0.0f, 1.0f);
-		btVector3 side = windDirection.cross(up);
-		if (btFuzzyZero(side.length2())) {
-			side = btVector3(1.0f, 0.0f, 0.0f);
-		} else {
-			side.normalize();
-		}
-
-		const btScalar gustSpeed = clampScalar(windMagnitude * kGustSpeedPerForce, kMinGustSpeed, kMaxGustSpeed);
+		const bool aerodynamics = hdt::SkyrimPhysicsWorld::get()->m_aerodynamics;
 
 		for (auto& i : m_systems) {
 			auto system = static_cast<SkyrimSystem*>(i.get());
@@ -265,30 +574,43 @@ namespace hdt
 				auto body = &j->m_rig;
 				if (body->isStaticOrKinematicObject() || btFuzzyZero(j->m_windFactor))
 					continue;
+				// the wind reaches these through the surface they drive, see applyAerodynamics
+				if (aerodynamics && j->m_drivesSurface)
+					continue;
 
-				const btScalar windFactor = j->m_windFactor * system->m_windFactor;
 				const btVector3 origin = body->getWorldTransform().getOrigin();
-				// Move gust phases downwind so stronger wind carries the same gust across bones faster
-				const btScalar advectedTime = m_windTime - origin.dot(windDirection) / gustSpeed - origin.dot(side) * kCrosswindTimeScale;
-				const btScalar verticalPhase = origin.getZ() * kVerticalPhaseScale;
-
-				const btScalar longGust = std::sin(advectedTime * 0.55f + verticalPhase * 0.35f);
-				const btScalar midGust = std::sin(advectedTime * 1.35f + verticalPhase + longGust * 0.5f);
-				const btScalar flutter = std::sin(advectedTime * 4.15f + verticalPhase * 2.2f + midGust);
-				const btScalar gustPulse = 0.5f + 0.5f * std::sin(advectedTime * 0.85f + verticalPhase * 0.6f);
-				const btScalar gustBurst = gustPulse * gustPulse;
-				const btScalar gustScale = clampScalar(0.68f + longGust * 0.18f + midGust * 0.12f + flutter * 0.06f + gustBurst * 0.45f, 0.35f, 1.55f);
-
-				const btScalar relativeScale = clampScalar((m_windSpeed - body->getLinearVelocity() * kResponseToBodyVelocity).dot(windDirection) / windMagnitude,
+
+				// The weather wind, plus whatever the local emitters blow at this place.
+				const btVector3 windSpeed = m_windField.sample(origin, m_windSpeed);
+				const btScalar windMagnitude = windSpeed.length();
+				if (btFuzzyZero(windMagnitude))
+					continue;
+
+				const btVector3 windDirection = windSpeed / windMagnitude;
+				btVector3 side = windDirection.cross(up);
+				if (btFuzzyZero(side.length2())) {
+					side = btVector3(1.0f, 0.0f, 0.0f);
+				} else {
+					side.normalize();
+				}
+
+				const btScalar windFactor = j->m_windFactor * system->m_windFactor;
+				const Gust gust = gustAt(origin, windDirection, side, windMagnitude);
+				const btScalar midGust = gust.midGust;
+				const btScalar flutter = gust.flutter;
+				const btScalar gustBurst = gust.burst;
+				const btScalar gustScale = gust.scale;
+
+				const btScalar relativeScale = clampScalar((windSpeed - body->getLinearVelocity() * kResponseToBodyVelocity).dot(windDirection) / windMagnitude,
 					0.0f,
 					1.4f);
 
 				const btScalar baseMagnitude = windMagnitude * windFactor;
 				const btScalar sidewaysFlutter = (midGust * 0.13f + flutter * 0.06f + gustBurst * 0.04f) * baseMagnitude;
-				const btScalar verticalFlutter = (std::sin(advectedTime * 1.9f + verticalPhase * 1.4f) * 0.018f + flutter * 0.01f) * baseMagnitude;
+				const btScalar verticalFlutter = (std::sin(gust.advectedTime * 1.9f + gust.verticalPhase * 1.4f) * 0.018f + flutter * 0.01f) * baseMagnitude;
 
 				const btVector3 windForce =
-					m_windSpeed * windFactor * gustScale * relativeScale +
+					windSpeed * windFactor * gustScale * relativeScale +
 					side * sidewaysFlutter +
 					up * verticalFlutter;
 
@@ -298,8 +620,164 @@ namespace hdt
 		}
 	}
 
+	// Drag and lift of each triangle of the dynamic per-triangle shapes, from the air velocity relative to the
+	// triangle, its skinned normal and its area, distributed to the bones by the skin weights. The forces are
+	// applied as impulses right before the solver, so that they follow the surface at every substep.
+	// The wind factors and the gusts only scale the moving air: a surface muted from the wind still has its drag.
+	void SkinnedMeshWorld::applyAerodynamics(btScalar timeStep)
+	{
+		BT_PROFILE("HDTSMP_applyAerodynamics");
+
+		auto world = hdt::SkyrimPhysicsWorld::get();
+		// 1/2 rho, in the units of the simulation (Skyrim units, seconds, masses as given)
+		constexpr btScalar kHalfAirDensity = 0.5f * 1.2f * scaleRealWorld * scaleRealWorld * scaleRealWorld;
+		const btScalar drag = kHalfAirDensity * world->m_dragCoefficient * timeStep;
+		const btScalar lift = kHalfAirDensity * world->m_liftCoefficient * timeStep;
+		const btVector3 up(0.0f, 0.0f, 1.0f);
+
+		// The wind is kept as the acceleration applyWind gives, windStrength (times scaleSkyrim) at the strongest
+		// weather wind, when the air moves at windAirSpeed m/s: same ratio for the emitters, in Skyrim units.
+		const bool windy = world->m_enableWind && world->m_windStrength > FLT_EPSILON && (!btFuzzyZero(m_windSpeed.length()) || m_windField.isActive());
+		const btScalar airSpeedPerWind = windy ? world->m_windAirSpeed / world->m_windStrength : 0.0f;
+
+		// The systems don't share bones, they can be done in parallel.
+		tbb::parallel_for(size_t{ 0 }, m_systems.size(), [&, this](size_t s) {
+			auto system = static_cast<SkyrimSystem*>(m_systems[s].get());
+			const btScalar systemWind = airSpeedPerWind * system->m_windFactor;
+
+			std::vector<btScalar> gusts;
+			std::vector<btVector3> velocities;
+			std::vector<btScalar> winds;
+			for (auto& body : system->m_meshes) {
+				auto shape = body->m_shape->asPerTriangleShape();
+				if (!shape || body->m_isKinematic)
+					continue;
+
+				// The vertices are only skinned for collisions when the body overlaps another one.
+				body->internalUpdate();
+
+				// One gust per bone, it varies slowly across the surface; with its wind factor.
+				const size_t numBones = body->m_skinnedBones.size();
+				gusts.assign(numBones, 0.0f);
+				if (!btFuzzyZero(systemWind)) {
+					for (size_t i = 0; i < numBones; ++i) {
+						const auto bone = body->m_skinnedBones[i].ptr;
+						const btVector3 origin = bone->m_rig.getWorldTransform().getOrigin();
+						const btVector3 windSpeed = m_windField.sample(origin, m_windSpeed);
+						const btScalar windMagnitude = windSpeed.length();
+						if (btFuzzyZero(windMagnitude)) {
+							gusts[i] = bone->m_windFactor;
+							continue;
+						}
+
+						const btVector3 windDirection = windSpeed / windMagnitude;
+						btVector3 side = windDirection.cross(up);
+						side = btFuzzyZero(side.length2()) ? btVector3(1.0f, 0.0f, 0.0f) : side.normalized();
+						gusts[i] = gustAt(origin, windDirection, side, windMagnitude).scale * bone->m_windFactor;
+					}
+				}
+
+				// Velocity of each skinned vertex from the velocities of its bones, and its share of the wind.
+				const size_t numVertices = body->m_vertices.size();
+				velocities.resize(numVertices);
+				winds.resize(numVertices);
+				for (size_t v = 0; v < numVertices; ++v) {
+					const auto& vertex = body->m_vertices[v];
+					const btVector3 p = body->m_vpos[v].pos();
+					btVector3 velocity(0, 0, 0);
+					btScalar wind = 0;
+					for (int k = 0; k < 4; ++k) {
+						const btScalar w = vertex.m_weight[k];
+						if (w <= FLT_EPSILON)
+							continue;
+						const auto& rig = body->m_skinnedBones[vertex.getBoneIdx(k)].ptr->m_rig;
+						velocity += (rig.getLinearVelocity() + rig.getAngularVelocity().cross(p - rig.getWorldTransform().getOrigin())) * w;
+						wind += gusts[vertex.getBoneIdx(k)] * w;
+					}
+					velocities[v] = velocity;
+					winds[v] = wind;
+				}
+
+				for (auto& triangle : shape->m_colliders) {
+					const btVector3 p0 = body->m_vpos[triangle.vertices[0]].pos();
+					const btVector3 p1 = body->m_vpos[triangle.vertices[1]].pos();
+					const btVector3 p2 = body->m_vpos[triangle.vertices[2]].pos();
+					const btVector3 cross = (p1 - p0).cross(p2 - p0);
+					const btScalar doubleArea = cross.length();
+					if (doubleArea < FLT_EPSILON)
+						continue;
+
+					const btVector3 normal = cross / doubleArea;
+					const btVector3 center = (p0 + p1 + p2) / 3.0f;
+					const btScalar wind = (winds[triangle.vertices[0]] + winds[triangle.vertices[1]] + winds[triangle.vertices[2]]) * (systemWind / 3.0f);
+					const btVector3 air = btFuzzyZero(wind) ? btVector3(0, 0, 0) : m_windField.sample(center, m_windSpeed) * wind;
+					const btVector3 relative = (velocities[triangle.vertices[0]] + velocities[triangle.vertices[1]] + velocities[triangle.vertices[2]]) / 3.0f - air;
+
+					const btScalar speed2 = relative.length2();
+					if (speed2 < FLT_EPSILON)
+						continue;
+
+					// Drag opposes the relative motion in proportion to the area facing it; lift is perpendicular to
+					// it, strongest at 45 degrees and null when the triangle faces the flow or is edge-on.
+					const btScalar speed = btSqrt(speed2);
+					const btVector3 direction = relative / speed;
+					const btScalar cosine = normal.dot(direction);
+					const btScalar pressure = speed2 * doubleArea * 0.5f;
+					const btVector3 impulse = direction * (-drag * pressure * btFabs(cosine)) - (normal - direction * cosine) * (lift * pressure * cosine);
+
+					// A third at each corner, shared by its bones.
+					for (int c = 0; c < 3; ++c) {
+						const auto& vertex = body->m_vertices[triangle.vertices[c]];
+						const btVector3 p = body->m_vpos[triangle.vertices[c]].pos();
+						for (int k = 0; k < 4; ++k) {
+							const btScalar w = vertex.m_weight[k];
+							if (w <= FLT_EPSILON)
+								continue;
+							auto& rig = body->m_skinnedBones[vertex.getBoneIdx(k)].ptr->m_rig;
+							if (rig.isStaticOrKinematicObject())
+								continue;
+							rig.applyImpulse(impulse * (w / 3.0f), p - rig.getWorldTransform().getOrigin());
+						}
+					}
+				}
+			}
+		});
+	}
+
+	// Sets the velocities of the kinematic bones so that this substep brings them to the next point of their track.
+	// The world transforms are offset while stepping, the tracks aren't.
+	void SkinnedMeshWorld::followKinematicTracks(btScalar timeStep)
+	{
+		auto follow = [this, timeStep](SkinnedMeshBone* bone) {
+			auto& rig = bone->m_rig;
+			if (!rig.isKinematicObject() || !bone->m_kinematicTrack.active())
+				return;
+
+			btTransform target = bone->m_kinematicTrack.advance(timeStep);
+			target.getOrigin() -= m_simulationOffset;
+
+			btVector3 linVel, angVel;
+			btTransformUtil::calculateVelocity(rig.getWorldTransform(), target, timeStep, linVel, angVel);
+			rig.setLinearVelocity(linVel);
+			rig.setAngularVelocity(angVel);
+			rig.setInterpolationLinearVelocity(linVel);
+			rig.setInterpolationAngularVelocity(angVel);
+		};
+
+		for (auto& system : m_systems)
+			for (auto& bone : system->m_bones)
+				follow(bone.get());
+
+		for (auto& body : m_externalBodies)
+			for (auto& bone : body->m_skinnedBones)
+				follow(bone.ptr);
+	}
+
 	void SkinnedMeshWorld::predictUnconstraintMotion(btScalar timeStep)
 	{
+		if (hdt::SkyrimPhysicsWorld::get()->m_smoothKinematics)
+			followKinematicTracks(timeStep);
+
 		struct UpdaterPredictUnconstraintMotion : public btIParallelForBody
 		{
 			btScalar timeStep;
@@ -310,9 +788,12 @@ namespace hdt
 				for (int i = iBegin; i < iEnd; ++i) {
 					btRigidBody* body = rigidBodies[i];
 
-					// not realistic, just an approximate
-					if (!body->isStaticOrKinematicObject())
-						body->applyDamping(timeStep);
+					if (!body->isStaticOrKinematicObject()) {
+						if (auto bone = static_cast<SkinnedMeshBone*>(body->getUserPointer()))
+							bone->applyDamping(timeStep);
+						else
+							body->applyDamping(timeStep);
+					}
 
 					body->predictIntegratedTransform(timeStep, body->getInterpolationWorldTransform());
 				}
@@ -360,6 +841,21 @@ namespace hdt
 		}
 
 		btDiscreteDynamicsWorldMt::integrateTransforms(timeStep);
+
+		{
+			BT_PROFILE("solveShapeMatching");
+			for (auto& system : m_systems)
+				for (auto& group : system->m_constraintGroups)
+					for (auto& shapeMatching : group->m_shapeMatchings)
+						shapeMatching->solve(timeStep);
+		}
+
+		if (hdt::SkyrimPhysicsWorld::get()->m_enableTethers) {
+			BT_PROFILE("solveTethers");
+			const btScalar slack = hdt::SkyrimPhysicsWorld::get()->m_tetherSlack;
+			for (auto& system : m_systems)
+				system->solveTethers(slack);
+		}
 	}
 
 	void SkinnedMeshWorld::calculateSimulationIslands()
@@ -435,9 +931,36 @@ namespace hdt
 			}
 		}
 
+		if (m_applyAerodynamics)
+			applyAerodynamics(solverInfo.m_timeStep);
+
 		btDiscreteDynamicsWorldMt::solveConstraints(solverInfo);
 
+		if (m_reportContacts)
+			gatherContacts();
+
 		// the HDT manifolds are still recreated every frame, clear to prevent stale data.
 		static_cast<CollisionDispatcher*>(m_dispatcher1)->clearAllManifold();
 	}
+
+	// The solver has written the applied impulses back into the manifold points, read them before they are destroyed.
+	void SkinnedMeshWorld::gatherContacts()
+	{
+		BT_PROFILE("gatherContacts");
+
+		auto dispatcher = static_cast<CollisionDispatcher*>(m_dispatcher1);
+		for (auto& source : dispatcher->m_contactSources) {
+			auto manifold = source.manifold;
+			auto boneA = static_cast<SkinnedMeshBone*>(manifold->getBody0()->getUserPointer());
+			auto boneB = static_cast<SkinnedMeshBone*>(manifold->getBody1()->getUserPointer());
+
+			for (int i = 0; i < manifold->getNumContacts(); ++i) {
+				auto& point = manifold->getContactPoint(i);
+				m_contactReport.addContact(source.body0, source.body1, boneA, boneB,
+					point.getPositionWorldOnB() + m_simulationOffset,
+					point.m_normalWorldOnB,
+					point.getAppliedImpulse());
+			}
+		}
+	}
 }
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "hdtContactReport.h"
 #include "hdtSkinnedMeshSystem.h"
 #include "hdtSkyrimSystem.h"
+#include "hdtWindField.h"
 #include <BulletCollision/CollisionDispatch/btSimulationIslandManager.h>
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
 
@@ -16,7 +18,28 @@ namespace hdt
 		virtual void addSkinnedMeshSystem(SkinnedMeshSystem* system);
 		virtual void removeSkinnedMeshSystem(SkinnedMeshSystem* system);
 
+		// Kinematic bodies that don't belong to any system; their bones are read every step but never written.
+		virtual void addExternalBody(SkinnedMeshBody* body);
+		virtual void removeExternalBody(SkinnedMeshBody* body);
+
 		void updateConstraintsForBone(SkinnedMeshBone* bone);
+		// Puts the constraints of every system back in its solver order (SkinnedMeshSystem::buildSolverOrder), which is
+		// the order the islands hand them to the solver in. Called after a removal, or after a system rebuilt its order.
+		void restoreConstraintOrder();
+
+		const std::vector<RE::BSTSmartPointer<SkinnedMeshSystem>>& getSystems() const { return m_systems; }
+		SkinnedMeshSystem* findSystem(uint32_t handle) const;
+
+		struct BoneForce
+		{
+			uint32_t system;
+			uint32_t bone;
+			btVector3 force;
+			btVector3 torque;
+		};
+
+		// Can be called from any thread; the forces are applied to the dynamic bones during the next step.
+		void queueBoneForces(const BoneForce* forces, size_t count);
 
 		int stepSimulation(btScalar remainingTimeStep, int maxSubSteps = 1,
 			btScalar fixedTimeStep = btScalar(1.) / btScalar(60.)) override;
@@ -24,11 +47,21 @@ namespace hdt
 		btVector3& getWind() { return m_windSpeed; }
 		const btVector3& getWind() const { return m_windSpeed; }
 
+		WindField& getWindField() { return m_windField; }
+
+		// Contacts are only gathered while reporting is enabled, as it costs a pass over the manifolds each substep.
+		void setContactReporting(bool enabled);
+		const std::vector<ContactRecord>& getContactRecords() const { return m_contactReport.records(); }
+
 	protected:
 		std::vector<float> m_timeSteps;
 
 		void readTransform(float timeStep)
 		{
+			for (auto& body : m_externalBodies)
+				for (auto& bone : body->m_skinnedBones)
+					bone.ptr->readTransform(timeStep);
+
 			const size_t n = m_systems.size();
 			if (n == 0)
 				return;
@@ -50,18 +83,49 @@ namespace hdt
 		}
 
 		void applyGravity() override;
+
+		struct Gust
+		{
+			btScalar advectedTime;
+			btScalar verticalPhase;
+			btScalar midGust;
+			btScalar flutter;
+			btScalar burst;
+			btScalar scale;
+		};
+
+		Gust gustAt(const btVector3& origin, const btVector3& windDirection, const btVector3& side, btScalar windMagnitude) const;
 		void applyWind(btScalar timeStep);
+		void applyAerodynamics(btScalar timeStep);
+		void applyQueuedForces();
 
+		void followKinematicTracks(btScalar timeStep);
 		void predictUnconstraintMotion(btScalar timeStep) override;
 		void integrateTransforms(btScalar timeStep) override;
 		void performDiscreteCollisionDetection() override;
+		void recoverFromResets();
+		static void collectConstraints(SkinnedMeshSystem* system, std::vector<btTypedConstraint*>& out);
 		void calculateSimulationIslands() override;
 		void solveConstraints(btContactSolverInfo& solverInfo) override;
+		void gatherContacts();
 
 		std::vector<RE::BSTSmartPointer<SkinnedMeshSystem>> m_systems;
+		std::vector<RE::BSTSmartPointer<SkinnedMeshBody>> m_externalBodies;
+		std::unordered_map<uint32_t, SkinnedMeshSystem*> m_systemHandles;
+		uint32_t m_nextSystemHandle = 1;
+
+		SpinLock m_queuedForcesLock;
+		std::vector<BoneForce> m_queuedForces;
+		std::vector<BoneForce> m_stepForces;
 
 		btVector3 m_windSpeed;       // world windspeed
 		btScalar m_windTime = 0.0f;  // wind simulation clock
+		WindField m_windField;       // local emitters added on top of m_windSpeed
+		bool m_applyAerodynamics = false;
+
+		btVector3 m_simulationOffset = btVector3(0, 0, 0);  // translation removed from the bodies while stepping
+		ContactReport m_contactReport;
+		bool m_reportContacts = false;
 
 	private:
 		std::vector<SkinnedMeshBody*> _bodies;
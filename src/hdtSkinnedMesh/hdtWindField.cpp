@@ -0,0 +1,188 @@
+#include "hdtWindField.h"
+
+#include <LinearMath/btQuickprof.h>
+#include <cmath>
+
+namespace hdt
+{
+	uint32_t WindField::addEmitter(const WindEmitter& emitter)
+	{
+		std::lock_guard<decltype(m_emittersLock)> l(m_emittersLock);
+		const uint32_t id = m_nextId++;
+		m_emitters.push_back({ id, emitter });
+		return id;
+	}
+
+	bool WindField::removeEmitter(uint32_t id)
+	{
+		std::lock_guard<decltype(m_emittersLock)> l(m_emittersLock);
+		auto it = std::find_if(m_emitters.begin(), m_emitters.end(), [id](const Entry& e) { return e.id == id; });
+		if (it == m_emitters.end())
+			return false;
+		m_emitters.erase(it);
+		return true;
+	}
+
+	bool WindField::updateEmitter(uint32_t id, const WindEmitter& emitter)
+	{
+		std::lock_guard<decltype(m_emittersLock)> l(m_emittersLock);
+		auto it = std::find_if(m_emitters.begin(), m_emitters.end(), [id](const Entry& e) { return e.id == id; });
+		if (it == m_emitters.end())
+			return false;
+		it->emitter = emitter;
+		return true;
+	}
+
+	void WindField::clearEmitters()
+	{
+		std::lock_guard<decltype(m_emittersLock)> l(m_emittersLock);
+		m_emitters.clear();
+	}
+
+	size_t WindField::emitterCount()
+	{
+		std::lock_guard<decltype(m_emittersLock)> l(m_emittersLock);
+		return m_emitters.size();
+	}
+
+	void WindField::setResolution(int horizontalCells, btScalar cellSize)
+	{
+		m_cellsXY = btClamped(horizontalCells, 2, 64);
+		m_cellsZ = std::max(2, m_cellsXY / 2);
+		m_cellSize = btMax(cellSize, btScalar(16.0f));
+		m_cells.clear();
+		m_active = false;
+	}
+
+	void WindField::update(const btVector3& a_center, btScalar a_timeStep)
+	{
+		constexpr btScalar kTimeWrap = 4096.0f;
+
+		m_time += btMax(a_timeStep, btScalar(0.0f));
+		if (m_time > kTimeWrap)
+			m_time -= kTimeWrap;
+
+		{
+			std::lock_guard<decltype(m_emittersLock)> l(m_emittersLock);
+			for (auto it = m_emitters.begin(); it != m_emitters.end();) {
+				auto& lifetime = it->emitter.m_lifetime;
+				if (lifetime >= 0.0f) {
+					lifetime -= a_timeStep;
+					if (lifetime <= 0.0f) {
+						it = m_emitters.erase(it);
+						continue;
+					}
+				}
+				++it;
+			}
+			m_frameEmitters = m_emitters;
+		}
+
+		m_active = !m_frameEmitters.empty();
+		if (!m_active)
+			return;
+
+		BT_PROFILE("HDTSMP_updateWindField");
+
+		// Snap the grid to whole cells so that it doesn't swim with the camera.
+		const btVector3 halfExtent(m_cellsXY * 0.5f, m_cellsXY * 0.5f, m_cellsZ * 0.5f);
+		const btVector3 snapped(
+			std::floor(a_center.x() / m_cellSize),
+			std::floor(a_center.y() / m_cellSize),
+			std::floor(a_center.z() / m_cellSize));
+		m_origin = (snapped - halfExtent) * m_cellSize;
+
+		m_cells.resize(m_cellsXY * m_cellsXY * m_cellsZ);
+		for (int z = 0; z < m_cellsZ; ++z)
+			for (int y = 0; y < m_cellsXY; ++y)
+				for (int x = 0; x < m_cellsXY; ++x)
+					m_cells[cellIndex(x, y, z)] = evaluate(m_origin + btVector3(btScalar(x), btScalar(y), btScalar(z)) * m_cellSize);
+	}
+
+	btVector3 WindField::evaluate(const btVector3& a_position) const
+	{
+		btVector3 wind(0, 0, 0);
+		for (auto& entry : m_frameEmitters) {
+			auto& e = entry.emitter;
+			if (btFuzzyZero(e.m_strength) || e.m_radius <= 0.0f)
+				continue;
+
+			const btVector3 toPoint = a_position - e.m_position;
+			const btScalar distance = toPoint.length();
+			if (distance >= e.m_radius)
+				continue;
+
+			btScalar scale = std::pow(1.0f - distance / e.m_radius, e.m_falloff);
+			btVector3 direction;
+
+			if (e.m_shape == WindEmitter::Shape::Cone) {
+				if (btFuzzyZero(e.m_direction.length2()))
+					continue;
+				const btVector3 axis = e.m_direction.normalized();
+				if (distance > SIMD_EPSILON) {
+					const btScalar cosAngle = toPoint.dot(axis) / distance;
+					const btScalar cosLimit = std::cos(e.m_coneAngle);
+					if (cosAngle <= cosLimit)
+						continue;
+					// Fade out towards the side of the cone.
+					scale *= (cosAngle - cosLimit) / (1.0f - cosLimit + SIMD_EPSILON);
+					direction = toPoint / distance;
+				} else {
+					direction = axis;
+				}
+			} else if (!btFuzzyZero(e.m_direction.length2())) {
+				direction = e.m_direction.normalized();
+			} else if (distance > SIMD_EPSILON) {
+				direction = toPoint / distance;
+			} else {
+				continue;
+			}
+
+			btVector3 emitted = direction * (e.m_strength * scale);
+
+			if (e.m_turbulence > 0.0f) {
+				// Cheap incoherent noise, large enough features to span several cells.
+				const btVector3 p = a_position * 0.004f;
+				const btScalar seed = static_cast<btScalar>(entry.id);
+				const btVector3 noise(
+					std::sin(p.y() * 1.7f + m_time * 2.3f + seed) * std::cos(p.z() * 1.3f - m_time * 1.1f),
+					std::sin(p.z() * 1.9f + m_time * 1.7f + seed * 0.7f) * std::cos(p.x() * 1.1f + m_time * 2.9f),
+					std::sin(p.x() * 1.3f - m_time * 2.1f + seed * 1.3f) * std::cos(p.y() * 1.5f + m_time * 1.3f) * 0.5f);
+				emitted += noise * (btClamped(e.m_turbulence, 0.0f, 1.0f) * e.m_strength * scale);
+			}
+
+			wind += emitted;
+		}
+		return wind;
+	}
+
+	btVector3 WindField::sample(const btVector3& a_position, const btVector3& a_baseWind) const
+	{
+		if (!m_active || m_cells.size() == 0)
+			return a_baseWind;
+
+		const btVector3 local = (a_position + m_queryOffset - m_origin) / m_cellSize;
+
+		const btScalar fx = btClamped(local.x(), btScalar(0.0f), btScalar(m_cellsXY - 1));
+		const btScalar fy = btClamped(local.y(), btScalar(0.0f), btScalar(m_cellsXY - 1));
+		const btScalar fz = btClamped(local.z(), btScalar(0.0f), btScalar(m_cellsZ - 1));
+
+		// Outside of the grid there are no local emitters.
+		if (fx != local.x() || fy != local.y() || fz != local.z())
+			return a_baseWind;
+
+		const int x0 = std::min(int(fx), m_cellsXY - 2);
+		const int y0 = std::min(int(fy), m_cellsXY - 2);
+		const int z0 = std::min(int(fz), m_cellsZ - 2);
+		const btScalar tx = fx - x0;
+		const btScalar ty = fy - y0;
+		const btScalar tz = fz - z0;
+
+		const btVector3 c00 = lerp(m_cells[cellIndex(x0, y0, z0)], m_cells[cellIndex(x0 + 1, y0, z0)], tx);
+		const btVector3 c10 = lerp(m_cells[cellIndex(x0, y0 + 1, z0)], m_cells[cellIndex(x0 + 1, y0 + 1, z0)], tx);
+		const btVector3 c01 = lerp(m_cells[cellIndex(x0, y0, z0 + 1)], m_cells[cellIndex(x0 + 1, y0, z0 + 1)], tx);
+		const btVector3 c11 = lerp(m_cells[cellIndex(x0, y0 + 1, z0 + 1)], m_cells[cellIndex(x0 + 1, y0 + 1, z0 + 1)], tx);
+
+		return a_baseWind + lerp(lerp(c00, c10, ty), lerp(c01, c11, ty), tz);
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "hdtBulletHelper.h"
+
+#include <mutex>
+#include <vector>
+
+namespace hdt
+{
+	// A local wind source added on top of the weather wind.
+	// Sphere emitters blow radially outwards from their position (or along m_direction when it is not zero),
+	// cone emitters blow along m_direction inside a cone of half angle m_coneAngle starting at m_position.
+	struct WindEmitter
+	{
+		enum class Shape : uint8_t
+		{
+			Sphere,
+			Cone,
+		};
+
+		Shape m_shape = Shape::Sphere;
+		btVector3 m_position = btVector3(0, 0, 0);
+		btVector3 m_direction = btVector3(0, 0, 0);
+		btScalar m_radius = 512.0f;     // range of the emitter, in skyrim units
+		btScalar m_coneAngle = 0.5f;    // half angle in radians, only used by cones
+		btScalar m_strength = 0.0f;     // wind speed at the emitter, same unit as the world wind
+		btScalar m_falloff = 1.0f;      // exponent applied to (1 - distance / radius)
+		btScalar m_turbulence = 0.0f;   // [0, 1], amount of noise mixed into the emitted wind
+		btScalar m_lifetime = -1.0f;    // seconds before the emitter is removed, negative for never
+	};
+
+	// Coarse 3D grid around the camera holding the wind added by the local emitters.
+	// The grid is rebuilt once per frame on the main thread (update), and sampled per dynamic bone
+	// in SkinnedMeshWorld::applyWind with trilinear interpolation (sample).
+	// When no emitter is registered the grid is not built and sample just returns the weather wind.
+	class WindField
+	{
+	public:
+		uint32_t addEmitter(const WindEmitter& emitter);
+		bool removeEmitter(uint32_t id);
+		bool updateEmitter(uint32_t id, const WindEmitter& emitter);
+		void clearEmitters();
+		size_t emitterCount();
+
+		void setResolution(int horizontalCells, btScalar cellSize);
+		int getResolution() const { return m_cellsXY; }
+		btScalar getCellSize() const { return m_cellSize; }
+
+		// Ages the emitters and rebuilds the grid centered on a_center.
+		void update(const btVector3& a_center, btScalar a_timeStep);
+
+		// The world may be recentered around its bodies while simulating; positions given to sample are
+		// then shifted back by this offset to match the grid.
+		void setQueryOffset(const btVector3& a_offset) { m_queryOffset = a_offset; }
+
+		bool isActive() const { return m_active; }
+
+		// Returns a_baseWind plus the interpolated emitter contribution at a_position.
+		btVector3 sample(const btVector3& a_position, const btVector3& a_baseWind) const;
+
+	private:
+		btVector3 evaluate(const btVector3& a_position) const;
+		int cellIndex(int x, int y, int z) const { return (z * m_cellsXY + y) * m_cellsXY + x; }
+
+		struct Entry
+		{
+			uint32_t id;
+			WindEmitter emitter;
+		};
+
+		std::mutex m_emittersLock;
+		std::vector<Entry> m_emitters;
+		std::vector<Entry> m_frameEmitters;  // copy used to build the grid, so that the lock isn't held while building
+		uint32_t m_nextId = 1;
+
+		int m_cellsXY = 16;
+		int m_cellsZ = 8;
+		btScalar m_cellSize = 256.0f;
+
+		btAlignedObjectArray<btVector3> m_cells;
+		btVector3 m_origin = btVector3(0, 0, 0);  // world position of the cell (0, 0, 0)
+		btVector3 m_queryOffset = btVector3(0, 0, 0);
+		btScalar m_time = 0.0f;
+		bool m_active = false;
+	};
+}
@@ -19,15 +19,16 @@ namespace hdt
 		if (m_disabled || body->m_disabled)
 			return false;
 
+		// External colliders have no mesh: they don't belong to any skeleton.
 		switch (m_shared) {
 		case SharedType::SHARED_PUBLIC:
 			break;
 		case SharedType::SHARED_INTERNAL:
-			if (m_mesh->m_skeleton != body->m_mesh->m_skeleton)
+			if (!m_mesh || !body->m_mesh || m_mesh->m_skeleton != body->m_mesh->m_skeleton)
 				return false;
 			break;
 		case SharedType::SHARED_EXTERNAL:
-			if (m_mesh->m_skeleton == body->m_mesh->m_skeleton)
+			if (m_mesh && body->m_mesh && m_mesh->m_skeleton == body->m_mesh->m_skeleton)
 				return false;
 			break;
 		case SharedType::SHARED_PRIVATE:
@@ -4,6 +4,23 @@
 
 namespace hdt
 {
+	namespace
+	{
+		btTransform interpolate(const btTransform& from, const btTransform& to, btScalar s)
+		{
+			auto rotation = to.getRotation();
+			if (rotation.dot(from.getRotation()) < 0)
+				rotation = -rotation;
+			return btTransform(from.getRotation().slerp(rotation, s).normalized(), from.getOrigin().lerp(to.getOrigin(), s));
+		}
+
+		btScalar smoothstep(btScalar s)
+		{
+			s = btClamped(s, btScalar(0), btScalar(1));
+			return s * s * (3 - 2 * s);
+		}
+	}
+
 	SkyrimBone::SkyrimBone(const RE::BSFixedString& name, RE::NiNode* node, RE::NiNode* skeleton, btRigidBody::btRigidBodyConstructionInfo& ci) :
 		SkinnedMeshBone(name, ci), m_node(node), m_skeleton(skeleton)
 	{
@@ -58,6 +75,8 @@ namespace hdt
 			m_rig.setInterpolationLinearVelocity(zero);
 			m_rig.setInterpolationAngularVelocity(zero);
 			m_rig.updateInertiaTensor();
+			m_kinematicTrack.reset();
+			m_blendDuration = 0;
 			//auto det = dest.getBasis().determinant();
 			//if (det < FLT_EPSILON || isnan(det) || isinf(det))
 			//	_WARNING("Invalid rotation matrix!!");
@@ -65,12 +84,30 @@ namespace hdt
 			//if (isnan(det) || isinf(det))
 			//	_WARNING("Invalid inertia tensor matrix!!");
 		} else if (isStaticOrKinematic) {
+			if (m_blendDuration > 0) {
+				// Just made kinematic: the bone leaves its simulated pose for the animated one, with the velocities
+				// of that path, so the dynamic bones it drives follow without a jerk.
+				if (std::exchange(m_blendCapture, false))
+					m_blendOffset = dest.inverseTimes(current);
+				m_blendElapsed += timeStep;
+				const auto s = smoothstep(m_blendElapsed / m_blendDuration);
+				dest = dest * interpolate(m_blendOffset, btTransform::getIdentity(), s);
+				if (s >= 1)
+					m_blendDuration = 0;
+			}
 			btVector3 linVel, angVel;
 			btTransformUtil::calculateVelocity(current, dest, timeStep, linVel, angVel);
 			m_rig.setLinearVelocity(linVel);
 			m_rig.setAngularVelocity(angVel);
 			m_rig.setInterpolationLinearVelocity(linVel);
 			m_rig.setInterpolationAngularVelocity(angVel);
+			m_kinematicTrack.push(current, dest, timeStep);
+		} else {
+			m_kinematicTrack.reset();
+			if (m_blendDuration > 0) {
+				m_blendAnimated = dest;
+				m_blendElapsed += timeStep;
+			}
 		}
 		//else
 		//{
@@ -89,10 +126,25 @@ namespace hdt
 		//}
 	}
 
+	void SkyrimBone::beginToggleBlend(float duration)
+	{
+		m_blendDuration = duration;
+		m_blendElapsed = 0;
+		m_blendCapture = true;
+		m_blendAnimated = m_rig.getWorldTransform();
+	}
+
 	void SkyrimBone::writeTransform()
 	{
 		//if (m_rig.isStaticOrKinematicObject()) return;
 		auto transform = m_rig.getWorldTransform() * m_rigToLocal;
+		if (m_blendDuration > 0 && !m_rig.isStaticOrKinematicObject()) {
+			// Just made dynamic: the node is shown going from the animated pose to the simulated one.
+			const auto s = smoothstep(m_blendElapsed / m_blendDuration);
+			transform = interpolate(m_blendAnimated * m_rigToLocal, transform, s);
+			if (s >= 1)
+				m_blendDuration = 0;
+		}
 
 		m_currentTransform.setBasis(transform.getBasis());
 		m_currentTransform.setOrigin(transform.getOrigin());
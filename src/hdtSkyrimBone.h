@@ -12,12 +12,22 @@ namespace hdt
 
 		void readTransform(float timeStep) override;
 		void writeTransform() override;
+		void beginToggleBlend(float duration) override;
 
 		int m_depth;
+		bool m_autoMass = false;  // mass and inertia computed from the shape, may be adjusted to the neighbours
 		RE::NiPointer<RE::NiNode> m_node;
 		RE::NiPointer<RE::NiNode> m_skeleton;
 
 	private:
 		int m_forceUpdateType;
+
+		// Toggle blend: the kinematic bone goes from the simulated pose it had to the animated one, the dynamic bone is
+		// written from the animated pose to the simulated one.
+		btTransform m_blendOffset = btTransform::getIdentity();    // simulated pose relative to the animated one, when toggled
+		btTransform m_blendAnimated = btTransform::getIdentity();  // animated rig transform of the frame
+		float m_blendElapsed = 0;
+		float m_blendDuration = 0;  // 0 when not blending
+		bool m_blendCapture = false;
 	};
 }
@@ -2,6 +2,7 @@
 #include "PluginInterfaceImpl.h"
 #include "WeatherManager.h"
 #include "hdtPhysicsProfiler.h"
+#include "hdtSystemSnapshot.h"
 
 #include <LinearMath/btQuickprof.h>
 
@@ -148,19 +149,25 @@ namespace hdt
 		}
 
 		g_pluginInterface.onPreStep({ getCollisionObjectArray(), remainingTimeStep });
+		setContactReporting(g_pluginInterface.hasContactListeners());
 
 		{
 			BT_PROFILE("HDTSMP_doUpdate2ndStep");
 			updateActiveState();
 			auto offset = applyTranslationOffset();
+			m_windField.setQueryOffset(offset);
 			stepSimulation(remainingTimeStep, 0, tick);
 			restoreTranslationOffset(offset);
+			m_windField.setQueryOffset(btVector3(0, 0, 0));
 			m_accumulatedInterval = 0;
 			m_pendingTransformUpdate = true;
 		}
 
 		g_pluginInterface.onPostStep({ getCollisionObjectArray(), remainingTimeStep });
 
+		if (m_reportContacts)
+			sendContactEvent(remainingTimeStep);
+
 		if (m_doMetrics) {
 			QueryPerformanceCounter(&ticks);
 			int64_t endTime = ticks.QuadPart;
@@ -173,6 +180,45 @@ namespace hdt
 		physicsprofiler::advanceFrame();
 	}
 
+	void SkyrimPhysicsWorld::sendContactEvent(float timeStep)
+	{
+		auto& records = getContactRecords();
+		if (records.empty())
+			return;
+
+		// external colliders don't belong to any system
+		auto identify = [](const SkyrimSystem* system, unsigned int& actor, unsigned int& handle, const char*& physicsFile) {
+			auto owner = system && system->m_skeleton ? system->m_skeleton->GetUserData() : nullptr;
+			actor = owner ? owner->formID : 0;
+			handle = system ? system->m_handle : 0;
+			physicsFile = system ? system->m_physicsFile.c_str() : nullptr;
+		};
+
+		m_contactEvents.clear();
+		m_contactEvents.reserve(records.size());
+		for (auto& record : records) {
+			auto& contact = m_contactEvents.emplace_back();
+			identify(static_cast<SkyrimBody*>(record.bodyA)->m_mesh, contact.actorA, contact.systemA, contact.physicsFileA);
+			identify(static_cast<SkyrimBody*>(record.bodyB)->m_mesh, contact.actorB, contact.systemB, contact.physicsFileB);
+			contact.bodyA = record.bodyA;
+			contact.bodyB = record.bodyB;
+			contact.boneA = &record.boneA->m_rig;
+			contact.boneB = &record.boneB->m_rig;
+			contact.boneNameA = record.boneA->m_name.c_str();
+			contact.boneNameB = record.boneB->m_name.c_str();
+			contact.position[0] = record.position.x();
+			contact.position[1] = record.position.y();
+			contact.position[2] = record.position.z();
+			contact.normal[0] = record.normal.x();
+			contact.normal[1] = record.normal.y();
+			contact.normal[2] = record.normal.z();
+			contact.impulse = record.impulse;
+			contact.phase = static_cast<ContactEvent::Phase>(record.phase);
+		}
+
+		g_pluginInterface.onContact({ m_contactEvents.data(), static_cast<unsigned int>(m_contactEvents.size()), timeStep });
+	}
+
 	std::unique_lock<std::mutex> SkyrimPhysicsWorld::lockSimulation()
 	{
 		m_tasks.wait();
@@ -194,6 +240,7 @@ namespace hdt
 
 		if (count > 0) {
 			center /= static_cast<btScalar>(count);
+			m_simulationOffset = center;
 			for (int i = 0; i < m_collisionObjects.size(); ++i) {
 				auto rig = btRigidBody::upcast(m_collisionObjects[i]);
 				if (rig)
@@ -205,6 +252,7 @@ namespace hdt
 
 	void SkyrimPhysicsWorld::restoreTranslationOffset(const btVector3& offset)
 	{
+		m_simulationOffset.setZero();
 		for (int i = 0; i < m_collisionObjects.size(); ++i) {
 			auto rig = btRigidBody::upcast(m_collisionObjects[i]);
 			if (rig) {
@@ -291,15 +339,78 @@ namespace hdt
 
 		s->m_initialized = false;
 		SkinnedMeshWorld::addSkinnedMeshSystem(system);
+
+		if (auto snapshot = SnapshotStore::GetSingleton()->find(*s)) {
+			snapshot->restore(*s);
+			s->m_restoredSnapshot = std::move(snapshot);
+		}
 	}
 
 	void SkyrimPhysicsWorld::removeSkinnedMeshSystem(SkinnedMeshSystem* system)
 	{
 		std::lock_guard<decltype(m_lock)> l(m_lock);
 
+		if (auto s = dynamic_cast<SkyrimSystem*>(system))
+			SnapshotStore::GetSingleton()->store(*s);
 		SkinnedMeshWorld::removeSkinnedMeshSystem(system);
 	}
 
+	void SkyrimPhysicsWorld::addExternalBody(SkinnedMeshBody* body)
+	{
+		std::lock_guard<decltype(m_lock)> l(m_lock);
+
+		SkinnedMeshWorld::addExternalBody(body);
+	}
+
+	void SkyrimPhysicsWorld::removeExternalBody(SkinnedMeshBody* body)
+	{
+		std::lock_guard<decltype(m_lock)> l(m_lock);
+
+		SkinnedMeshWorld::removeExternalBody(body);
+	}
+
+	uint32_t SkyrimPhysicsWorld::addExternalCollider(const ExternalColliderInfo& info)
+	{
+		auto body = ExternalColliderBody::create(info);
+		if (!body)
+			return 0;
+
+		addExternalBody(body.get());
+
+		std::lock_guard<decltype(m_externalCollidersLock)> l(m_externalCollidersLock);
+		const uint32_t id = m_nextExternalColliderId++;
+		m_externalColliders.emplace(id, body);
+		return id;
+	}
+
+	bool SkyrimPhysicsWorld::setExternalColliderTransform(uint32_t id, const btTransform& transform, bool teleport)
+	{
+		std::lock_guard<decltype(m_externalCollidersLock)> l(m_externalCollidersLock);
+		auto it = m_externalColliders.find(id);
+		if (it == m_externalColliders.end())
+			return false;
+
+		it->second->bone()->setTarget(transform, teleport);
+		return true;
+	}
+
+	bool SkyrimPhysicsWorld::removeExternalCollider(uint32_t id)
+	{
+		RE::BSTSmartPointer<ExternalColliderBody> body;
+		{
+			std::lock_guard<decltype(m_externalCollidersLock)> l(m_externalCollidersLock);
+			auto it = m_externalColliders.find(id);
+			if (it == m_externalColliders.end())
+				return false;
+
+			body = std::move(it->second);
+			m_externalColliders.erase(it);
+		}
+
+		removeExternalBody(body.get());
+		return true;
+	}
+
 	void SkyrimPhysicsWorld::removeSystemByNode(void* root)
 	{
 		std::lock_guard<decltype(m_lock)> l(m_lock);
@@ -307,6 +418,7 @@ namespace hdt
 		for (int i = 0; i < m_systems.size();) {
 			RE::BSTSmartPointer<SkyrimSystem> s = hdt::make_smart(dynamic_cast<SkyrimSystem*>(m_systems[i].get()));
 			if (s && s->m_skeleton == root) {
+				SnapshotStore::GetSingleton()->store(*s);
 				SkinnedMeshWorld::removeSkinnedMeshSystem(s.get());
 			}
 
@@ -315,11 +427,23 @@ namespace hdt
 		}
 	}
 
+	void SkyrimPhysicsWorld::storeSnapshots()
+	{
+		auto l = lockSimulation();
+		for (auto& i : m_systems)
+			if (auto s = dynamic_cast<SkyrimSystem*>(i.get()))
+				SnapshotStore::GetSingleton()->store(*s);
+	}
+
 	void SkyrimPhysicsWorld::resetSystems()
 	{
 		std::lock_guard<decltype(m_lock)> l(m_lock);
 		for (auto& i : m_systems)
 			i->readTransform(i->prepareForRead(RESET_PHYSICS));
+
+		for (auto& body : m_externalBodies)
+			for (auto& bone : body->m_skinnedBones)
+				bone.ptr->readTransform(RESET_PHYSICS);
 	}
 
 	RE::BSEventNotifyControl SkyrimPhysicsWorld::ProcessEvent(const Events::FrameEvent* e, RE::BSTEventSource<Events::FrameEvent>*)
@@ -349,6 +473,8 @@ namespace hdt
 		float interval = (m_useRealTime ? RE::BSTimer::GetSingleton()->realTimeDelta : RE::BSTimer::GetSingleton()->delta);
 
 		if (interval > FLT_EPSILON && !m_suspended && !m_systems.empty()) {
+			if (m_enableWind)
+				m_windField.update(convertNi(ActorManager::instance()->getCameraPosition()), interval);
 			doUpdate(interval);
 		} else if (m_suspended && !m_loading) {
 			writeTransform();
@@ -439,6 +565,15 @@ namespace hdt
 			SkinnedMeshWorld::removeSkinnedMeshSystem(m_systems.back().get());
 		}
 
+		while (m_externalBodies.size()) {
+			SkinnedMeshWorld::removeExternalBody(m_externalBodies.back().get());
+		}
+
+		{
+			std::lock_guard<decltype(m_externalCollidersLock)> l(m_externalCollidersLock);
+			m_externalColliders.clear();
+		}
+
 		m_tasks.wait();
 
 		return RE::BSEventNotifyControl::kContinue;
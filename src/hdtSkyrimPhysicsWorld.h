@@ -2,6 +2,8 @@
 
 #include "ActorManager.h"
 #include "Events.h"
+#include "PluginAPI.h"
+#include "hdtExternalCollider.h"
 #include "hdtSkinnedMesh/hdtSkinnedMeshWorld.h"
 #include "hdtSkyrimSystem.h"
 
@@ -27,9 +29,20 @@ namespace hdt
 		void addSkinnedMeshSystem(SkinnedMeshSystem* system) override;
 		void removeSkinnedMeshSystem(SkinnedMeshSystem* system) override;
 		void removeSystemByNode(void* root);
+		void addExternalBody(SkinnedMeshBody* body) override;
+		void removeExternalBody(SkinnedMeshBody* body) override;
 		using SkinnedMeshWorld::updateConstraintsForBone;
+		using SkinnedMeshWorld::restoreConstraintOrder;
+
+		// Bulk access for other plugins, see PluginAPI.h.
+		using SkinnedMeshWorld::BoneForce;
+		using SkinnedMeshWorld::findSystem;
+		using SkinnedMeshWorld::getSystems;
+		using SkinnedMeshWorld::queueBoneForces;
 
 		void resetSystems();
+		// Keeps the current pose of every system in the snapshot store, e.g. before saving.
+		void storeSnapshots();
 
 		RE::BSEventNotifyControl ProcessEvent(const Events::FrameEvent* e, RE::BSTEventSource<Events::FrameEvent>*) override;
 		RE::BSEventNotifyControl ProcessEvent(const Events::FrameSyncEvent* e, RE::BSTEventSource<Events::FrameSyncEvent>*) override;
@@ -68,6 +81,15 @@ namespace hdt
 		// @a_smoothingSamples How many samples to smooth. Defaults to 8. Must be greater than 0. Value of 1 means no smoothing
 		void setWind(const RE::NiPoint3& a_direction, float a_scale = scaleSkyrim, uint32_t a_smoothingSamples = 8);
 
+		// Local wind emitters (doors, dragons, spells...) added on top of the weather wind.
+		using SkinnedMeshWorld::getWindField;
+
+		// Kinematic primitives registered by other plugins, returns 0 on failure. Adding and removing lock the
+		// simulation, so they must not be called from the step events; moving them can be done from anywhere.
+		uint32_t addExternalCollider(const ExternalColliderInfo& info);
+		bool setExternalColliderTransform(uint32_t id, const btTransform& transform, bool teleport);
+		bool removeExternalCollider(uint32_t id);
+
 		tbb::task_group m_tasks;
 
 		bool m_pendingTransformUpdate = false;
@@ -76,11 +98,18 @@ namespace hdt
 		float m_budgetMs = 3.5f;
 		float m_timeTick = 1 / 60.f;
 		int m_maxSubSteps = 4;
+		bool m_smoothKinematics = true;  // kinematic bones follow a smooth path during the substeps
+		bool m_enableTethers = true;     // limit the stretching of the bone chains after the solver
+		float m_tetherSlack = 0.1f;      // stretching allowed by the tethers, relative to the rest length
+		float m_maxMassRatio = 10.0f;    // between the bones of a constraint, when their masses come from a density
+		int m_resetRecoverySteps = 4;    // substeps pushing the dynamic bones out of the body after a reset
+		bool m_symmetricSolver = true;   // alternate the direction the solver goes through the constraints
 		bool m_clampRotations = true;
 		// @brief rotation speed limit of the PC in radians per second. Must be positive.
 		float m_rotationSpeedLimit = 10.f;
 		bool m_unclampedResets = true;
 		float m_unclampedResetAngle = 120.0f;
+		float m_physicsToggleBlendTime = 0.25f;  // seconds to blend the bones toggled by the scripts, 0 switches at once
 		float m_2ndStepAverageProcessingTime = 0;
 		float m_averageSMPProcessingTimeInMainLoop = 0;
 		bool disabled = false;
@@ -93,6 +122,12 @@ namespace hdt
 		float m_windStrength = 2.0f;           // compare to gravity acceleration of 9.8
 		float m_distanceForNoWind = 50.0f;     // how close to wind obstruction to fully block wind
 		float m_distanceForMaxWind = 3000.0f;  // how far to wind obstruction to not block wind
+		int m_windFieldResolution = 16;        // horizontal cells of the local wind grid
+		float m_windFieldCellSize = 256.0f;    // size of a cell of the local wind grid
+		bool m_aerodynamics = false;           // per-triangle drag and lift on the dynamic per-triangle shapes
+		float m_dragCoefficient = 1.0f;
+		float m_liftCoefficient = 0.5f;
+		float m_windAirSpeed = 10.0f;          // m/s of the air at windStrength, for the aerodynamics
 
 	private:
 		SkyrimPhysicsWorld(void);
@@ -105,5 +140,12 @@ namespace hdt
 		float m_accumulatedInterval;
 		float m_averageInterval;
 		float m_SMPProcessingTimeInMainLoop = 0;
+
+		std::mutex m_externalCollidersLock;
+		std::unordered_map<uint32_t, RE::BSTSmartPointer<ExternalColliderBody>> m_externalColliders;
+		uint32_t m_nextExternalColliderId = 1;
+
+		void sendContactEvent(float timeStep);
+		std::vector<ContactEvent::Contact> m_contactEvents;
 	};
 }
@@ -4,6 +4,8 @@
 #include "HavokUtils.h"
 #include "XmlReader.h"
 #include "hdtSkyrimPhysicsWorld.h"
+#include "hdtSystemSnapshot.h"
+#include <LinearMath/btConvexHullComputer.h>
 
 // F16C isn't supported on super old processors. AVX2+ (AVX processors can have it, but not guaranteed)
 #if defined(__AVX2__) || defined(__AVX512F__)
@@ -83,6 +85,75 @@ namespace hdt
 		m_skeleton(skeleton), m_oldRoot(nullptr)
 	{
 		m_oldRoot = m_skeleton;
+		m_lastSkeletonTransform.setIdentity();
+	}
+
+	void SkyrimSystem::readTransform(float timeStep)
+	{
+		SkinnedMeshSystem::readTransform(timeStep);
+
+		// The animated pose the bones snapped to usually goes through the body; a restored pose (below) doesn't, and
+		// keeps its velocities.
+		if (timeStep <= RESET_PHYSICS && !block_resetting && !m_restoredSnapshot)
+			m_recoverySteps = SkyrimPhysicsWorld::get()->m_resetRecoverySteps;
+
+		const btTransform skeletonTransform(convertNi(m_skeleton->world.rotate), convertNi(m_skeleton->world.translate));
+		if (timeStep <= RESET_PHYSICS)
+			m_hasRootVelocity = false;
+		else if (m_linearInertiaScale < 1.0f || m_angularInertiaScale < 1.0f)
+			followSkeleton(m_lastSkeletonTransform, skeletonTransform, timeStep);
+		m_lastSkeletonTransform = skeletonTransform;
+
+		// A restored pose survives the resets of the first frames (e.g. when the loading screen closes),
+		// but not the simulation.
+		if (m_restoredSnapshot) {
+			if (timeStep <= RESET_PHYSICS) {
+				m_restoredSnapshot->restore(*this);
+				m_recoverySteps = 0;  // also the one of a reset before the snapshot was attached
+			} else {
+				m_restoredSnapshot.reset();
+			}
+		}
+	}
+
+	// Simulates in world space with the fictitious forces of a frame that partially follows the skeleton: each dynamic
+	// bone is given (1 - scale) of the acceleration it would have if it were fixed to the skeleton (the translation
+	// term, and the Euler, centrifugal and Coriolis terms of the rotation), so it only feels the remaining part as
+	// inertia. The kinematic bones keep their world velocities; a steady motion adds nothing.
+	void SkyrimSystem::followSkeleton(const btTransform& from, const btTransform& to, float timeStep)
+	{
+		const btVector3 linearVelocity = (to.getOrigin() - from.getOrigin()) / timeStep;
+		btVector3 axis;
+		btScalar angle;
+		btTransformUtil::calculateDiffAxisAngleQuaternion(from.getRotation(), to.getRotation(), axis, angle);
+		const btVector3 angularVelocity = axis * (angle / timeStep);
+
+		// The first frame after a reset only gives the velocities to differentiate.
+		if (m_hasRootVelocity) {
+			const btVector3 linearKick = (linearVelocity - m_lastRootLinearVelocity) * (1.0f - m_linearInertiaScale);
+			const btVector3 angularChange = angularVelocity - m_lastRootAngularVelocity;
+			const btScalar angularShare = 1.0f - m_angularInertiaScale;
+			const btVector3& pivot = to.getOrigin();
+
+			for (auto& bone : m_bones) {
+				auto& rig = bone->m_rig;
+				if (rig.isStaticOrKinematicObject())
+					continue;
+
+				const btVector3 r = rig.getCenterOfMassPosition() - pivot;
+				const btVector3 relative = rig.getLinearVelocity() - (linearVelocity + angularVelocity.cross(r));
+				const btVector3 rotationKick = angularChange.cross(r) +
+				                               (angularVelocity.cross(angularVelocity.cross(r)) + 2 * angularVelocity.cross(relative)) * timeStep;
+				rig.setLinearVelocity(rig.getLinearVelocity() + linearKick + rotationKick * angularShare);
+				rig.setAngularVelocity(rig.getAngularVelocity() + angularChange * angularShare);
+				rig.setInterpolationLinearVelocity(rig.getLinearVelocity());
+				rig.setInterpolationAngularVelocity(rig.getAngularVelocity());
+			}
+		}
+
+		m_lastRootLinearVelocity = linearVelocity;
+		m_lastRootAngularVelocity = angularVelocity;
+		m_hasRootVelocity = true;
 	}
 
 	float SkyrimSystem::prepareForRead(float timeStep)
@@ -141,6 +212,8 @@ namespace hdt
 				} else if (SkyrimPhysicsWorld::get()->m_unclampedResets) {
 					float limit = SkyrimPhysicsWorld::get()->m_unclampedResetAngle * timeStep;
 
+					// Only the part of the turn the bones feel can throw them around.
+					rotAngle *= m_angularInertiaScale;
 					if (rotAngle < -limit || rotAngle > limit) {
 						timeStep = RESET_PHYSICS;
 						updateTransformUpDown(m_skeleton.get(), true);
@@ -317,6 +390,8 @@ namespace hdt
 						auto defaultConeTwistConstraintTemplate = getConeTwistConstraintTemplate(extends);
 						readConeTwistConstraintTemplate(defaultConeTwistConstraintTemplate);
 						m_coneTwistConstraintTemplates[clsname] = defaultConeTwistConstraintTemplate;
+					} else if (name == "inertia-scale") {
+						readInertiaScale();
 					} else if (name == "shape") {
 						auto attrName = m_reader->getAttribute("name");
 						auto shape = readShape();
@@ -360,10 +435,16 @@ namespace hdt
 		}
 
 		m_mesh->m_skeleton = hdt::make_nismart(m_skeleton);
+		m_mesh->m_physicsFile = m_filePath;
 		m_mesh->m_shapeRefs.swap(m_shapeRefs);
 		std::sort(m_mesh->m_bones.begin(), m_mesh->m_bones.end(), [](const auto& a, const auto& b) {
 			return static_cast<SkyrimBone*>(a.get())->m_depth < static_cast<SkyrimBone*>(b.get())->m_depth;
 		});
+		clampMassRatios();
+		m_mesh->buildTethers();
+		m_mesh->buildSolverOrder();
+		const auto& topology = m_mesh->topology();
+		logger::debug("{} : {} chains, {} trees, {} meshes, {} links deep", m_filePath, topology.chains, topology.trees, topology.meshes, topology.maxDepth);
 
 		// Restore the original pose to avoid a visual 1 Havok tick T-pose (only for visual reasons, it won't break anything otherwise)
 		for (auto& [node, transform] : savedPoses) node->local = transform;
@@ -387,6 +468,10 @@ namespace hdt
 					auto constraint = readGenericConstraint();
 					if (constraint)
 						ret->m_constraints.push_back(constraint);
+				} else if (name == "shape-matching") {
+					auto constraint = readShapeMatching();
+					if (constraint)
+						ret->m_shapeMatchings.push_back(constraint);
 				} else if (name == "stiffspring-constraint") {
 					auto constraint = readStiffSpringConstraint();
 					if (constraint)
@@ -423,6 +508,24 @@ namespace hdt
 		return ret;
 	}
 
+	void SkyrimSystemCreator::readInertiaScale()
+	{
+		while (m_reader->Inspect()) {
+			if (m_reader->GetInspected() == XMLReader::Inspected::StartTag) {
+				auto name = m_reader->GetName();
+				if (name == "linear")
+					m_mesh->m_linearInertiaScale = btClamped(m_reader->readFloat(), 0.0f, 1.0f);
+				else if (name == "angular")
+					m_mesh->m_angularInertiaScale = btClamped(m_reader->readFloat(), 0.0f, 1.0f);
+				else {
+					logger::warn("unknown element - {}", name.c_str());
+					m_reader->skipCurrentElement();
+				}
+			} else if (m_reader->GetInspected() == XMLReader::Inspected::EndTag)
+				break;
+		}
+	}
+
 	void SkyrimSystemCreator::readBoneTemplate(BoneTemplate& cinfo)
 	{
 		bool clearCollide = true;
@@ -474,6 +577,10 @@ namespace hdt
 					cinfo.m_gravityFactor = btClamped(m_reader->readFloat(), 0.0f, 1.0f);
 				} else if (name == "wind-factor") {
 					cinfo.m_windFactor = std::max(m_reader->readFloat(), 0.0f);
+				} else if (name == "density") {
+					cinfo.m_density = std::max(m_reader->readFloat(), 0.0f);
+				} else if (name == "air-drag") {
+					cinfo.m_airDrag = std::max(m_reader->readFloat(), 0.0f);
 				} else {
 					logger::warn("unknown element - {}", name.c_str());
 					m_reader->skipCurrentElement();
@@ -635,6 +742,132 @@ namespace hdt
 		return nullptr;
 	}
 
+	namespace
+	{
+		// Volume of the shapes that can be declared in the XML, in cubic Skyrim units.
+		btScalar shapeVolume(const btCollisionShape* shape)
+		{
+			switch (shape->getShapeType()) {
+			case SPHERE_SHAPE_PROXYTYPE:
+				{
+					const btScalar r = static_cast<const btSphereShape*>(shape)->getRadius();
+					return 4.0f / 3.0f * SIMD_PI * r * r * r;
+				}
+			case CAPSULE_SHAPE_PROXYTYPE:
+				{
+					auto capsule = static_cast<const btCapsuleShape*>(shape);
+					const btScalar r = capsule->getRadius();
+					return SIMD_PI * r * r * (2.0f * capsule->getHalfHeight() + 4.0f / 3.0f * r);
+				}
+			case BOX_SHAPE_PROXYTYPE:
+				{
+					const btVector3 e = static_cast<const btBoxShape*>(shape)->getHalfExtentsWithMargin();
+					return 8.0f * e.x() * e.y() * e.z();
+				}
+			case CYLINDER_SHAPE_PROXYTYPE:
+				{
+					// created around the Y axis, see readShape
+					const btVector3 e = static_cast<const btCylinderShape*>(shape)->getHalfExtentsWithMargin();
+					return SIMD_PI * e.x() * e.x() * 2.0f * e.y();
+				}
+			case CONVEX_HULL_SHAPE_PROXYTYPE:
+				{
+					auto hull = static_cast<const btConvexHullShape*>(shape);
+					btConvexHullComputer computer;
+					computer.compute(&hull->getUnscaledPoints()->x(), sizeof(btVector3), hull->getNumPoints(), 0, 0);
+
+					// sum of the tetrahedra from the origin to the faces, fanned from their first vertex
+					btScalar volume = 0;
+					for (int i = 0; i < computer.faces.size(); ++i) {
+						const auto* first = &computer.edges[computer.faces[i]];
+						const btVector3& a = computer.vertices[first->getSourceVertex()];
+						for (auto edge = first->getNextEdgeOfFace(); edge->getTargetVertex() != first->getSourceVertex(); edge = edge->getNextEdgeOfFace())
+							volume += a.dot(computer.vertices[edge->getSourceVertex()].cross(computer.vertices[edge->getTargetVertex()]));
+					}
+					return btFabs(volume) / 6.0f;
+				}
+			case COMPOUND_SHAPE_PROXYTYPE:
+				{
+					auto compound = static_cast<const btCompoundShape*>(shape);
+					btScalar volume = 0;
+					for (int i = 0; i < compound->getNumChildShapes(); ++i)
+						volume += shapeVolume(compound->getChildShape(i));
+					return volume;
+				}
+			default:
+				return 0;
+			}
+		}
+	}
+
+	// The density is in kg/m3. The mass is set to 0 by the kinematic bones, they are left alone.
+	bool SkyrimSystemCreator::computeMassProps(BoneTemplate& cinfo)
+	{
+		if (cinfo.m_density <= 0 || !cinfo.m_mass || !cinfo.m_collisionShape)
+			return false;
+
+		const btScalar volume = shapeVolume(cinfo.m_collisionShape);
+		if (volume <= 0)
+			return false;
+
+		cinfo.m_mass = cinfo.m_density * volume * scaleRealWorld * scaleRealWorld * scaleRealWorld;
+		cinfo.m_collisionShape->calculateLocalInertia(cinfo.m_mass, cinfo.m_localInertia);
+		return true;
+	}
+
+	// The solver converges badly when the masses on both sides of a constraint are too different. The bones whose
+	// mass was computed are brought within solver.maxMassRatio of their neighbours, the lighter ones made heavier
+	// first; the masses given explicitly are never changed.
+	void SkyrimSystemCreator::clampMassRatios()
+	{
+		const btScalar maxRatio = SkyrimPhysicsWorld::get()->m_maxMassRatio;
+		if (maxRatio <= 0)
+			return;
+
+		std::vector<BoneScaleConstraint*> constraints;
+		for (auto& constraint : m_mesh->m_constraints)
+			constraints.push_back(constraint.get());
+		for (auto& group : m_mesh->m_constraintGroups)
+			for (auto& constraint : group->m_constraints)
+				constraints.push_back(constraint.get());
+
+		auto setMass = [](SkinnedMeshBone* bone, btScalar mass) {
+			auto& rig = bone->m_rig;
+			const btVector3 inertia = rig.getLocalInertia() * (mass * rig.getInvMass());
+			rig.setMassProps(mass, inertia);
+			rig.updateInertiaTensor();
+		};
+
+		// Raising a mass can break the ratio on its other side, a few passes are needed along a chain.
+		for (size_t pass = 0; pass < m_mesh->m_bones.size(); ++pass) {
+			bool changed = false;
+			for (auto constraint : constraints) {
+				auto a = static_cast<SkyrimBone*>(constraint->m_boneA);
+				auto b = static_cast<SkyrimBone*>(constraint->m_boneB);
+				if (a->m_rig.isStaticOrKinematicObject() || b->m_rig.isStaticOrKinematicObject())
+					continue;
+
+				if (a->m_rig.getInvMass() < b->m_rig.getInvMass())
+					std::swap(a, b);
+				// a is the lighter one
+				const btScalar light = 1.0f / a->m_rig.getInvMass();
+				const btScalar heavy = 1.0f / b->m_rig.getInvMass();
+				if (heavy <= light * maxRatio * 1.001f)
+					continue;
+
+				if (a->m_autoMass)
+					setMass(a, heavy / maxRatio);
+				else if (b->m_autoMass)
+					setMass(b, light * maxRatio);
+				else
+					continue;
+				changed = true;
+			}
+			if (!changed)
+				break;
+		}
+	}
+
 	void SkyrimSystemCreator::readOrUpdateBone()
 	{
 		RE::BSFixedString name = getRenamedBone(m_reader->getAttribute("name"));
@@ -656,12 +889,18 @@ namespace hdt
 			auto boneTemplate = getBoneTemplate(templateName);
 			if (readTemplate)
 				readBoneTemplate(boneTemplate);
+			const bool autoMass = computeMassProps(boneTemplate);
+			if (boneTemplate.m_density > 0 && !autoMass && boneTemplate.m_mass)
+				logger::warn("Bone {} has a density but no shape to compute its mass from, its mass is kept", bodyName.c_str());
 			auto bone = new SkyrimBone(node->name.c_str(), node, this->m_skeleton, boneTemplate);
+			bone->m_autoMass = autoMass;
 			bone->m_localToRig = boneTemplate.m_centerOfMassTransform;
 			bone->m_rigToLocal = boneTemplate.m_centerOfMassTransform.inverse();
 			bone->m_marginMultipler = boneTemplate.m_marginMultipler;
 			bone->m_gravityFactor = boneTemplate.m_gravityFactor;
 			bone->m_windFactor = boneTemplate.m_windFactor;
+			// given per meter in the XML
+			bone->m_airDrag = boneTemplate.m_airDrag * scaleRealWorld;
 
 			bone->readTransform(RESET_PHYSICS);
 
@@ -1208,6 +1447,42 @@ namespace hdt
 		}
 	}
 
+	RE::BSTSmartPointer<ShapeMatchingConstraint> SkyrimSystemCreator::readShapeMatching()
+	{
+		std::vector<SkinnedMeshBone*> bones;
+		float stiffness = 0.5f;
+		while (m_reader->Inspect()) {
+			if (m_reader->GetInspected() == XMLReader::Inspected::StartTag) {
+				auto name = m_reader->GetName();
+				if (name == "bone") {
+					auto boneName = getRenamedBone(m_reader->readText());
+					SkinnedMeshBone* bone = findBoneFromIndex(boneName);
+					if (!bone) {
+						logger::warn("shape-matching : bone {} doesn't exist, will try to create it", boneName.c_str());
+						bone = createBoneFromNodeName(boneName);
+					}
+					if (bone && std::find(bones.begin(), bones.end(), bone) == bones.end())
+						bones.push_back(bone);
+				} else if (name == "stiffness")
+					stiffness = btClamped(m_reader->readFloat(), 0.0f, 1.0f);
+				else {
+					logger::warn("unknown element - {}", name.c_str());
+					m_reader->skipCurrentElement();
+				}
+			} else if (m_reader->GetInspected() == XMLReader::Inspected::EndTag)
+				break;
+		}
+
+		if (bones.size() < 2 || std::all_of(bones.begin(), bones.end(), [](auto bone) { return bone->m_rig.isStaticOrKinematicObject(); })) {
+			logger::warn("shape-matching needs at least 2 bones and a dynamic one, skipped");
+			return nullptr;
+		}
+
+		auto ret = RE::make_smart<ShapeMatchingConstraint>(bones);
+		ret->m_stiffness = stiffness;
+		return ret;
+	}
+
 	RE::BSTSmartPointer<Generic6DofConstraint> SkyrimSystemCreator::readGenericConstraint()
 	{
 		auto bodyAName = getRenamedBone(m_reader->getAttribute("bodyA"));
@@ -12,6 +12,8 @@
 namespace hdt
 {
 	class PerVertexShape;
+	struct SystemSnapshot;
+
 	class SkyrimSystem : public SkinnedMeshSystem
 	{
 		friend class SkyrimSystemCreator;
@@ -31,16 +33,32 @@ namespace hdt
 		int findBoneIdx(const RE::BSFixedString& name);
 
 		float prepareForRead(float timeStep) override;
+		void readTransform(float timeStep) override;
 
 		const std::vector<RE::BSTSmartPointer<SkinnedMeshBody>>& meshes() const { return m_meshes; }
 
 		RE::NiPointer<RE::NiNode> m_skeleton;
 		RE::NiPointer<RE::NiNode> m_oldRoot;
+		std::string m_physicsFile;
+		std::shared_ptr<const SystemSnapshot> m_restoredSnapshot;
 		bool m_initialized = false;
 		float m_windFactor = 1.f;  // wind factor for the system (i.e., full actor/skeleton) (calculated based off obstructions)
 
+		// How much of the motion of the skeleton the dynamic bones feel, from <inertia-scale>. At 1, they feel all of it;
+		// at 0, they move with the skeleton as if fixed to it and only react to the animation.
+		float m_linearInertiaScale = 1.f;
+		float m_angularInertiaScale = 1.f;
+
 		// angular velocity damper
 		btQuaternion m_lastRootRotation;
+
+	private:
+		void followSkeleton(const btTransform& from, const btTransform& to, float timeStep);
+
+		btTransform m_lastSkeletonTransform;
+		btVector3 m_lastRootLinearVelocity = btVector3(0, 0, 0);
+		btVector3 m_lastRootAngularVelocity = btVector3(0, 0, 0);
+		bool m_hasRootVelocity = false;
 	};
 
 	class XMLReader;
@@ -95,6 +113,8 @@ namespace hdt
 			float m_marginMultipler;
 			float m_gravityFactor = 1.0f;
 			float m_windFactor = 1.0f;
+			float m_airDrag = 0.0f;
+			float m_density = 0.0f;  // when positive, the mass and inertia of a dynamic bone come from its shape
 			U32 m_collisionFilter = 0;
 		};
 
@@ -216,6 +236,11 @@ namespace hdt
 		RE::BSTSmartPointer<StiffSpringConstraint> readStiffSpringConstraint();
 		RE::BSTSmartPointer<ConeTwistConstraint> readConeTwistConstraint();
 		RE::BSTSmartPointer<ConstraintGroup> readConstraintGroup();
+		RE::BSTSmartPointer<ShapeMatchingConstraint> readShapeMatching();
+		void readInertiaScale();
 		std::shared_ptr<btCollisionShape> readShape();
+
+		static bool computeMassProps(BoneTemplate& cinfo);
+		void clampMassRatios();
 	};
 }
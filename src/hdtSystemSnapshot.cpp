@@ -0,0 +1,270 @@
+#include "hdtSystemSnapshot.h"
+
+namespace hdt
+{
+	namespace
+	{
+		constexpr uint64_t fnvOffset = 14695981039346656037ull;
+		constexpr uint64_t fnvPrime = 1099511628211ull;
+
+		void hashBytes(uint64_t& h, const void* data, size_t size)
+		{
+			auto bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; ++i) {
+				h ^= bytes[i];
+				h *= fnvPrime;
+			}
+		}
+
+		template <class T>
+		void write(std::stringstream& s, const T& value)
+		{
+			s.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template <class T>
+		bool read(std::stringstream& s, T& value)
+		{
+			return static_cast<bool>(s.read(reinterpret_cast<char*>(&value), sizeof(T)));
+		}
+
+		void writeVector(std::stringstream& s, const btVector3& v)
+		{
+			write(s, v.x());
+			write(s, v.y());
+			write(s, v.z());
+		}
+
+		bool readVector(std::stringstream& s, btVector3& v)
+		{
+			float x, y, z;
+			if (!read(s, x) || !read(s, y) || !read(s, z))
+				return false;
+			v.setValue(x, y, z);
+			return true;
+		}
+	}
+
+	uint64_t SystemSnapshot::hash(SkyrimSystem& system)
+	{
+		uint64_t h = fnvOffset;
+		for (auto& bone : system.getBones()) {
+			hashBytes(h, bone->m_name.c_str(), bone->m_name.size());
+			const uint8_t dynamic = !bone->m_rig.isStaticOrKinematicObject();
+			hashBytes(h, &dynamic, sizeof(dynamic));
+		}
+
+		const auto stats = system.stats();
+		hashBytes(h, &stats.bodies, sizeof(stats.bodies));
+		hashBytes(h, &stats.constraints, sizeof(stats.constraints));
+		return h;
+	}
+
+	SystemSnapshot SystemSnapshot::capture(SkyrimSystem& system)
+	{
+		SystemSnapshot ret;
+		ret.topologyHash = hash(system);
+
+		const auto& world = system.m_skeleton->world;
+		const btQuaternion invRotation = convertNi(world.rotate).inverse();
+		const btVector3 origin = convertNi(world.translate);
+		const btScalar invScale = world.scale > FLT_EPSILON ? 1.0f / world.scale : 1.0f;
+
+		for (auto& bone : system.getBones()) {
+			auto& rig = bone->m_rig;
+			if (rig.isStaticOrKinematicObject())
+				continue;
+
+			auto& transform = rig.getWorldTransform();
+			ret.bones.push_back({
+				quatRotate(invRotation, transform.getOrigin() - origin) * invScale,
+				invRotation * transform.getRotation(),
+				quatRotate(invRotation, rig.getLinearVelocity()) * invScale,
+				quatRotate(invRotation, rig.getAngularVelocity()),
+			});
+		}
+		return ret;
+	}
+
+	void SystemSnapshot::restore(SkyrimSystem& system) const
+	{
+		const auto& world = system.m_skeleton->world;
+		const btQuaternion rotation = convertNi(world.rotate);
+		const btVector3 origin = convertNi(world.translate);
+		const btScalar scale = world.scale;
+
+		auto it = bones.begin();
+		for (auto& bone : system.getBones()) {
+			auto& rig = bone->m_rig;
+			if (rig.isStaticOrKinematicObject())
+				continue;
+			if (it == bones.end())
+				return;
+
+			const btTransform transform(rotation * it->rotation, origin + quatRotate(rotation, it->origin) * scale);
+			rig.setWorldTransform(transform);
+			rig.setInterpolationWorldTransform(transform);
+			rig.setLinearVelocity(quatRotate(rotation, it->linearVelocity) * scale);
+			rig.setAngularVelocity(quatRotate(rotation, it->angularVelocity));
+			rig.setInterpolationLinearVelocity(rig.getLinearVelocity());
+			rig.setInterpolationAngularVelocity(rig.getAngularVelocity());
+			rig.updateInertiaTensor();
+			++it;
+		}
+	}
+
+	SnapshotStore* SnapshotStore::GetSingleton()
+	{
+		static SnapshotStore g_store;
+		return &g_store;
+	}
+
+	uint32_t SnapshotStore::ownerFormID(SkyrimSystem& system)
+	{
+		for (RE::NiAVObject* node = system.m_skeleton.get(); node; node = node->parent) {
+			if (auto ref = node->GetUserData())
+				return ref->formID;
+		}
+		return 0;
+	}
+
+	void SnapshotStore::store(SkyrimSystem& system)
+	{
+		if (!m_enabled || !system.m_skeleton || system.m_physicsFile.empty())
+			return;
+
+		const auto formID = ownerFormID(system);
+		if (!formID)
+			return;
+
+		auto snapshot = std::make_shared<const SystemSnapshot>(SystemSnapshot::capture(system));
+		if (snapshot->bones.empty())
+			return;
+
+		std::lock_guard<decltype(m_lock)> l(m_lock);
+		if (m_loading)
+			return;
+
+		m_entries[{ formID, system.m_physicsFile }] = { std::move(snapshot), ++m_sequence };
+
+		// Forget the oldest ones, these actors are most likely far away by now.
+		while (m_entries.size() > m_maxEntries) {
+			auto oldest = std::min_element(m_entries.begin(), m_entries.end(), [](const auto& a, const auto& b) {
+				return a.second.sequence < b.second.sequence;
+			});
+			m_entries.erase(oldest);
+		}
+	}
+
+	std::shared_ptr<const SystemSnapshot> SnapshotStore::find(SkyrimSystem& system)
+	{
+		if (!m_enabled || !system.m_skeleton || system.m_physicsFile.empty())
+			return nullptr;
+
+		const auto formID = ownerFormID(system);
+		if (!formID)
+			return nullptr;
+
+		std::shared_ptr<const SystemSnapshot> snapshot;
+		{
+			std::lock_guard<decltype(m_lock)> l(m_lock);
+			auto it = m_entries.find({ formID, system.m_physicsFile });
+			if (it == m_entries.end())
+				return nullptr;
+			snapshot = it->second.snapshot;
+		}
+
+		if (snapshot->topologyHash != SystemSnapshot::hash(system)) {
+			logger::debug("Pose snapshot of {:08X} {} doesn't match its system anymore, ignored", formID, system.m_physicsFile);
+			return nullptr;
+		}
+		return snapshot;
+	}
+
+	void SnapshotStore::clear()
+	{
+		std::lock_guard<decltype(m_lock)> l(m_lock);
+		m_entries.clear();
+	}
+
+	void SnapshotStore::beginLoad()
+	{
+		std::lock_guard<decltype(m_lock)> l(m_lock);
+		m_entries.clear();
+		m_loading = true;
+	}
+
+	void SnapshotStore::endLoad()
+	{
+		std::lock_guard<decltype(m_lock)> l(m_lock);
+		m_loading = false;
+	}
+
+	std::stringstream SnapshotStore::Serialize()
+	{
+		std::stringstream data_stream;
+		std::lock_guard<decltype(m_lock)> l(m_lock);
+
+		write(data_stream, static_cast<uint32_t>(m_entries.size()));
+		for (const auto& [key, entry] : m_entries) {
+			write(data_stream, key.first);
+			write(data_stream, static_cast<uint32_t>(key.second.size()));
+			data_stream.write(key.second.data(), key.second.size());
+			write(data_stream, entry.snapshot->topologyHash);
+			write(data_stream, static_cast<uint32_t>(entry.snapshot->bones.size()));
+			for (auto& bone : entry.snapshot->bones) {
+				writeVector(data_stream, bone.origin);
+				write(data_stream, bone.rotation.x());
+				write(data_stream, bone.rotation.y());
+				write(data_stream, bone.rotation.z());
+				write(data_stream, bone.rotation.w());
+				writeVector(data_stream, bone.linearVelocity);
+				writeVector(data_stream, bone.angularVelocity);
+			}
+		}
+		return data_stream;
+	}
+
+	void SnapshotStore::Deserialize(std::stringstream& data_stream)
+	{
+		std::lock_guard<decltype(m_lock)> l(m_lock);
+		m_entries.clear();
+
+		// Sanity limits, a corrupted record mustn't make us allocate gigabytes.
+		constexpr uint32_t maxPathLength = 4096;
+		constexpr uint32_t maxBones = 4096;
+
+		uint32_t count;
+		if (!read(data_stream, count))
+			return;
+
+		for (uint32_t i = 0; i < count; ++i) {
+			uint32_t formID, pathLength, boneCount;
+			uint64_t topologyHash;
+			if (!read(data_stream, formID) || !read(data_stream, pathLength) || pathLength > maxPathLength)
+				break;
+
+			std::string path(pathLength, '\0');
+			if (!data_stream.read(path.data(), pathLength) || !read(data_stream, topologyHash) || !read(data_stream, boneCount) || boneCount > maxBones)
+				break;
+
+			auto snapshot = std::make_shared<SystemSnapshot>();
+			snapshot->topologyHash = topologyHash;
+			snapshot->bones.resize(boneCount);
+			for (auto& bone : snapshot->bones) {
+				float x, y, z, w;
+				if (!readVector(data_stream, bone.origin) || !read(data_stream, x) || !read(data_stream, y) || !read(data_stream, z) || !read(data_stream, w) ||
+					!readVector(data_stream, bone.linearVelocity) || !readVector(data_stream, bone.angularVelocity)) {
+					logger::warn("Truncated pose snapshots in the co-save, {} of {} read", m_entries.size(), count);
+					return;
+				}
+				bone.rotation.setValue(x, y, z, w);
+			}
+
+			m_entries[{ formID, std::move(path) }] = { std::move(snapshot), ++m_sequence };
+		}
+
+		if (m_entries.size() != count)
+			logger::warn("Invalid pose snapshots in the co-save, {} of {} read", m_entries.size(), count);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "hdtSerialization.h"
+#include "hdtSkyrimSystem.h"
+
+#include <map>
+
+namespace hdt
+{
+	// The dynamic bones of a system, relative to its skeleton, so that a recreated system starts from where it was
+	// instead of dropping from the rest pose.
+	// The constraints don't need to be stored: the solver isn't warm started, they have no state between steps.
+	struct SystemSnapshot
+	{
+		struct Bone
+		{
+			btVector3 origin;  // skeleton space, unscaled
+			btQuaternion rotation;
+			btVector3 linearVelocity;
+			btVector3 angularVelocity;
+		};
+
+		uint64_t topologyHash = 0;
+		std::vector<Bone> bones;  // the dynamic bones, in the order of the system
+
+		// Bones, dynamic flags and constraints; a snapshot is only restored on a system with the same hash.
+		static uint64_t hash(SkyrimSystem& system);
+
+		static SystemSnapshot capture(SkyrimSystem& system);
+		void restore(SkyrimSystem& system) const;
+	};
+
+	// Snapshots keyed by actor and physics file. They are taken when a system leaves the world, so that they last
+	// across cell transitions, and when saving, so that they are persisted in the co-save.
+	class SnapshotStore : public Serializer<void>
+	{
+	public:
+		static SnapshotStore* GetSingleton();
+
+		uint32_t FormatVersion() override { return 1; };
+		uint32_t StorageName() override { return 'SMPP'; };
+
+		std::stringstream Serialize() override;
+		void Deserialize(std::stringstream&) override;
+
+		void store(SkyrimSystem& system);
+		// Returns the snapshot of the system if there is one with the same topology.
+		std::shared_ptr<const SystemSnapshot> find(SkyrimSystem& system);
+		void clear();
+
+		// Between these calls, the systems of the previous game are torn down; their poses must not leak into the loaded one.
+		void beginLoad();
+		void endLoad();
+
+		bool m_enabled = true;
+		size_t m_maxEntries = 512;
+
+	private:
+		SnapshotStore() = default;
+
+		struct Entry
+		{
+			std::shared_ptr<const SystemSnapshot> snapshot;
+			uint64_t sequence;
+		};
+
+		static uint32_t ownerFormID(SkyrimSystem& system);
+
+		std::mutex m_lock;
+		std::map<std::pair<uint32_t, std::string>, Entry> m_entries;
+		uint64_t m_sequence = 0;
+		bool m_loading = false;
+	};
+}
@@ -8,6 +8,7 @@
 #include "dhdtOverrideManager.h"
 #include "dhdtPapyrusFunctions.h"
 #include "hdtSkyrimPhysicsWorld.h"
+#include "hdtSystemSnapshot.h"
 
 #include <atomic>
 #include <charconv>
@@ -336,12 +337,23 @@ bool SMPDebug_Execute(
 		console->Print("    Enable SMP simulation.");
 		console->Print("  smp off");
 		console->Print("    Disable SMP simulation.");
+		console->Print("  smp wind [strength] [radius]");
+		console->Print("    Add a 10s radial gust around the targeted reference (or the player); defaults are 300/512.");
+		console->Print("  smp wind clear");
+		console->Print("    Remove all local wind emitters.");
 		console->Print("  smp QueryOverride");
 		console->Print("    Print current dynamic override data.");
 		console->Print("  smp report [gear] [error]");
 		console->Print("    Run the physics-asset validator in the background and write a report file.");
 		console->Print("    gear  = validate equipped gear only.");
 		console->Print("    error = write an errors-only report (no warnings/info).");
+		console->Print("  smp optimize xml");
+		console->Print("    Rewrite every physics XML without redundant tags and templates, in the background.");
+		console->Print("    The copies go to a new folder next to the reports; the originals are not modified.");
+		console->Print("  smp fix nif [plan]");
+		console->Print("    Repair the broken skin meshes of every physics NIF, in the background.");
+		console->Print("    The repaired copies go to a new folder next to the reports; the originals are not modified.");
+		console->Print("    plan = only list the repairs, write no NIF.");
 		return true;
 	}
 
@@ -353,6 +365,7 @@ bool SMPDebug_Execute(
 
 		const RE::MenuOpenCloseEvent e{ "", false };
 		hdt::ActorManager::instance()->ProcessEvent(&e, nullptr);
+		hdt::SnapshotStore::GetSingleton()->clear();
 		hdt::SkyrimPhysicsWorld::get()->resetSystems();
 		return true;
 	}
@@ -417,6 +430,38 @@ bool SMPDebug_Execute(
 		return true;
 	}
 
+	if (_strnicmp(buffer, "wind", MAX_PATH) == 0) {
+		auto& windField = hdt::SkyrimPhysicsWorld::get()->getWindField();
+
+		if (_stricmp(buffer2, "clear") == 0) {
+			windField.clearEmitters();
+			RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] local wind emitters cleared");
+			return true;
+		}
+
+		RE::TESObjectREFR* target = a_thisObj ? a_thisObj : RE::PlayerCharacter::GetSingleton();
+		if (!target) {
+			RE::ConsoleLog::GetSingleton()->Print("error: no reference to blow the wind from");
+			return true;
+		}
+
+		hdt::WindEmitter emitter;
+		emitter.m_position = hdt::convertNi(target->GetPosition());
+		emitter.m_strength = static_cast<float>(ParsePositiveDecimal(buffer2, 300));
+		emitter.m_radius = static_cast<float>(ParsePositiveDecimal(buffer3, 512));
+		emitter.m_turbulence = 0.3f;
+		emitter.m_lifetime = 10.0f;
+		const auto id = windField.addEmitter(emitter);
+
+		RE::ConsoleLog::GetSingleton()->Print(
+			"[HDT-SMP] wind emitter %u added: strength %.0f, radius %.0f, %zu emitter(s) active",
+			id,
+			emitter.m_strength,
+			emitter.m_radius,
+			windField.emitterCount());
+		return true;
+	}
+
 	if (_strnicmp(buffer, "QueryOverride", MAX_PATH) == 0) {
 		RE::ConsoleLog::GetSingleton()->Print(hdt::Override::OverrideManager::GetSingleton()->queryOverrideData().c_str());
 		return true;
@@ -504,6 +549,83 @@ bool SMPDebug_Execute(
 		return true;
 	}
 
+	if (_strnicmp(buffer, "optimize", MAX_PATH) == 0) {
+		static std::atomic<bool> s_optimizationRunning{ false };
+
+		if (_stricmp(buffer2, "xml") != 0 || buffer3[0] != '\0') {
+			RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] Usage: smp optimize xml");
+			return true;
+		}
+		if (s_optimizationRunning.exchange(true)) {
+			RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] XML optimization is already running.");
+			return true;
+		}
+		RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] XML optimization started in background. Results will appear when complete.");
+		std::thread([]() {
+			try {
+				std::string outputDir;
+				auto result = hdt::OptimizePhysicsXmls(outputDir);
+				auto* console = RE::ConsoleLog::GetSingleton();
+				if (outputDir.empty()) {
+					console->Print("[HDT-SMP] Warning: the output folder could not be created");
+				} else {
+					console->Print(
+						"[HDT-SMP] XML optimization complete in %.2fs: %d XML(s) found, %d optimized (%zu -> %zu bytes), %d failed",
+						result.elapsedSeconds,
+						result.xmlsFound, result.xmlsOptimized, result.bytesBefore, result.bytesAfter, result.xmlsFailed);
+					console->Print("[HDT-SMP] Optimized XMLs written to: %s", outputDir.c_str());
+				}
+			} catch (const std::exception& e) {
+				RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] XML optimization failed with error: %s", e.what());
+				logger::error("[Validator] smp optimize xml threw: {}", e.what());
+			} catch (...) {
+				RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] XML optimization failed with an unknown error");
+				logger::error("[Validator] smp optimize xml threw an unknown exception");
+			}
+			s_optimizationRunning.store(false);
+		}).detach();
+		return true;
+	}
+
+	if (_strnicmp(buffer, "fix", MAX_PATH) == 0) {
+		static std::atomic<bool> s_repairRunning{ false };
+
+		const bool dryRun = _stricmp(buffer3, "plan") == 0;
+		if (_stricmp(buffer2, "nif") != 0 || (buffer3[0] != '\0' && !dryRun)) {
+			RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] Usage: smp fix nif [plan]");
+			return true;
+		}
+		if (s_repairRunning.exchange(true)) {
+			RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] NIF repair is already running.");
+			return true;
+		}
+		RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] NIF repair started in background. Results will appear when complete.");
+		std::thread([dryRun]() {
+			try {
+				std::string outputDir;
+				auto result = hdt::RepairSkinMeshNifs(outputDir, dryRun);
+				auto* console = RE::ConsoleLog::GetSingleton();
+				if (outputDir.empty()) {
+					console->Print("[HDT-SMP] Warning: the output folder could not be created");
+				} else {
+					console->Print(
+						"[HDT-SMP] NIF repair complete in %.2fs: %d NIF(s) checked, %d %s, %d unrepairable, %d failed",
+						result.elapsedSeconds, result.nifsChecked, result.nifsRepaired,
+						dryRun ? "to repair" : "repaired", result.nifsUnrepairable, result.nifsFailed);
+					console->Print("[HDT-SMP] %s written to: %s", dryRun ? "Repair plan" : "Repaired NIFs", outputDir.c_str());
+				}
+			} catch (const std::exception& e) {
+				RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] NIF repair failed with error: %s", e.what());
+				logger::error("[Validator] smp fix nif threw: {}", e.what());
+			} catch (...) {
+				RE::ConsoleLog::GetSingleton()->Print("[HDT-SMP] NIF repair failed with an unknown error");
+				logger::error("[Validator] smp fix nif threw an unknown exception");
+			}
+			s_repairRunning.store(false);
+		}).detach();
+		return true;
+	}
+
 	auto skeletons = hdt::ActorManager::instance()->getSkeletons();
 
 	size_t activeSkeletons = 0;
@@ -575,6 +697,23 @@ namespace
 	}
 }
 
+// Every registered serializer gets its record in the co-save; the poses of the loaded systems are stored first.
+void SaveCallback(SKSE::SerializationInterface* a_intfc)
+{
+	hdt::SkyrimPhysicsWorld::get()->storeSnapshots();
+	hdt::SerializerBase::Save(a_intfc);
+}
+
+void LoadCallback(SKSE::SerializationInterface* a_intfc)
+{
+	hdt::SerializerBase::Load(a_intfc);
+}
+
+void RevertCallback(SKSE::SerializationInterface*)
+{
+	hdt::SnapshotStore::GetSingleton()->clear();
+}
+
 void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
 {
 	switch (a_msg->type) {
@@ -595,6 +734,8 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
 		break;
 	case SKSE::MessagingInterface::kPreLoadGame:
 		{
+			hdt::SnapshotStore::GetSingleton()->beginLoad();
+
 			std::string save_name = reinterpret_cast<char*>(a_msg->data);
 			save_name = save_name.substr(0, save_name.find_last_of("."));
 
@@ -606,6 +747,10 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
 			}
 		}
 		break;
+	case SKSE::MessagingInterface::kPostLoadGame:
+	case SKSE::MessagingInterface::kNewGame:
+		hdt::SnapshotStore::GetSingleton()->endLoad();
+		break;
 	case SKSE::MessagingInterface::kPostPostLoad:
 		{
 			Hooks::InstallHighPriority();
@@ -681,6 +826,12 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* a_s
 		return false;
 	}
 
+	const auto serialization = SKSE::GetSerializationInterface();
+	serialization->SetUniqueID('HSMP');
+	serialization->SetSaveCallback(SaveCallback);
+	serialization->SetLoadCallback(LoadCallback);
+	serialization->SetRevertCallback(RevertCallback);
+
 	//
 	Events::Sources::FrameEventSource::GetSingleton()->AddEventSink(hdt::ActorManager::instance());
 	Events::Sources::FrameEventSource::GetSingleton()->AddEventSink(hdt::SkyrimPhysicsWorld::get());
@@ -727,7 +878,7 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* a_s
 
 		unusedCommand->functionName = "SMPDebug";
 		unusedCommand->shortName = "smp";
-		unusedCommand->helpString = "smp <help|reset|report [gear] [error]>";
+		unusedCommand->helpString = "smp <help|reset|wind [strength] [radius]|report [gear] [error]|optimize xml|fix nif [plan]>";
 		unusedCommand->referenceFunction = 0;
 		unusedCommand->numParams = 3;
 		unusedCommand->params = params;